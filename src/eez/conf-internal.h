@@ -78,6 +78,14 @@
     #define EEZ_FOR_LVGL_LZ4_OPTION 1
 #endif
 
+#ifndef EEZ_OPTION_MAPPED_ASSETS
+    #if defined(__linux__) && !defined(__EMSCRIPTEN__)
+        #define EEZ_OPTION_MAPPED_ASSETS 1
+    #else
+        #define EEZ_OPTION_MAPPED_ASSETS 0
+    #endif
+#endif
+
 #ifndef EEZ_FOR_LVGL_SHA256_OPTION
     #define EEZ_FOR_LVGL_SHA256_OPTION 1
 #endif
@@ -19,12 +19,33 @@
 #include <eez/core/memory.h>
 #include <eez/core/debug.h>
 #include <eez/core/assets.h>
+#include <eez/core/util.h>
 #include <eez/flow/flow.h>
 
 #if EEZ_FOR_LVGL_LZ4_OPTION
 #include <eez/libs/lz4/lz4.h>
 #endif
 
+#if !defined(EEZ_ASSETS_PARALLEL_DECOMPRESSION)
+#if defined(EEZ_PLATFORM_SIMULATOR) && !defined(__EMSCRIPTEN__)
+#define EEZ_ASSETS_PARALLEL_DECOMPRESSION 1
+#else
+#define EEZ_ASSETS_PARALLEL_DECOMPRESSION 0
+#endif
+#endif
+
+#if EEZ_ASSETS_PARALLEL_DECOMPRESSION
+#include <atomic>
+#include <thread>
+#endif
+
+#if EEZ_OPTION_MAPPED_ASSETS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #if EEZ_OPTION_GUI
 #include <eez/gui/gui.h>
 #include <eez/gui/widget.h>
@@ -47,6 +68,114 @@ bool g_mainAssetsAreMutable;
 
 void fixOffsets(Assets *assets);
 
+#if EEZ_FOR_LVGL_LZ4_OPTION
+
+static bool decompressChunk(const uint8_t *assetsData, uint32_t assetsDataSize, const CompressedChunk *chunk, uint8_t *dst) {
+    if (chunk->compressedOffset > assetsDataSize || chunk->compressedSize > assetsDataSize - chunk->compressedOffset) {
+        return false;
+    }
+
+    int decompressResult = LZ4_decompress_safe(
+		(const char *)(assetsData + chunk->compressedOffset),
+		(char *)dst + chunk->decompressedOffset,
+		chunk->compressedSize,
+		chunk->decompressedSize
+	);
+
+    if (decompressResult != (int)chunk->decompressedSize) {
+        return false;
+    }
+
+    return crc32(dst + chunk->decompressedOffset, chunk->decompressedSize) == chunk->crc32;
+}
+
+#if EEZ_ASSETS_PARALLEL_DECOMPRESSION
+
+#if !defined(EEZ_ASSETS_DECOMPRESSION_MAX_THREADS)
+#define EEZ_ASSETS_DECOMPRESSION_MAX_THREADS 8
+#endif
+
+static bool decompressChunks(const uint8_t *assetsData, uint32_t assetsDataSize, const CompressedChunk *chunks, uint32_t chunksCount, uint8_t *dst) {
+    std::atomic<uint32_t> nextChunkIndex(0);
+    std::atomic<bool> failed(false);
+
+    auto worker = [&]() {
+        while (!failed) {
+            auto chunkIndex = nextChunkIndex++;
+            if (chunkIndex >= chunksCount) {
+                break;
+            }
+            if (!decompressChunk(assetsData, assetsDataSize, chunks + chunkIndex, dst)) {
+                failed = true;
+            }
+        }
+    };
+
+    uint32_t numThreads = std::thread::hardware_concurrency();
+    if (numThreads > EEZ_ASSETS_DECOMPRESSION_MAX_THREADS) {
+        numThreads = EEZ_ASSETS_DECOMPRESSION_MAX_THREADS;
+    }
+    if (numThreads > chunksCount) {
+        numThreads = chunksCount;
+    }
+
+    // current thread is also a worker
+    std::thread threads[EEZ_ASSETS_DECOMPRESSION_MAX_THREADS];
+    for (uint32_t i = 1; i < numThreads; i++) {
+        threads[i] = std::thread(worker);
+    }
+
+    worker();
+
+    for (uint32_t i = 1; i < numThreads; i++) {
+        threads[i].join();
+    }
+
+    return !failed;
+}
+
+#else
+
+static bool decompressChunks(const uint8_t *assetsData, uint32_t assetsDataSize, const CompressedChunk *chunks, uint32_t chunksCount, uint8_t *dst) {
+    for (uint32_t chunkIndex = 0; chunkIndex < chunksCount; chunkIndex++) {
+        if (!decompressChunk(assetsData, assetsDataSize, chunks + chunkIndex, dst)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#endif // EEZ_ASSETS_PARALLEL_DECOMPRESSION
+
+static bool decompressChunkedAssetsData(const uint8_t *assetsData, uint32_t assetsDataSize, uint8_t *dst, uint32_t decompressedSize) {
+    if (assetsDataSize < sizeof(Header) + sizeof(ChunkedHeader)) {
+        return false;
+    }
+
+    auto chunkedHeader = (const ChunkedHeader *)(assetsData + sizeof(Header));
+    auto chunks = (const CompressedChunk *)(chunkedHeader + 1);
+
+    if (chunkedHeader->chunksCount > (assetsDataSize - sizeof(Header) - sizeof(ChunkedHeader)) / sizeof(CompressedChunk)) {
+        return false;
+    }
+
+    // chunks must cover whole decompressed data
+    uint32_t decompressedOffset = 0;
+    for (uint32_t chunkIndex = 0; chunkIndex < chunkedHeader->chunksCount; chunkIndex++) {
+        if (chunks[chunkIndex].decompressedOffset != decompressedOffset || chunks[chunkIndex].decompressedSize > decompressedSize - decompressedOffset) {
+            return false;
+        }
+        decompressedOffset += chunks[chunkIndex].decompressedSize;
+    }
+    if (decompressedOffset != decompressedSize) {
+        return false;
+    }
+
+    return decompressChunks(assetsData, assetsDataSize, chunks, chunkedHeader->chunksCount, dst);
+}
+
+#endif // EEZ_FOR_LVGL_LZ4_OPTION
+
 bool decompressAssetsData(const uint8_t *assetsData, uint32_t assetsDataSize, Assets *decompressedAssets, uint32_t maxDecompressedAssetsSize, int *err) {
 #if EEZ_FOR_LVGL_LZ4_OPTION
 	uint32_t compressedDataOffset;
@@ -54,7 +183,7 @@ bool decompressAssetsData(const uint8_t *assetsData, uint32_t assetsDataSize, As
 
 	auto header = (Header *)assetsData;
 
-	if (header->tag == HEADER_TAG_COMPRESSED) {
+	if (header->tag == HEADER_TAG_COMPRESSED || header->tag == HEADER_TAG_COMPRESSED_CHUNKED) {
 		decompressedAssets->projectMajorVersion = header->projectMajorVersion;
 		decompressedAssets->projectMinorVersion = header->projectMinorVersion;
         decompressedAssets->assetsType = header->assetsType;
@@ -89,6 +218,16 @@ bool decompressAssetsData(const uint8_t *assetsData, uint32_t assetsDataSize, As
 		return false;
 	}
 
+    if (header->tag == HEADER_TAG_COMPRESSED_CHUNKED) {
+        if (!decompressChunkedAssetsData(assetsData, assetsDataSize, (uint8_t *)decompressedAssets + decompressedDataOffset, decompressedSize)) {
+            if (err) {
+                *err = SCPI_ERROR_INVALID_BLOCK_DATA;
+            }
+            return false;
+        }
+        return true;
+    }
+
 	int compressedSize = assetsDataSize - compressedDataOffset;
 
     int decompressResult = LZ4_decompress_safe(
@@ -132,7 +271,7 @@ static void allocMemoryForDecompressedAssets(const uint8_t *assetsData, uint32_t
 #endif
 
     auto header = (Header *)assetsData;
-    assert (header->tag == HEADER_TAG_COMPRESSED);
+    assert (header->tag == HEADER_TAG_COMPRESSED || header->tag == HEADER_TAG_COMPRESSED_CHUNKED);
     uint32_t decompressedSize = header->decompressedSize;
 
     decompressedAssetsMemoryBufferSize = decompressedDataOffset + decompressedSize;
@@ -141,7 +280,251 @@ static void allocMemoryForDecompressedAssets(const uint8_t *assetsData, uint32_t
 }
 #endif
 
+static bool isInsideMappedAssets(uint32_t offset, uint32_t size, uint32_t assetsSize) {
+    return offset <= assetsSize && size <= assetsSize - offset;
+}
+
+#if EEZ_OPTION_GUI
+
+#if !defined(EEZ_MAPPED_ASSETS_CACHE_SIZE)
+#define EEZ_MAPPED_ASSETS_CACHE_SIZE (4 * 1024 * 1024)
+#endif
+static const uint32_t MAPPED_ASSETS_CACHE_SIZE = EEZ_MAPPED_ASSETS_CACHE_SIZE;
+
+struct MappedAssetsSectionState {
+    void *data;
+    uint32_t lastUsed;
+};
+
+static const uint8_t *g_mappedAssetsData;
+static const MappedAssetsSection *g_mappedAssetsSections;
+static uint32_t g_mappedAssetsSectionsCount;
+static MappedAssetsSectionState *g_mappedAssetsSectionStates;
+static uint32_t g_mappedAssetsCacheSize;
+static uint32_t g_mappedAssetsUseCounter;
+// value of g_mappedAssetsUseCounter at the last evictMappedAssetsSections, i.e. at the end of the last frame
+static uint32_t g_mappedAssetsFrameStartUseCounter;
+
+static void freeMappedAssetsSections() {
+    if (g_mappedAssetsSectionStates) {
+        for (uint32_t i = 0; i < g_mappedAssetsSectionsCount; i++) {
+            if (g_mappedAssetsSectionStates[i].data) {
+                eez::free(g_mappedAssetsSectionStates[i].data);
+            }
+        }
+        eez::free(g_mappedAssetsSectionStates);
+        g_mappedAssetsSectionStates = nullptr;
+        resetMultilineTextLayoutCache();
+    }
+
+    g_mappedAssetsData = nullptr;
+    g_mappedAssetsSections = nullptr;
+    g_mappedAssetsSectionsCount = 0;
+    g_mappedAssetsCacheSize = 0;
+}
+
+// Everything read from the container is checked here, once, so a truncated or
+// corrupted file can't make us read outside of it later.
+static bool setMappedAssets(const uint8_t *assets, uint32_t assetsSize) {
+    freeMappedAssetsSections();
+
+    if (assetsSize < sizeof(MappedAssetsHeader)) {
+        return false;
+    }
+
+    auto mappedAssetsHeader = (const MappedAssetsHeader *)assets;
+
+    if (
+        mappedAssetsHeader->assetsOffset < sizeof(MappedAssetsHeader) ||
+        !isInsideMappedAssets(mappedAssetsHeader->assetsOffset, sizeof(Assets), assetsSize)
+    ) {
+        return false;
+    }
+
+    if (
+        mappedAssetsHeader->sectionsCount > (assetsSize - sizeof(MappedAssetsHeader)) / sizeof(MappedAssetsSection) ||
+        !isInsideMappedAssets(mappedAssetsHeader->sectionsOffset, mappedAssetsHeader->sectionsCount * sizeof(MappedAssetsSection), assetsSize)
+    ) {
+        return false;
+    }
+
+    auto sections = (const MappedAssetsSection *)(assets + mappedAssetsHeader->sectionsOffset);
+
+    for (uint32_t i = 0; i < mappedAssetsHeader->sectionsCount; i++) {
+        auto section = sections + i;
+
+        if (section->type != MAPPED_ASSETS_SECTION_TYPE_BITMAP && section->type != MAPPED_ASSETS_SECTION_TYPE_FONT) {
+            return false;
+        }
+
+        // findMappedAssetsSection is a binary search
+        if (i > 0 && ((section - 1)->type << 16 | (section - 1)->index) >= (section->type << 16 | section->index)) {
+            return false;
+        }
+
+        if (!isInsideMappedAssets(section->dataOffset, section->compressedSize, assetsSize)) {
+            return false;
+        }
+
+        if (section->decompressedSize == 0 || section->decompressedSize > MAPPED_ASSETS_CACHE_SIZE) {
+            return false;
+        }
+
+        // name must be zero terminated inside the file
+        if (section->nameOffset && (section->nameOffset >= assetsSize || !memchr(assets + section->nameOffset, 0, assetsSize - section->nameOffset))) {
+            return false;
+        }
+    }
+
+    g_mappedAssetsData = assets;
+    g_mappedAssetsSections = sections;
+    g_mappedAssetsSectionsCount = mappedAssetsHeader->sectionsCount;
+
+    return true;
+}
+
+static const MappedAssetsSection *findMappedAssetsSection(uint8_t type, uint32_t index) {
+    uint32_t key = (type << 16) | index;
+
+    int low = 0;
+    int high = (int)g_mappedAssetsSectionsCount - 1;
+    while (low <= high) {
+        int mid = (low + high) / 2;
+        auto section = g_mappedAssetsSections + mid;
+        uint32_t sectionKey = (section->type << 16) | section->index;
+        if (sectionKey == key) {
+            return section;
+        }
+        if (sectionKey < key) {
+            low = mid + 1;
+        } else {
+            high = mid - 1;
+        }
+    }
+
+    return nullptr;
+}
+
+static void evictMappedAssetsSection(uint32_t sectionIndex, bool &fontEvicted) {
+    auto state = g_mappedAssetsSectionStates + sectionIndex;
+    eez::free(state->data);
+    state->data = nullptr;
+    g_mappedAssetsCacheSize -= g_mappedAssetsSections[sectionIndex].decompressedSize;
+
+    if (g_mappedAssetsSections[sectionIndex].type == MAPPED_ASSETS_SECTION_TYPE_FONT) {
+        fontEvicted = true;
+    }
+}
+
+void evictMappedAssetsSections() {
+    bool fontEvicted = false;
+
+    while (g_mappedAssetsCacheSize > MAPPED_ASSETS_CACHE_SIZE) {
+        // find least recently used section
+        int lruSectionIndex = -1;
+        for (uint32_t i = 0; i < g_mappedAssetsSectionsCount; i++) {
+            auto state = g_mappedAssetsSectionStates + i;
+            if (state->data) {
+                if (lruSectionIndex == -1 || state->lastUsed < g_mappedAssetsSectionStates[lruSectionIndex].lastUsed) {
+                    lruSectionIndex = i;
+                }
+            }
+        }
+
+        if (lruSectionIndex == -1) {
+            break;
+        }
+
+        evictMappedAssetsSection(lruSectionIndex, fontEvicted);
+    }
+
+    if (fontEvicted) {
+        // layout cache is keyed by FontData pointer which can be reused by the next allocation
+        resetMultilineTextLayoutCache();
+    }
+
+    g_mappedAssetsFrameStartUseCounter = g_mappedAssetsUseCounter;
+}
+
+// Used when out of memory while loading section. Only the sections not used in
+// the current frame can be freed, because their pointers are not held by anyone.
+static bool evictMappedAssetsSectionsNotUsedInFrame() {
+    bool evicted = false;
+    bool fontEvicted = false;
+
+    for (uint32_t i = 0; i < g_mappedAssetsSectionsCount; i++) {
+        auto state = g_mappedAssetsSectionStates + i;
+        if (state->data && (int32_t)(state->lastUsed - g_mappedAssetsFrameStartUseCounter) <= 0) {
+            evictMappedAssetsSection(i, fontEvicted);
+            evicted = true;
+        }
+    }
+
+    if (fontEvicted) {
+        resetMultilineTextLayoutCache();
+    }
+
+    return evicted;
+}
+
+static void *loadMappedAssetsSection(const MappedAssetsSection *section) {
+#if EEZ_FOR_LVGL_LZ4_OPTION
+    if (!g_mappedAssetsSectionStates) {
+        // allocated on the first use, because memory allocator is not ready when assets are loaded
+        auto size = g_mappedAssetsSectionsCount * sizeof(MappedAssetsSectionState);
+        g_mappedAssetsSectionStates = (MappedAssetsSectionState *)eez::alloc(size, 0x2d61c4e8);
+        if (!g_mappedAssetsSectionStates) {
+            return nullptr;
+        }
+        memset(g_mappedAssetsSectionStates, 0, size);
+    }
+
+    auto state = g_mappedAssetsSectionStates + (section - g_mappedAssetsSections);
+    state->lastUsed = ++g_mappedAssetsUseCounter;
+
+    if (!state->data) {
+        // Nothing is evicted here, because pointers returned earlier in this frame
+        // are still in use. Cache can grow over its size until evictMappedAssetsSections.
+        auto data = eez::alloc(section->decompressedSize, 0x9b3e07a1);
+        if (!data && evictMappedAssetsSectionsNotUsedInFrame()) {
+            data = eez::alloc(section->decompressedSize, 0x9b3e07a1);
+        }
+        if (!data) {
+            // getFontData and getBitmap return nullptr, callers must skip drawing
+            return nullptr;
+        }
+
+        int decompressResult = LZ4_decompress_safe(
+            (const char *)(g_mappedAssetsData + section->dataOffset),
+            (char *)data,
+            section->compressedSize,
+            section->decompressedSize
+        );
+
+        if (decompressResult != (int)section->decompressedSize) {
+            eez::free(data);
+            return nullptr;
+        }
+
+        state->data = data;
+        g_mappedAssetsCacheSize += section->decompressedSize;
+    }
+
+    return state->data;
+#else
+    EEZ_UNUSED(section);
+    return nullptr;
+#endif
+}
+
+#endif // EEZ_OPTION_GUI
+
 void loadMainAssets(const uint8_t *assets, uint32_t assetsSize) {
+#if EEZ_OPTION_GUI
+    resetTimelineCache();
+    freeMappedAssetsSections();
+#endif
+
     auto header = (Header *)assets;
     if (header->tag == HEADER_TAG) {
 		// assets are stored inside ROM as uncompressed data,
@@ -149,6 +532,21 @@ void loadMainAssets(const uint8_t *assets, uint32_t assetsSize) {
 		// Also, see initGlobalVariables.
         g_mainAssets = (Assets *)(assets + sizeof(uint32_t)/* skip HEADER_TAG*/);
 		g_mainAssetsAreMutable = false;
+    } else if (header->tag == HEADER_TAG_MAPPED) {
+        // same as above, but bitmaps and fonts can be stored in the compressed sections
+#if EEZ_OPTION_GUI
+        if (!setMappedAssets(assets, assetsSize)) {
+            g_mainAssets = nullptr;
+            return;
+        }
+#else
+        if (assetsSize < sizeof(MappedAssetsHeader) || !isInsideMappedAssets(((const MappedAssetsHeader *)assets)->assetsOffset, sizeof(Assets), assetsSize)) {
+            g_mainAssets = nullptr;
+            return;
+        }
+#endif
+        g_mainAssets = (Assets *)(assets + ((const MappedAssetsHeader *)assets)->assetsOffset);
+		g_mainAssetsAreMutable = false;
     } else {
 #if defined(EEZ_FOR_LVGL) || defined(EEZ_DASHBOARD_API)
         uint8_t *DECOMPRESSED_ASSETS_START_ADDRESS = 0;
@@ -163,6 +561,41 @@ void loadMainAssets(const uint8_t *assets, uint32_t assetsSize) {
     }
 }
 
+#if EEZ_OPTION_MAPPED_ASSETS
+
+bool loadMainAssetsFromFile(const char *filePath) {
+    int fd = ::open(filePath, O_RDONLY);
+    if (fd == -1) {
+        return false;
+    }
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size < (off_t)sizeof(Header) || (uint64_t)fileStat.st_size > UINT32_MAX) {
+        ::close(fd);
+        return false;
+    }
+
+    auto size = (size_t)fileStat.st_size;
+    void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+
+    auto tag = ((const Header *)data)->tag;
+
+    loadMainAssets((const uint8_t *)data, (uint32_t)size);
+
+    if (!g_mainAssets || (tag != HEADER_TAG && tag != HEADER_TAG_MAPPED)) {
+        // assets are decompressed into RAM (or rejected), mapping is not needed anymore
+        munmap(data, size);
+    }
+
+    return g_mainAssets != nullptr;
+}
+
+#endif // EEZ_OPTION_MAPPED_ASSETS
+
 ////////////////////////////////////////////////////////////////////////////////
 
 #if EEZ_OPTION_GUI
@@ -213,6 +646,12 @@ const gui::Style *getStyle(int styleID) {
 
 const gui::FontData *getFontData(int fontID) {
 	if (fontID > 0) {
+        if (g_mappedAssetsSectionsCount > 0) {
+            auto section = findMappedAssetsSection(MAPPED_ASSETS_SECTION_TYPE_FONT, fontID - 1);
+            if (section) {
+                return (const gui::FontData *)loadMappedAssetsSection(section);
+            }
+        }
 		return g_mainAssets->fonts[fontID - 1];
 	} else if (fontID < 0) {
 		auto assets = g_widgetCursor.assets;
@@ -228,6 +667,12 @@ const gui::FontData *getFontData(int fontID) {
 
 const gui::Bitmap *getBitmap(int bitmapID) {
 	if (bitmapID > 0) {
+        if (g_mappedAssetsSectionsCount > 0) {
+            auto section = findMappedAssetsSection(MAPPED_ASSETS_SECTION_TYPE_BITMAP, bitmapID - 1);
+            if (section) {
+                return (const gui::Bitmap *)loadMappedAssetsSection(section);
+            }
+        }
 		return g_mainAssets->bitmaps[bitmapID - 1];
 	} else if (bitmapID < 0) {
 		auto assets = g_widgetCursor.assets;
@@ -242,7 +687,18 @@ const gui::Bitmap *getBitmap(int bitmapID) {
 
 const int getBitmapIdByName(const char *bitmapName) {
     for (uint32_t i = 0; i < g_mainAssets->bitmaps.count; i++) {
-		if (strcmp(g_mainAssets->bitmaps[i]->name, bitmapName) == 0) {
+        const char *name = nullptr;
+        if (g_mappedAssetsSectionsCount > 0) {
+            // don't decompress bitmap just to get its name
+            auto section = findMappedAssetsSection(MAPPED_ASSETS_SECTION_TYPE_BITMAP, i);
+            if (section) {
+                name = section->nameOffset ? (const char *)(g_mappedAssetsData + section->nameOffset) : "";
+            }
+        }
+        if (!name) {
+            name = g_mainAssets->bitmaps[i]->name;
+        }
+		if (strcmp(name, bitmapName) == 0) {
             return i + 1;
         }
 	}
@@ -19,6 +19,8 @@ namespace eez {
 
 static const uint32_t HEADER_TAG = 0x5A45457E; // "~EEZ"
 static const uint32_t HEADER_TAG_COMPRESSED = 0x7A65657E; // "~eez"
+static const uint32_t HEADER_TAG_MAPPED = 0x4D5A457E; // "~EZM"
+static const uint32_t HEADER_TAG_COMPRESSED_CHUNKED = 0x637A657E; // "~ezc"
 
 static const uint8_t PROJECT_VERSION_V2 = 2;
 static const uint8_t PROJECT_VERSION_V3 = 3;
@@ -30,7 +32,7 @@ static const uint8_t ASSETS_TYPE_APPLET = 4;
 static const uint8_t ASSETS_TYPE_DASHBOARD = 5;
 
 struct Header {
-	uint32_t tag; // HEADER_TAG or HEADER_TAG_COMPRESSED
+	uint32_t tag; // HEADER_TAG or HEADER_TAG_COMPRESSED or HEADER_TAG_COMPRESSED_CHUNKED
 	uint8_t projectMajorVersion;
 	uint8_t projectMinorVersion;
 	uint8_t assetsType;
@@ -38,6 +40,44 @@ struct Header {
 	uint32_t decompressedSize;
 };
 
+// Compressed assets split into the independently compressed LZ4 chunks, so they can be
+// decompressed in parallel. Header is followed by the ChunkedHeader and the table of chunks.
+struct ChunkedHeader {
+	uint32_t chunksCount;
+};
+
+struct CompressedChunk {
+	uint32_t compressedOffset; // from the start of assets data
+	uint32_t compressedSize;
+	uint32_t decompressedOffset; // chunks must be contiguous, i.e. sorted by decompressedOffset without gaps
+	uint32_t decompressedSize;
+	uint32_t crc32; // of the decompressed data
+};
+
+// Uncompressed assets container which can be used in place, for example memory mapped from the file.
+// Bitmaps and fonts can be stored in the separate LZ4 compressed sections which are decompressed
+// on the first use. Section data is self contained, i.e. all AssetsPtr offsets inside the
+// decompressed Bitmap or FontData are pointing inside the section.
+struct MappedAssetsHeader {
+	uint32_t tag; // HEADER_TAG_MAPPED
+	uint32_t assetsOffset; // offset of the Assets structure
+	uint32_t sectionsCount;
+	uint32_t sectionsOffset; // offset of the MappedAssetsSection table, sorted by type and index
+};
+
+static const uint8_t MAPPED_ASSETS_SECTION_TYPE_BITMAP = 1;
+static const uint8_t MAPPED_ASSETS_SECTION_TYPE_FONT = 2;
+
+struct MappedAssetsSection {
+	uint8_t type; // MAPPED_ASSETS_SECTION_TYPE_...
+	uint8_t reserved;
+	uint16_t index; // index inside Assets::bitmaps or Assets::fonts
+	uint32_t nameOffset; // offset of the bitmap name, 0 if not available
+	uint32_t dataOffset; // offset of the LZ4 compressed data
+	uint32_t compressedSize;
+	uint32_t decompressedSize;
+};
+
 struct Assets;
 extern Assets *g_mainAssets;
 extern bool g_mainAssetsAreMutable;
@@ -463,15 +503,28 @@ bool decompressAssetsData(const uint8_t *assetsData, uint32_t assetsDataSize, As
 
 void loadMainAssets(const uint8_t *assets, uint32_t assetsSize);
 
+#if EEZ_OPTION_MAPPED_ASSETS
+// Assets file is memory mapped, so only the used parts are loaded into RAM.
+// Compressed assets file is also supported, but then it is decompressed as with loadMainAssets.
+bool loadMainAssetsFromFile(const char *filePath);
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 
 #if EEZ_OPTION_GUI
 const gui::PageAsset *getPageAsset(int pageId);
 const gui::PageAsset* getPageAsset(int pageId, gui::WidgetCursor& widgetCursor);
 const gui::Style *getStyle(int styleID);
+// Can return nullptr, also for mapped assets section that can't be loaded (out of memory
+// even after unused sections are evicted, or corrupted data).
 const gui::FontData *getFontData(int fontID);
 const gui::Bitmap *getBitmap(int bitmapID);
 const int getBitmapIdByName(const char *bitmapName);
+
+// Frees least recently used mapped assets sections above EEZ_MAPPED_ASSETS_CACHE_SIZE.
+// FontData and Bitmap pointers returned by getFontData and getBitmap are valid until then,
+// so this is called only between frames.
+void evictMappedAssetsSections();
 #endif
 
 int getThemesCount();
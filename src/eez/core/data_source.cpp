@@ -0,0 +1,153 @@
+/*
+ * eez-framework
+ *
+ * MIT License
+ * Copyright 2024 Envox d.o.o.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <new>
+
+#include <eez/core/data_source.h>
+#include <eez/core/alloc.h>
+
+namespace eez {
+
+Value Value::makeDataSourceRef(DataSource *dataSource, uint32_t id) {
+    auto dataSourceRef = ObjectAllocator<DataSourceRef>::allocate(id);
+	if (dataSourceRef == nullptr) {
+		return Value(0, VALUE_TYPE_NULL);
+	}
+
+    dataSourceRef->dataSource = dataSource;
+    dataSourceRef->usageCounter = 0;
+    for (size_t i = 0; i < EEZ_DATA_SOURCE_MAX_PAGES; i++) {
+        auto &page = dataSourceRef->pages[i];
+        page.firstRow = 0;
+        page.numRows = 0;
+        page.lastUsed = 0;
+        page.rows = nullptr;
+    }
+
+    dataSourceRef->refCounter = 1;
+
+    Value value;
+
+    value.type = VALUE_TYPE_DATA_SOURCE_REF;
+    value.options = VALUE_OPTIONS_REF;
+    value.refValue = dataSourceRef;
+
+	return value;
+}
+
+DataSourceRef::~DataSourceRef() {
+    for (size_t i = 0; i < EEZ_DATA_SOURCE_MAX_PAGES; i++) {
+        auto &page = pages[i];
+        if (page.rows) {
+            for (size_t j = 0; j < EEZ_DATA_SOURCE_ROWS_PER_PAGE; j++) {
+                page.rows[j].~Value();
+            }
+            eez::free(page.rows);
+        }
+    }
+}
+
+uint32_t DataSourceRef::getNumRows() {
+    return dataSource ? dataSource->getNumRows() : 0;
+}
+
+DataSourcePage *DataSourceRef::getPage(uint32_t pageIndex) {
+    uint32_t firstRow = pageIndex * EEZ_DATA_SOURCE_ROWS_PER_PAGE;
+
+    DataSourcePage *lruPage = nullptr;
+    for (size_t i = 0; i < EEZ_DATA_SOURCE_MAX_PAGES; i++) {
+        auto &page = pages[i];
+        if (page.numRows > 0 && page.firstRow == firstRow) {
+            page.lastUsed = ++usageCounter;
+            return &page;
+        }
+        if (!lruPage || page.lastUsed < lruPage->lastUsed) {
+            lruPage = &page;
+        }
+    }
+
+    uint32_t numRows = getNumRows();
+    if (firstRow >= numRows) {
+        return nullptr;
+    }
+
+    // materialise the page in place of the least recently used one
+    auto page = lruPage;
+
+    if (!page->rows) {
+        page->rows = (Value *)alloc(EEZ_DATA_SOURCE_ROWS_PER_PAGE * sizeof(Value), 0x5a7e3c19);
+        if (!page->rows) {
+            return nullptr;
+        }
+        for (size_t j = 0; j < EEZ_DATA_SOURCE_ROWS_PER_PAGE; j++) {
+            new (page->rows + j) Value();
+        }
+    } else {
+        for (uint32_t j = 0; j < page->numRows; j++) {
+            page->rows[j] = Value();
+        }
+    }
+
+    page->firstRow = firstRow;
+    page->numRows = numRows - firstRow < EEZ_DATA_SOURCE_ROWS_PER_PAGE ? numRows - firstRow : EEZ_DATA_SOURCE_ROWS_PER_PAGE;
+    page->lastUsed = ++usageCounter;
+
+    dataSource->fetchRows(firstRow, page->numRows, page->rows);
+
+    return page;
+}
+
+Value DataSourceRef::getRow(uint32_t rowIndex) {
+    auto page = getPage(rowIndex / EEZ_DATA_SOURCE_ROWS_PER_PAGE);
+    if (!page || rowIndex - page->firstRow >= page->numRows) {
+        return Value();
+    }
+    return page->rows[rowIndex - page->firstRow];
+}
+
+void DataSourceRef::setViewport(uint32_t first, uint32_t count) {
+    uint32_t numRows = getNumRows();
+    if (first >= numRows || count == 0) {
+        return;
+    }
+
+    // prefetch less if viewport together with prefetched rows doesn't fit into the cache
+    uint32_t prefetch = EEZ_DATA_SOURCE_PREFETCH_ROWS;
+    uint32_t from;
+    uint32_t to;
+    while (true) {
+        from = first > prefetch ? first - prefetch : 0;
+        to = first + count + prefetch;
+        if (to > numRows) {
+            to = numRows;
+        }
+        if ((to - 1) / EEZ_DATA_SOURCE_ROWS_PER_PAGE - from / EEZ_DATA_SOURCE_ROWS_PER_PAGE + 1 <= EEZ_DATA_SOURCE_MAX_PAGES || prefetch == 0) {
+            break;
+        }
+        prefetch /= 2;
+    }
+
+    for (uint32_t pageIndex = from / EEZ_DATA_SOURCE_ROWS_PER_PAGE; pageIndex <= (to - 1) / EEZ_DATA_SOURCE_ROWS_PER_PAGE; pageIndex++) {
+        getPage(pageIndex);
+    }
+}
+
+void DataSourceRef::invalidate() {
+    for (size_t i = 0; i < EEZ_DATA_SOURCE_MAX_PAGES; i++) {
+        auto &page = pages[i];
+        for (uint32_t j = 0; j < page.numRows; j++) {
+            page.rows[j] = Value();
+        }
+        page.numRows = 0;
+        page.lastUsed = 0;
+    }
+}
+
+} // namespace eez
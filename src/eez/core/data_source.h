@@ -0,0 +1,74 @@
+/*
+ * eez-framework
+ *
+ * MIT License
+ * Copyright 2024 Envox d.o.o.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <eez/core/value.h>
+
+#if !defined(EEZ_DATA_SOURCE_ROWS_PER_PAGE)
+#define EEZ_DATA_SOURCE_ROWS_PER_PAGE 32
+#endif
+
+#if !defined(EEZ_DATA_SOURCE_MAX_PAGES)
+#define EEZ_DATA_SOURCE_MAX_PAGES 8
+#endif
+
+// number of rows prefetched before and after the viewport
+#if !defined(EEZ_DATA_SOURCE_PREFETCH_ROWS)
+#define EEZ_DATA_SOURCE_PREFETCH_ROWS 16
+#endif
+
+namespace eez {
+
+// Rows of a data set which is too big to be kept in memory as Values, e.g.
+// records from a file or from a native callback. Implemented by the
+// application and bound to the List or Grid through the DataSourceRef value.
+struct DataSource {
+    virtual ~DataSource() {}
+
+    virtual uint32_t getNumRows() = 0;
+
+    // set rows[i] to the row (first + i), for i in [0, count)
+    virtual void fetchRows(uint32_t first, uint32_t count, Value *rows) = 0;
+};
+
+struct DataSourcePage {
+    uint32_t firstRow;
+    uint32_t numRows;
+    uint32_t lastUsed;
+    Value *rows; // EEZ_DATA_SOURCE_ROWS_PER_PAGE rows, allocated on first use
+};
+
+// Rows are materialised on demand, page by page, and kept in the LRU cache of
+// EEZ_DATA_SOURCE_MAX_PAGES pages, so memory usage doesn't depend on the
+// number of rows. DataSource is not owned, it must outlive this object.
+struct DataSourceRef : public Ref {
+    ~DataSourceRef();
+
+    DataSource *dataSource;
+    uint32_t usageCounter;
+    DataSourcePage pages[EEZ_DATA_SOURCE_MAX_PAGES];
+
+    uint32_t getNumRows();
+
+    // returns undefined value if rowIndex is out of range
+    Value getRow(uint32_t rowIndex);
+
+    // rows in [first, first + count) are visible, fetch them (and the rows around them) in advance
+    void setViewport(uint32_t first, uint32_t count);
+
+    // call it when data set is changed
+    void invalidate();
+
+private:
+    DataSourcePage *getPage(uint32_t pageIndex);
+};
+
+} // namespace eez
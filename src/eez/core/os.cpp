@@ -42,13 +42,23 @@
 
 namespace eez {
 
+#if defined(EEZ_PLATFORM_SIMULATOR)
+static bool g_manualMillisEnabled;
+static uint32_t g_manualMillis;
+
+void setManualMillis(bool enabled, uint32_t time) {
+	g_manualMillisEnabled = enabled;
+	g_manualMillis = time;
+}
+#endif
+
 uint32_t millis() {
 #if defined(EEZ_PLATFORM_STM32)
 	return HAL_GetTick();
 #elif defined(__EMSCRIPTEN__)
 	return (uint32_t)emscripten_get_now();
 #elif defined(EEZ_PLATFORM_SIMULATOR)
-	return osKernelGetTickCount();
+	return g_manualMillisEnabled ? g_manualMillis : osKernelGetTickCount();
 #elif defined(EEZ_PLATFORM_ESP32)
 	return (unsigned long) (esp_timer_get_time() / 1000ULL);
 #elif defined(EEZ_PLATFORM_PICO)
@@ -101,6 +101,12 @@ enum TestResult {
 
 uint32_t millis();
 
+#if defined(EEZ_PLATFORM_SIMULATOR)
+// Simulator only: while enabled millis() returns the time set here instead of the real time,
+// so the flow can be driven by a fixed time schedule (see tools/snapshot_check).
+void setManualMillis(bool enabled, uint32_t time = 0);
+#endif
+
 #if EEZ_OPTION_THREADS
 extern bool g_shutdown;
 #endif
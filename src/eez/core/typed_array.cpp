@@ -0,0 +1,420 @@
+/*
+ * eez-framework
+ *
+ * MIT License
+ * Copyright 2024 Envox d.o.o.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <eez/conf-internal.h>
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <eez/core/typed_array.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TYPED_ARRAY_SSE2 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define TYPED_ARRAY_NEON 1
+#endif
+
+namespace eez {
+
+////////////////////////////////////////////////////////////////////////////////
+
+static double sumFloat(const float *data, uint32_t size) {
+    uint32_t i = 0;
+    double sum = 0;
+
+#if defined(TYPED_ARRAY_SSE2)
+    __m128d acc1 = _mm_setzero_pd();
+    __m128d acc2 = _mm_setzero_pd();
+    for (; i + 4 <= size; i += 4) {
+        __m128 v = _mm_loadu_ps(data + i);
+        acc1 = _mm_add_pd(acc1, _mm_cvtps_pd(v));
+        acc2 = _mm_add_pd(acc2, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(acc1, acc2));
+    sum = lanes[0] + lanes[1];
+#elif defined(TYPED_ARRAY_NEON)
+    float64x2_t acc1 = vdupq_n_f64(0);
+    float64x2_t acc2 = vdupq_n_f64(0);
+    for (; i + 4 <= size; i += 4) {
+        float32x4_t v = vld1q_f32(data + i);
+        acc1 = vaddq_f64(acc1, vcvt_f64_f32(vget_low_f32(v)));
+        acc2 = vaddq_f64(acc2, vcvt_high_f64_f32(v));
+    }
+    sum = vaddvq_f64(vaddq_f64(acc1, acc2));
+#endif
+
+    for (; i < size; i++) {
+        sum += data[i];
+    }
+
+    return sum;
+}
+
+static double sumDouble(const double *data, uint32_t size) {
+    uint32_t i = 0;
+    double sum = 0;
+
+#if defined(TYPED_ARRAY_SSE2)
+    __m128d acc1 = _mm_setzero_pd();
+    __m128d acc2 = _mm_setzero_pd();
+    for (; i + 4 <= size; i += 4) {
+        acc1 = _mm_add_pd(acc1, _mm_loadu_pd(data + i));
+        acc2 = _mm_add_pd(acc2, _mm_loadu_pd(data + i + 2));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(acc1, acc2));
+    sum = lanes[0] + lanes[1];
+#elif defined(TYPED_ARRAY_NEON)
+    float64x2_t acc1 = vdupq_n_f64(0);
+    float64x2_t acc2 = vdupq_n_f64(0);
+    for (; i + 4 <= size; i += 4) {
+        acc1 = vaddq_f64(acc1, vld1q_f64(data + i));
+        acc2 = vaddq_f64(acc2, vld1q_f64(data + i + 2));
+    }
+    sum = vaddvq_f64(vaddq_f64(acc1, acc2));
+#endif
+
+    for (; i < size; i++) {
+        sum += data[i];
+    }
+
+    return sum;
+}
+
+static float minMaxFloat(const float *data, uint32_t size, bool max) {
+    uint32_t i = 1;
+    float result = data[0];
+
+#if defined(TYPED_ARRAY_SSE2)
+    if (size >= 4) {
+        // _mm_min/max_ps doesn't propagate NaN, so it is detected separately
+        __m128 acc = _mm_loadu_ps(data);
+        __m128 nanMask = _mm_cmpunord_ps(acc, acc);
+        for (i = 4; i + 4 <= size; i += 4) {
+            __m128 v = _mm_loadu_ps(data + i);
+            nanMask = _mm_or_ps(nanMask, _mm_cmpunord_ps(v, v));
+            acc = max ? _mm_max_ps(acc, v) : _mm_min_ps(acc, v);
+        }
+        if (_mm_movemask_ps(nanMask)) {
+            return NAN;
+        }
+        float lanes[4];
+        _mm_storeu_ps(lanes, acc);
+        result = lanes[0];
+        for (int j = 1; j < 4; j++) {
+            if (max ? lanes[j] > result : lanes[j] < result) {
+                result = lanes[j];
+            }
+        }
+    }
+#elif defined(TYPED_ARRAY_NEON)
+    if (size >= 4) {
+        float32x4_t acc = vld1q_f32(data);
+        for (i = 4; i + 4 <= size; i += 4) {
+            float32x4_t v = vld1q_f32(data + i);
+            acc = max ? vmaxq_f32(acc, v) : vminq_f32(acc, v);
+        }
+        result = max ? vmaxvq_f32(acc) : vminvq_f32(acc);
+    }
+#endif
+
+    if (isnan(result)) {
+        return NAN;
+    }
+
+    for (; i < size; i++) {
+        if (isnan(data[i])) {
+            return NAN;
+        }
+        if (max ? data[i] > result : data[i] < result) {
+            result = data[i];
+        }
+    }
+
+    return result;
+}
+
+static double minMaxDouble(const double *data, uint32_t size, bool max) {
+    uint32_t i = 1;
+    double result = data[0];
+
+#if defined(TYPED_ARRAY_SSE2)
+    if (size >= 2) {
+        __m128d acc = _mm_loadu_pd(data);
+        __m128d nanMask = _mm_cmpunord_pd(acc, acc);
+        for (i = 2; i + 2 <= size; i += 2) {
+            __m128d v = _mm_loadu_pd(data + i);
+            nanMask = _mm_or_pd(nanMask, _mm_cmpunord_pd(v, v));
+            acc = max ? _mm_max_pd(acc, v) : _mm_min_pd(acc, v);
+        }
+        if (_mm_movemask_pd(nanMask)) {
+            return NAN;
+        }
+        double lanes[2];
+        _mm_storeu_pd(lanes, acc);
+        result = (max ? lanes[1] > lanes[0] : lanes[1] < lanes[0]) ? lanes[1] : lanes[0];
+    }
+#elif defined(TYPED_ARRAY_NEON)
+    if (size >= 2) {
+        float64x2_t acc = vld1q_f64(data);
+        for (i = 2; i + 2 <= size; i += 2) {
+            float64x2_t v = vld1q_f64(data + i);
+            acc = max ? vmaxq_f64(acc, v) : vminq_f64(acc, v);
+        }
+        result = max ? vmaxvq_f64(acc) : vminvq_f64(acc);
+    }
+#endif
+
+    if (isnan(result)) {
+        return NAN;
+    }
+
+    for (; i < size; i++) {
+        if (isnan(data[i])) {
+            return NAN;
+        }
+        if (max ? data[i] > result : data[i] < result) {
+            result = data[i];
+        }
+    }
+
+    return result;
+}
+
+template<typename T>
+static T minMaxInteger(const T *data, uint32_t size, bool max) {
+    // simple loop, compilers are vectorizing this
+    T result = data[0];
+    if (max) {
+        for (uint32_t i = 1; i < size; i++) {
+            result = data[i] > result ? data[i] : result;
+        }
+    } else {
+        for (uint32_t i = 1; i < size; i++) {
+            result = data[i] < result ? data[i] : result;
+        }
+    }
+    return result;
+}
+
+static double minMax(const TypedArrayRef *typedArray, bool max) {
+    if (typedArray->size == 0) {
+        return NAN;
+    }
+    if (typedArray->elementType == TYPED_ARRAY_ELEMENT_TYPE_FLOAT) {
+        return minMaxFloat((const float *)typedArray->data, typedArray->size, max);
+    }
+    if (typedArray->elementType == TYPED_ARRAY_ELEMENT_TYPE_DOUBLE) {
+        return minMaxDouble((const double *)typedArray->data, typedArray->size, max);
+    }
+    if (typedArray->elementType == TYPED_ARRAY_ELEMENT_TYPE_INT32) {
+        return minMaxInteger((const int32_t *)typedArray->data, typedArray->size, max);
+    }
+    return minMaxInteger((const uint8_t *)typedArray->data, typedArray->size, max);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double typedArraySum(const TypedArrayRef *typedArray) {
+    if (typedArray->elementType == TYPED_ARRAY_ELEMENT_TYPE_FLOAT) {
+        return sumFloat((const float *)typedArray->data, typedArray->size);
+    }
+
+    if (typedArray->elementType == TYPED_ARRAY_ELEMENT_TYPE_DOUBLE) {
+        return sumDouble((const double *)typedArray->data, typedArray->size);
+    }
+
+    int64_t sum = 0;
+    if (typedArray->elementType == TYPED_ARRAY_ELEMENT_TYPE_INT32) {
+        auto data = (const int32_t *)typedArray->data;
+        for (uint32_t i = 0; i < typedArray->size; i++) {
+            sum += data[i];
+        }
+    } else {
+        auto data = (const uint8_t *)typedArray->data;
+        for (uint32_t i = 0; i < typedArray->size; i++) {
+            sum += data[i];
+        }
+    }
+    return (double)sum;
+}
+
+double typedArrayMin(const TypedArrayRef *typedArray) {
+    return minMax(typedArray, false);
+}
+
+double typedArrayMax(const TypedArrayRef *typedArray) {
+    return minMax(typedArray, true);
+}
+
+void typedArrayScale(TypedArrayRef *typedArray, double factor) {
+    uint32_t size = typedArray->size;
+    uint32_t i = 0;
+
+    if (typedArray->elementType == TYPED_ARRAY_ELEMENT_TYPE_FLOAT) {
+        auto data = (float *)typedArray->data;
+#if defined(TYPED_ARRAY_SSE2)
+        __m128 f = _mm_set1_ps((float)factor);
+        for (; i + 4 <= size; i += 4) {
+            _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), f));
+        }
+#elif defined(TYPED_ARRAY_NEON)
+        float32x4_t f = vdupq_n_f32((float)factor);
+        for (; i + 4 <= size; i += 4) {
+            vst1q_f32(data + i, vmulq_f32(vld1q_f32(data + i), f));
+        }
+#endif
+        for (; i < size; i++) {
+            data[i] = (float)(data[i] * factor);
+        }
+    } else if (typedArray->elementType == TYPED_ARRAY_ELEMENT_TYPE_DOUBLE) {
+        auto data = (double *)typedArray->data;
+#if defined(TYPED_ARRAY_SSE2)
+        __m128d f = _mm_set1_pd(factor);
+        for (; i + 2 <= size; i += 2) {
+            _mm_storeu_pd(data + i, _mm_mul_pd(_mm_loadu_pd(data + i), f));
+        }
+#elif defined(TYPED_ARRAY_NEON)
+        float64x2_t f = vdupq_n_f64(factor);
+        for (; i + 2 <= size; i += 2) {
+            vst1q_f64(data + i, vmulq_f64(vld1q_f64(data + i), f));
+        }
+#endif
+        for (; i < size; i++) {
+            data[i] *= factor;
+        }
+    } else if (typedArray->elementType == TYPED_ARRAY_ELEMENT_TYPE_INT32) {
+        auto data = (int32_t *)typedArray->data;
+        for (; i < size; i++) {
+            // saturate, out of range conversion to int32_t is undefined
+            auto value = round(data[i] * factor);
+            data[i] = isnan(value) ? 0 : value <= INT32_MIN ? INT32_MIN : value >= INT32_MAX ? INT32_MAX : (int32_t)value;
+        }
+    } else {
+        auto data = (uint8_t *)typedArray->data;
+        for (; i < size; i++) {
+            auto value = round(data[i] * factor);
+            data[i] = isnan(value) || value < 0 ? 0 : value > 255 ? 255 : (uint8_t)value;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// NAN is always sorted last (for both orders), so comparator is a strict weak ordering
+template<typename T>
+static int compareNaN(T aValue, T bValue) {
+    bool aIsNaN = aValue != aValue;
+    bool bIsNaN = bValue != bValue;
+    return aIsNaN ? (bIsNaN ? 0 : 1) : -1;
+}
+
+template<typename T>
+static int compareAscending(const void *a, const void *b) {
+    T aValue = *(const T *)a;
+    T bValue = *(const T *)b;
+    if (aValue != aValue || bValue != bValue) {
+        return compareNaN(aValue, bValue);
+    }
+    return aValue < bValue ? -1 : aValue > bValue ? 1 : 0;
+}
+
+template<typename T>
+static int compareDescending(const void *a, const void *b) {
+    T aValue = *(const T *)a;
+    T bValue = *(const T *)b;
+    if (aValue != aValue || bValue != bValue) {
+        return compareNaN(aValue, bValue);
+    }
+    return aValue > bValue ? -1 : aValue < bValue ? 1 : 0;
+}
+
+void typedArraySort(TypedArrayRef *typedArray, bool ascending) {
+    int (*compare)(const void *, const void *);
+
+    if (typedArray->elementType == TYPED_ARRAY_ELEMENT_TYPE_FLOAT) {
+        compare = ascending ? compareAscending<float> : compareDescending<float>;
+    } else if (typedArray->elementType == TYPED_ARRAY_ELEMENT_TYPE_DOUBLE) {
+        compare = ascending ? compareAscending<double> : compareDescending<double>;
+    } else if (typedArray->elementType == TYPED_ARRAY_ELEMENT_TYPE_INT32) {
+        compare = ascending ? compareAscending<int32_t> : compareDescending<int32_t>;
+    } else {
+        compare = ascending ? compareAscending<uint8_t> : compareDescending<uint8_t>;
+    }
+
+    qsort(typedArray->data, typedArray->size, getTypedArrayElementSize(typedArray->elementType), compare);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Value typedArraySlice(const Value &typedArrayValue, uint32_t from, uint32_t to, uint32_t id) {
+    auto typedArray = typedArrayValue.getTypedArray();
+
+    if (to > typedArray->size) {
+        to = typedArray->size;
+    }
+    if (from > to) {
+        from = to;
+    }
+
+    auto elementSize = getTypedArrayElementSize(typedArray->elementType);
+
+    return Value::makeTypedArrayRef((TypedArrayElementType)typedArray->elementType, to - from, (const uint8_t *)typedArray->data + from * elementSize, id);
+}
+
+Value typedArrayAppend(const Value &typedArrayValue, const Value &elementValue, uint32_t id) {
+    auto typedArray = typedArrayValue.getTypedArray();
+
+    if (typedArray->size == UINT32_MAX) {
+        return Value(0, VALUE_TYPE_NULL);
+    }
+
+    auto resultValue = Value::makeTypedArrayRef((TypedArrayElementType)typedArray->elementType, typedArray->size + 1, nullptr, id);
+    if (resultValue.type == VALUE_TYPE_NULL) {
+        return resultValue;
+    }
+
+    auto resultTypedArray = resultValue.getTypedArray();
+    memcpy(resultTypedArray->data, typedArray->data, typedArray->size * getTypedArrayElementSize(typedArray->elementType));
+    if (!resultTypedArray->setElement(typedArray->size, elementValue)) {
+        return Value::makeError();
+    }
+
+    return resultValue;
+}
+
+Value typedArrayFromArray(const Value &arrayValue, TypedArrayElementType elementType, uint32_t id) {
+    if (!arrayValue.isArray()) {
+        return Value(0, VALUE_TYPE_NULL);
+    }
+
+    auto array = arrayValue.getArray();
+
+    auto resultValue = Value::makeTypedArrayRef(elementType, array->arraySize, nullptr, id);
+    if (resultValue.type == VALUE_TYPE_NULL) {
+        return resultValue;
+    }
+
+    auto resultTypedArray = resultValue.getTypedArray();
+    for (uint32_t i = 0; i < array->arraySize; i++) {
+        if (!resultTypedArray->setElement(i, array->values[i])) {
+            return Value(0, VALUE_TYPE_NULL);
+        }
+    }
+
+    return resultValue;
+}
+
+} // namespace eez
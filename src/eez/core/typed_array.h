@@ -0,0 +1,36 @@
+/*
+ * eez-framework
+ *
+ * MIT License
+ * Copyright 2024 Envox d.o.o.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <eez/core/value.h>
+
+namespace eez {
+
+// Bulk operations over the packed typed arrays (see TypedArrayRef).
+// On x86 (SSE2) and ARM (NEON) the float and double kernels are vectorized.
+
+double typedArraySum(const TypedArrayRef *typedArray);
+// min and max return NAN for empty array or if some element is NAN
+double typedArrayMin(const TypedArrayRef *typedArray);
+double typedArrayMax(const TypedArrayRef *typedArray);
+// integer elements are rounded and saturated
+void typedArrayScale(TypedArrayRef *typedArray, double factor);
+
+// NAN elements are placed at the end, both for ascending and descending order
+void typedArraySort(TypedArrayRef *typedArray, bool ascending);
+
+Value typedArraySlice(const Value &typedArrayValue, uint32_t from, uint32_t to, uint32_t id);
+Value typedArrayAppend(const Value &typedArrayValue, const Value &elementValue, uint32_t id);
+
+// converts Array of numbers to the typed array, returns NULL value if some element is not a number
+Value typedArrayFromArray(const Value &arrayValue, TypedArrayElementType elementType, uint32_t id);
+
+} // namespace eez
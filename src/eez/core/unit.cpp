@@ -224,29 +224,46 @@ static Unit getDerivedUnit(Unit unit, float factor) {
 
 static const float FACTORS[] = { 1E-12F, 1E-9F, 1E-6F, 1E-3F, 1E0F, 1E3F, 1E6F, 1E9F, 1E12F };
 
+static const int NUM_UNITS = sizeof(g_baseUnit) / sizeof(Unit);
+static const int NUM_FACTORS = sizeof(FACTORS) / sizeof(float);
+static const int UNIT_FACTOR_INDEX = 4; // index of 1E0F in FACTORS
+
+// derived unit for each unit and factor, findDerivedUnit is called every time float value is displayed
+static const Unit *getDerivedUnitsTable() {
+	static Unit table[NUM_UNITS][NUM_FACTORS];
+	static bool initialized = [] {
+		for (int unit = 0; unit < NUM_UNITS; unit++) {
+			for (int factorIndex = 0; factorIndex < NUM_FACTORS; factorIndex++) {
+				table[unit][factorIndex] = getDerivedUnit((Unit)unit, FACTORS[factorIndex]);
+			}
+		}
+		return true;
+	}();
+	EEZ_UNUSED(initialized);
+	return &table[0][0];
+}
+
 Unit findDerivedUnit(float value, Unit unit) {
+	if (unit == UNIT_UNKNOWN) {
+		return unit;
+	}
+
+	const Unit *derivedUnits = getDerivedUnitsTable() + unit * NUM_FACTORS;
+
 	Unit result;
 
-	for (int factorIndex = 1; ; factorIndex++) {
-		float factor = FACTORS[factorIndex];
-		if (factor > 1.0F) {
-			break;
-		}
-		if (value < factor) {
-			result = getDerivedUnit(unit, FACTORS[factorIndex - 1]);
+	for (int factorIndex = 1; factorIndex <= UNIT_FACTOR_INDEX; factorIndex++) {
+		if (value < FACTORS[factorIndex]) {
+			result = derivedUnits[factorIndex - 1];
 			if (result != UNIT_UNKNOWN) {
 				return result;
 			}
 		}
 	}
 
-	for (int factorIndex = sizeof(FACTORS) / sizeof(float) - 1; factorIndex >= 0; factorIndex--) {
-		float factor = FACTORS[factorIndex];
-		if (factor == 1.0F) {
-			break;
-		}
-		if (value >= factor) {
-			result = getDerivedUnit(unit, factor);
+	for (int factorIndex = NUM_FACTORS - 1; factorIndex > UNIT_FACTOR_INDEX; factorIndex--) {
+		if (value >= FACTORS[factorIndex]) {
+			result = derivedUnits[factorIndex];
 			if (result != UNIT_UNKNOWN) {
 				return result;
 			}
@@ -113,44 +113,235 @@ void stringAppendStringLength(char *str, size_t maxStrLength, const char *value,
     }
 }
 
+// Number formatting without snprintf, used for the values displayed every frame.
+// Output is the same as snprintf with "%d", "%.*f" and "%g" (in C locale),
+// snprintf is still used for the cases not covered here (e.g. exponent notation).
+
+static void appendChars(char *str, size_t maxStrLength, size_t n, const char *chars, size_t length) {
+    if (n >= maxStrLength) {
+        return;
+    }
+    if (length > maxStrLength - n - 1) {
+        length = maxStrLength - n - 1;
+    }
+    memcpy(str + n, chars, length);
+    str[n + length] = 0;
+}
+
+// writes digits to the end of buffer, returns pointer to the first digit
+static char *formatUInt64(char *bufferEnd, uint64_t value) {
+    char *p = bufferEnd;
+    while (value > 0xFFFFFFFF) {
+        *--p = '0' + (char)(value % 10);
+        value /= 10;
+    }
+    uint32_t value32 = (uint32_t)value;
+    do {
+        *--p = '0' + (char)(value32 % 10);
+        value32 /= 10;
+    } while (value32);
+    return p;
+}
+
+static void appendInteger(char *str, size_t maxStrLength, bool negative, uint64_t value) {
+    char buffer[24];
+    char *bufferEnd = buffer + sizeof(buffer);
+    char *p = formatUInt64(bufferEnd, value);
+    if (negative) {
+        *--p = '-';
+    }
+    appendChars(str, maxStrLength, strlen(str), p, bufferEnd - p);
+}
+
 void stringAppendInt(char *str, size_t maxStrLength, int value) {
-    auto n = strlen(str);
-    snprintf(str + n, maxStrLength - n, "%d", value);
+    appendInteger(str, maxStrLength, value < 0, value < 0 ? 0 - (uint64_t)(int64_t)value : (uint64_t)value);
 }
 
 void stringAppendUInt32(char *str, size_t maxStrLength, uint32_t value) {
-    auto n = strlen(str);
-    snprintf(str + n, maxStrLength - n, "%lu", (unsigned long)value);
+    appendInteger(str, maxStrLength, false, value);
 }
 
 void stringAppendInt64(char *str, size_t maxStrLength, int64_t value) {
-    auto n = strlen(str);
-    snprintf(str + n, maxStrLength - n, "%jd", value);
+    appendInteger(str, maxStrLength, value < 0, value < 0 ? 0 - (uint64_t)value : (uint64_t)value);
 }
 
 void stringAppendUInt64(char *str, size_t maxStrLength, uint64_t value) {
-    auto n = strlen(str);
-    snprintf(str + n, maxStrLength - n, "%ju", value);
+    appendInteger(str, maxStrLength, false, value);
+}
+
+static const double g_pow10[] = {
+    1E0, 1E1, 1E2, 1E3, 1E4, 1E5, 1E6, 1E7, 1E8, 1E9,
+    1E10, 1E11, 1E12, 1E13, 1E14, 1E15, 1E16, 1E17, 1E18
+};
+
+static const int FORMAT_MAX_DECIMALS = 17;
+
+// Rounds value * 10^numDecimalPlaces (value >= 0) to the nearest integer, ties to even,
+// using the exact product (fma) so the result is the same as with the correctly rounded snprintf.
+static bool roundScaled(double value, int numDecimalPlaces, uint64_t &result) {
+    double scaled = value * g_pow10[numDecimalPlaces];
+    if (!(scaled < 4503599627370496.0)) {
+        // 2^52, above this the product rounding error can be bigger than 0.25
+        return false;
+    }
+
+    double error = fma(value, g_pow10[numDecimalPlaces], -scaled);
+
+    double integerPart = floor(scaled);
+    result = (uint64_t)integerPart;
+
+    double diff = (scaled - integerPart - 0.5) + error;
+    if (diff > 0 || (diff == 0 && (result & 1))) {
+        result++;
+    }
+
+    return true;
+}
+
+// formats scaled integer as fixed point number with numDecimalPlaces decimals,
+// if stripZeros is true then trailing zeros and decimal point are removed as with "%g"
+static size_t formatFixed(char *buffer, bool negative, uint64_t scaled, int numDecimalPlaces, bool stripZeros) {
+    char digitsBuffer[24];
+    char *digitsEnd = digitsBuffer + sizeof(digitsBuffer);
+    char *digits = formatUInt64(digitsEnd, scaled);
+    int numDigits = digitsEnd - digits;
+
+    char *p = buffer;
+
+    if (negative) {
+        *p++ = '-';
+    }
+
+    if (numDigits <= numDecimalPlaces) {
+        *p++ = '0';
+        if (numDecimalPlaces > 0) {
+            *p++ = '.';
+            for (int i = numDigits; i < numDecimalPlaces; i++) {
+                *p++ = '0';
+            }
+            memcpy(p, digits, numDigits);
+            p += numDigits;
+        }
+    } else {
+        int numIntegerDigits = numDigits - numDecimalPlaces;
+        memcpy(p, digits, numIntegerDigits);
+        p += numIntegerDigits;
+        if (numDecimalPlaces > 0) {
+            *p++ = '.';
+            memcpy(p, digits + numIntegerDigits, numDecimalPlaces);
+            p += numDecimalPlaces;
+        }
+    }
+
+    if (stripZeros && numDecimalPlaces > 0) {
+        while (p[-1] == '0') {
+            p--;
+        }
+        if (p[-1] == '.') {
+            p--;
+        }
+    }
+
+    return p - buffer;
+}
+
+// "%g" with default precision of 6 significant digits
+static const int G_PRECISION = 6;
+
+static bool formatDoubleG(char *buffer, size_t &length, double value) {
+    bool negative = signbit(value) != 0;
+    value = fabs(value);
+
+    if (value == 0) {
+        length = formatFixed(buffer, negative, 0, 0, true);
+        return true;
+    }
+
+    // for smaller and bigger values snprintf will use exponent notation
+    if (!(value >= 1E-4 && value < 999999.5)) {
+        return false;
+    }
+
+    // find exponent of the value rounded to G_PRECISION significant digits
+    int exponent = 5;
+    while (exponent > -4 && value < (exponent >= 0 ? g_pow10[exponent] : 1.0 / g_pow10[-exponent])) {
+        exponent--;
+    }
+
+    uint64_t scaled;
+    for (int i = 0; i < 2; i++) {
+        if (!roundScaled(value, G_PRECISION - 1 - exponent, scaled)) {
+            return false;
+        }
+
+        if (scaled >= (uint64_t)g_pow10[G_PRECISION]) {
+            // rounded up to the next power of 10
+            if (exponent == 5) {
+                return false;
+            }
+            exponent++;
+        } else if (scaled < (uint64_t)g_pow10[G_PRECISION - 1]) {
+            if (exponent == -4) {
+                return false;
+            }
+            exponent--;
+        } else {
+            break;
+        }
+    }
+
+    if (scaled < (uint64_t)g_pow10[G_PRECISION - 1] || scaled >= (uint64_t)g_pow10[G_PRECISION]) {
+        return false;
+    }
+
+    length = formatFixed(buffer, negative, scaled, G_PRECISION - 1 - exponent, true);
+    return true;
+}
+
+static bool formatDoubleFixed(char *buffer, size_t &length, double value, int numDecimalPlaces) {
+    if (numDecimalPlaces < 0 || numDecimalPlaces > FORMAT_MAX_DECIMALS || isnan(value)) {
+        return false;
+    }
+
+    bool negative = signbit(value) != 0;
+
+    uint64_t scaled;
+    if (!roundScaled(fabs(value), numDecimalPlaces, scaled)) {
+        return false;
+    }
+
+    length = formatFixed(buffer, negative, scaled, numDecimalPlaces, false);
+    return true;
 }
 
 void stringAppendFloat(char *str, size_t maxStrLength, float value) {
-    auto n = strlen(str);
-    snprintf(str + n, maxStrLength - n, "%g", value);
+    stringAppendDouble(str, maxStrLength, value);
 }
 
 void stringAppendFloat(char *str, size_t maxStrLength, float value, int numDecimalPlaces) {
-    auto n = strlen(str);
-    snprintf(str + n, maxStrLength - n, "%.*f", numDecimalPlaces, value);
+    stringAppendDouble(str, maxStrLength, value, numDecimalPlaces);
 }
 
 void stringAppendDouble(char *str, size_t maxStrLength, double value) {
     auto n = strlen(str);
-    snprintf(str + n, maxStrLength - n, "%g", value);
+    char buffer[32];
+    size_t length;
+    if (formatDoubleG(buffer, length, value)) {
+        appendChars(str, maxStrLength, n, buffer, length);
+    } else {
+        snprintf(str + n, maxStrLength - n, "%g", value);
+    }
 }
 
 void stringAppendDouble(char *str, size_t maxStrLength, double value, int numDecimalPlaces) {
     auto n = strlen(str);
-    snprintf(str + n, maxStrLength - n, "%.*f", numDecimalPlaces, value);
+    char buffer[48];
+    size_t length;
+    if (formatDoubleFixed(buffer, length, value, numDecimalPlaces)) {
+        appendChars(str, maxStrLength, n, buffer, length);
+    } else {
+        snprintf(str + n, maxStrLength - n, "%.*f", numDecimalPlaces, value);
+    }
 }
 
 void stringAppendVoltage(char *str, size_t maxStrLength, float value) {
@@ -193,29 +384,30 @@ uint32_t crc32(const uint8_t *mem_block, size_t block_size) {
 	return HAL_CRC_Calculate(&hcrc, (uint32_t *)mem_block, block_size);
 }
 #else
-/*
-From http://www.hackersdelight.org/hdcodetxt/crc.c.txt:
-
-This is the basic CRC-32 calculation with some optimization but no
-table lookup. The the byte reversal is avoided by shifting the crc reg
-right instead of left and by using a reversed 32-bit word to represent
-the polynomial.
-When compiled to Cyclops with GCC, this function executes in 8 + 72n
-instructions, where n is the number of bytes in the input message. It
-should be doable in 4 + 61n instructions.
-If the inner loop is strung out (approx. 5*8 = 40 instructions),
-it would take about 6 + 46n instructions.
-*/
+// Table driven version of the standard (reversed polynomial 0xEDB88320) CRC-32.
+
+static const uint32_t *getCrc32Table() {
+    static uint32_t table[256];
+    static bool initialized = [] {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t crc = i;
+            for (int j = 0; j < 8; j++) {
+                uint32_t mask = -((int32_t)crc & 1);
+                crc = (crc >> 1) ^ (0xEDB88320 & mask);
+            }
+            table[i] = crc;
+        }
+        return true;
+    }();
+    EEZ_UNUSED(initialized);
+    return table;
+}
 
 uint32_t crc32(const uint8_t *mem_block, size_t block_size) {
+    auto table = getCrc32Table();
     uint32_t crc = 0xFFFFFFFF;
     for (size_t i = 0; i < block_size; ++i) {
-        uint32_t byte = mem_block[i]; // Get next byte.
-        crc = crc ^ byte;
-        for (int j = 0; j < 8; ++j) { // Do eight times.
-            uint32_t mask = -((int32_t)crc & 1);
-            crc = (crc >> 1) ^ (0xEDB88320 & mask);
-        }
+        crc = (crc >> 8) ^ table[(crc ^ mem_block[i]) & 0xFF];
     }
     return ~crc;
 }
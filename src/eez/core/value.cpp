@@ -18,6 +18,7 @@
 
 #include <eez/core/util.h>
 #include <eez/core/value.h>
+#include <eez/core/data_source.h>
 #include <eez/core/vars.h>
 
 #include <eez/flow/flow.h>
@@ -186,6 +187,62 @@ static const char *UINT64_value_type_name(const Value &value) {
     return "uint64";
 }
 
+static void appendUnitName(char *text, int count, Unit unit) {
+    const char *unitName = getUnitName(unit);
+    if (unitName && *unitName) {
+        stringAppendString(text, count, " ");
+        stringAppendString(text, count, unitName);
+    }
+}
+
+// Appends value formatted with "%g" (or with 2 decimals for the power units) without trailing zeros,
+// optionally keeping at least one decimal (1 => 1.0), followed by the unit name.
+static void appendNumberAndUnit(char *text, int count, double value, Unit unit, bool appendDotZero) {
+    int start = strlen(text);
+
+    if (unit == UNIT_WATT || unit == UNIT_MILLI_WATT) {
+        stringAppendDouble(text, count, value, 2);
+    } else {
+        stringAppendDouble(text, count, value);
+    }
+
+    int n = start + strlen(text + start);
+
+    int decimalPointIndex;
+    for (decimalPointIndex = start; decimalPointIndex < n; ++decimalPointIndex) {
+        if (text[decimalPointIndex] == '.') {
+            break;
+        }
+    }
+
+    if (decimalPointIndex == n) {
+        if (appendDotZero) {
+            // 1 => 1.0
+            stringAppendStringLength(text, count, ".0", 2);
+        }
+    } else if (decimalPointIndex == n - 1) {
+        if (appendDotZero) {
+            // 1. => 1.0
+            stringAppendStringLength(text, count, "0", 1);
+        } else {
+            text[decimalPointIndex] = 0;
+        }
+    } else {
+        // remove trailing zeros
+        if (appendDotZero) {
+            for (int j = n - 1; j > decimalPointIndex + 1 && text[j] == '0'; j--) {
+                text[j] = 0;
+            }
+        } else {
+            for (int j = n - 1; j >= decimalPointIndex && (text[j] == '0' || text[j] == '.'); j--) {
+                text[j] = 0;
+            }
+        }
+    }
+
+    appendUnitName(text, count, unit);
+}
+
 static bool compare_FLOAT_value(const Value &a, const Value &b) {
     return a.type == b.type && a.getUnit() == b.getUnit() && a.getFloat() == b.getFloat() && a.getOptions() == b.getOptions();
 }
@@ -226,52 +283,9 @@ static void FLOAT_value_to_text(const Value &value, char *text, int count) {
 
         if (fixedDecimals) {
             stringAppendFloat(text, count, floatValue, FLOAT_OPTIONS_GET_NUM_FIXED_DECIMALS(options));
+            appendUnitName(text, count, unit);
         } else {
-            if (unit == UNIT_WATT || unit == UNIT_MILLI_WATT) {
-                stringAppendFloat(text, count, floatValue, 2);
-            } else {
-                stringAppendFloat(text, count, floatValue);
-            }
-
-            int n = strlen(text);
-
-            int decimalPointIndex;
-            for (decimalPointIndex = 0; decimalPointIndex < n; ++decimalPointIndex) {
-                if (text[decimalPointIndex] == '.') {
-                    break;
-                }
-            }
-
-            if (decimalPointIndex == n) {
-                if (appendDotZero) {
-                    // 1 => 1.0
-                    stringAppendString(text, count, ".0");
-                }
-            } else if (decimalPointIndex == n - 1) {
-                if (appendDotZero) {
-                    // 1. => 1.0
-                    stringAppendString(text, count, "0");
-                } else {
-                    text[decimalPointIndex] = 0;
-                }
-            } else {
-                // remove trailing zeros
-                if (appendDotZero) {
-                    for (int j = n - 1; j > decimalPointIndex + 1 && text[j] == '0'; j--) {
-                        text[j] = 0;
-                    }
-                } else {
-                    for (int j = n - 1; j >= decimalPointIndex && (text[j] == '0' || text[j] == '.'); j--) {
-                        text[j] = 0;
-                    }
-                }
-            }
-        }
-
-        const char *unitName = getUnitName(unit);
-        if (unitName && *unitName) {
-            stringAppendString(text, count, " ");
-            stringAppendString(text, count, unitName);
+            appendNumberAndUnit(text, count, floatValue, unit, appendDotZero);
         }
     } else {
         text[0] = 0;
@@ -323,52 +337,9 @@ static void DOUBLE_value_to_text(const Value &value, char *text, int count) {
 
         if (fixedDecimals) {
             stringAppendFloat(text, count, doubleValue, FLOAT_OPTIONS_GET_NUM_FIXED_DECIMALS(options));
+            appendUnitName(text, count, unit);
         } else {
-            if (unit == UNIT_WATT || unit == UNIT_MILLI_WATT) {
-                stringAppendDouble(text, count, doubleValue, 2);
-            } else {
-                stringAppendDouble(text, count, doubleValue);
-            }
-
-            int n = strlen(text);
-
-            int decimalPointIndex;
-            for (decimalPointIndex = 0; decimalPointIndex < n; ++decimalPointIndex) {
-                if (text[decimalPointIndex] == '.') {
-                    break;
-                }
-            }
-
-            if (decimalPointIndex == n) {
-                if (appendDotZero) {
-                    // 1 => 1.0
-                    stringAppendString(text, count, ".0");
-                }
-            } else if (decimalPointIndex == n - 1) {
-                if (appendDotZero) {
-                    // 1. => 1.0
-                    stringAppendString(text, count, "0");
-                } else {
-                    text[decimalPointIndex] = 0;
-                }
-            } else {
-                // remove trailing zeros
-                if (appendDotZero) {
-                    for (int j = n - 1; j > decimalPointIndex + 1 && text[j] == '0'; j--) {
-                        text[j] = 0;
-                    }
-                } else {
-                    for (int j = n - 1; j >= decimalPointIndex && (text[j] == '0' || text[j] == '.'); j--) {
-                        text[j] = 0;
-                    }
-                }
-            }
-        }
-
-        const char *unitName = getUnitName(unit);
-        if (unitName && *unitName) {
-            stringAppendString(text, count, " ");
-            stringAppendString(text, count, unitName);
+            appendNumberAndUnit(text, count, doubleValue, unit, appendDotZero);
         }
     } else {
         text[0] = 0;
@@ -384,15 +355,17 @@ static bool compare_STRING_value(const Value &a, const Value &b) {
     if (!b.isString()) {
         return false;
     }
-    const char *astr = a.getString();
-    const char *bstr = b.getString();
+    uint32_t alen;
+    uint32_t blen;
+    const char *astr = a.getStringAndLength(alen);
+    const char *bstr = b.getStringAndLength(blen);
     if (!astr && !bstr) {
         return true;
     }
     if ((!astr && bstr) || (astr && !bstr)) {
         return false;
     }
-    return strcmp(astr, bstr) == 0;
+    return alen == blen && memcmp(astr, bstr, alen) == 0;
 }
 
 static void STRING_value_to_text(const Value &value, char *text, int count) {
@@ -480,6 +453,25 @@ static const char *STRING_REF_value_type_name(const Value &value) {
     return "string";
 }
 
+static bool compare_STRING_SLICE_value(const Value &a, const Value &b) {
+	return compare_STRING_value(a, b);
+}
+
+static void STRING_SLICE_value_to_text(const Value &value, char *text, int count) {
+    uint32_t len;
+    const char *str = value.getStringAndLength(len);
+    if (str) {
+        stringCopyLength(text, count - 1, str, len);
+    } else {
+        text[0] = 0;
+    }
+}
+
+static const char *STRING_SLICE_value_type_name(const Value &value) {
+    EEZ_UNUSED(value);
+    return "string";
+}
+
 static bool compare_BLOB_REF_value(const Value &a, const Value &b) {
     return a.type == b.type && a.refValue == b.refValue;
 }
@@ -580,6 +572,32 @@ static void PROPERTY_REF_value_to_text(const Value &value, char *text, int count
         (void *)value.getPropertyRef()->flowState, value.getPropertyRef()->componentIndex, value.getPropertyRef()->propertyIndex);
 }
 
+static bool compare_TYPED_ARRAY_REF_value(const Value &a, const Value &b) {
+    return a.type == b.type && a.refValue == b.refValue;
+}
+
+static void TYPED_ARRAY_REF_value_to_text(const Value &value, char *text, int count) {
+    snprintf(text, count, "typed array (size=%d)", (int)value.getTypedArray()->size);
+}
+
+static const char *TYPED_ARRAY_REF_value_type_name(const Value &value) {
+    EEZ_UNUSED(value);
+    return "typed-array";
+}
+
+static bool compare_DATA_SOURCE_REF_value(const Value &a, const Value &b) {
+    return a.type == b.type && a.refValue == b.refValue;
+}
+
+static void DATA_SOURCE_REF_value_to_text(const Value &value, char *text, int count) {
+    snprintf(text, count, "data source (rows=%d)", (int)value.getDataSource()->getNumRows());
+}
+
+static const char *DATA_SOURCE_REF_value_type_name(const Value &value) {
+    EEZ_UNUSED(value);
+    return "data-source";
+}
+
 static bool compare_DATE_value(const Value &a, const Value &b) {
     return a.type == b.type && a.doubleValue == b.doubleValue;
 }
@@ -953,6 +971,43 @@ const char *Value::getString() const {
 	if (value.type == VALUE_TYPE_STRING) {
 		return value.strValue;
 	}
+	if (value.type == VALUE_TYPE_STRING_SLICE) {
+        auto sliceRef = (StringSliceRef *)value.refValue;
+        auto parentRef = (StringRef *)sliceRef->parent.refValue;
+        if (sliceRef->offset + sliceRef->len == parentRef->len) {
+            // tail of the parent string is already zero terminated
+            return parentRef->str + sliceRef->offset;
+        }
+        if (!sliceRef->str) {
+            sliceRef->str = (char *)alloc(sliceRef->len + 1, 0x7d41c2e9);
+            if (!sliceRef->str) {
+                return nullptr;
+            }
+            memcpy(sliceRef->str, parentRef->str + sliceRef->offset, sliceRef->len);
+            sliceRef->str[sliceRef->len] = 0;
+        }
+        return sliceRef->str;
+	}
+	return nullptr;
+}
+
+const char *Value::getStringAndLength(uint32_t &len) const {
+    auto value = getValue();
+	if (value.type == VALUE_TYPE_STRING_REF) {
+        auto stringRef = (StringRef *)value.refValue;
+        len = stringRef->len;
+		return stringRef->str;
+	}
+	if (value.type == VALUE_TYPE_STRING_SLICE) {
+        auto sliceRef = (StringSliceRef *)value.refValue;
+        len = sliceRef->len;
+        return ((StringRef *)sliceRef->parent.refValue)->str + sliceRef->offset;
+	}
+	if (value.type == VALUE_TYPE_STRING && value.strValue) {
+        len = strlen(value.strValue);
+		return value.strValue;
+	}
+    len = 0;
 	return nullptr;
 }
 
@@ -1394,6 +1449,10 @@ Value Value::makeStringRef(const char *str, int len, uint32_t id) {
     stringCopyLength(stringRef->str, len + 1, str, len);
 	stringRef->str[len] = 0;
 
+    // str can be shorter than len
+    auto end = (const char *)memchr(stringRef->str, 0, len);
+    stringRef->len = end ? end - stringRef->str : len;
+
     stringRef->refCounter = 1;
 
     Value value;
@@ -1405,21 +1464,20 @@ Value Value::makeStringRef(const char *str, int len, uint32_t id) {
 	return value;
 }
 
-Value Value::concatenateString(const Value &str1, const Value &str2) {
-    auto stringRef = ObjectAllocator<StringRef>::allocate(0xbab14c6a);;
+Value Value::makeUninitializedStringRef(uint32_t len, uint32_t id) {
+    auto stringRef = ObjectAllocator<StringRef>::allocate(id);
 	if (stringRef == nullptr) {
 		return Value(0, VALUE_TYPE_NULL);
 	}
 
-    auto newStrLen = strlen(str1.getString()) + strlen(str2.getString()) + 1;
-    stringRef->str = (char *)alloc(newStrLen, 0xb5320162);
+    stringRef->str = (char *)alloc(len + 1, id + 1);
     if (stringRef->str == nullptr) {
         ObjectAllocator<StringRef>::deallocate(stringRef);
         return Value(0, VALUE_TYPE_NULL);
     }
 
-    stringCopy(stringRef->str, newStrLen, str1.getString());
-    stringAppendString(stringRef->str, newStrLen, str2.getString());
+	stringRef->str[len] = 0;
+    stringRef->len = len;
 
     stringRef->refCounter = 1;
 
@@ -1432,6 +1490,87 @@ Value Value::concatenateString(const Value &str1, const Value &str2) {
 	return value;
 }
 
+Value Value::makeStringSlice(const Value &str, uint32_t offset, uint32_t len, uint32_t id) {
+    auto value = str.getValue();
+
+    if (value.type == VALUE_TYPE_STRING_SLICE) {
+        // slice of the slice references the same parent
+        auto sliceRef = (StringSliceRef *)value.refValue;
+        if (offset > sliceRef->len) {
+            offset = sliceRef->len;
+        }
+        if (len > sliceRef->len - offset) {
+            len = sliceRef->len - offset;
+        }
+        return makeStringSlice(sliceRef->parent, sliceRef->offset + offset, len, id);
+    }
+
+    uint32_t strLen;
+    const char *strBytes = value.getStringAndLength(strLen);
+    if (!strBytes) {
+        return Value(0, VALUE_TYPE_NULL);
+    }
+
+    if (offset > strLen) {
+        offset = strLen;
+    }
+    if (len > strLen - offset) {
+        len = strLen - offset;
+    }
+
+    // here value is never a slice, so the slice always references the root STRING_REF
+    if (value.type != VALUE_TYPE_STRING_REF) {
+        // only ref counted strings can be shared
+        return makeStringRef(strBytes + offset, len, id);
+    }
+
+    if (offset == 0 && len == strLen) {
+        return value;
+    }
+
+    auto sliceRef = ObjectAllocator<StringSliceRef>::allocate(id);
+    if (sliceRef == nullptr) {
+        return Value(0, VALUE_TYPE_NULL);
+    }
+
+    sliceRef->parent = value;
+    sliceRef->offset = offset;
+    sliceRef->len = len;
+    sliceRef->str = nullptr;
+
+    sliceRef->refCounter = 1;
+
+    Value result;
+
+    result.type = VALUE_TYPE_STRING_SLICE;
+    result.options = VALUE_OPTIONS_REF;
+    result.refValue = sliceRef;
+
+	return result;
+}
+
+Value Value::concatenateString(const Value &str1, const Value &str2) {
+    uint32_t len1;
+    uint32_t len2;
+    auto s1 = str1.getStringAndLength(len1);
+    auto s2 = str2.getStringAndLength(len2);
+
+    auto value = makeUninitializedStringRef(len1 + len2, 0xbab14c6a);
+    if (value.type == VALUE_TYPE_NULL) {
+        return value;
+    }
+
+    auto stringRef = (StringRef *)value.refValue;
+    if (len1 > 0) {
+        memcpy(stringRef->str, s1, len1);
+    }
+    if (len2 > 0) {
+        memcpy(stringRef->str + len1, s2, len2);
+    }
+
+	return value;
+}
+
 Value Value::makeArrayRef(int arraySize, int arrayType, uint32_t id) {
     auto ptr = alloc(sizeof(ArrayValueRef) + (arraySize > 0 ? arraySize - 1 : 0) * sizeof(Value), id);
 	if (ptr == nullptr) {
@@ -1553,6 +1692,95 @@ Value Value::makeBlobRef(const uint8_t *blob1, uint32_t len1, const uint8_t *blo
 	return value;
 }
 
+Value Value::makeTypedArrayRef(TypedArrayElementType elementType, uint32_t size, const void *data, uint32_t id) {
+    if (size > UINT32_MAX / getTypedArrayElementSize(elementType)) {
+        return Value(0, VALUE_TYPE_NULL);
+    }
+
+    auto typedArrayRef = ObjectAllocator<TypedArrayRef>::allocate(id);
+	if (typedArrayRef == nullptr) {
+		return Value(0, VALUE_TYPE_NULL);
+	}
+
+    auto len = size * getTypedArrayElementSize(elementType);
+
+	typedArrayRef->data = alloc(len > 0 ? len : 1, id + 1);
+    if (typedArrayRef->data == nullptr) {
+        ObjectAllocator<TypedArrayRef>::deallocate(typedArrayRef);
+        return Value(0, VALUE_TYPE_NULL);
+    }
+    typedArrayRef->elementType = elementType;
+    typedArrayRef->size = size;
+
+    if (data) {
+        memcpy(typedArrayRef->data, data, len);
+    } else {
+        memset(typedArrayRef->data, 0, len);
+    }
+
+    typedArrayRef->refCounter = 1;
+
+    Value value;
+
+    value.type = VALUE_TYPE_TYPED_ARRAY_REF;
+    value.options = VALUE_OPTIONS_REF;
+    value.refValue = typedArrayRef;
+
+	return value;
+}
+
+Value TypedArrayRef::getElement(uint32_t elementIndex) const {
+    if (elementIndex >= size) {
+        return Value();
+    }
+    if (elementType == TYPED_ARRAY_ELEMENT_TYPE_FLOAT) {
+        return Value(((float *)data)[elementIndex], VALUE_TYPE_FLOAT);
+    }
+    if (elementType == TYPED_ARRAY_ELEMENT_TYPE_DOUBLE) {
+        return Value(((double *)data)[elementIndex], VALUE_TYPE_DOUBLE);
+    }
+    if (elementType == TYPED_ARRAY_ELEMENT_TYPE_INT32) {
+        return Value((int)((int32_t *)data)[elementIndex], VALUE_TYPE_INT32);
+    }
+    return Value((uint32_t)((uint8_t *)data)[elementIndex], VALUE_TYPE_UINT32);
+}
+
+bool TypedArrayRef::setElement(uint32_t elementIndex, const Value &value) {
+    if (elementIndex >= size) {
+        return false;
+    }
+
+    int err;
+
+    if (elementType == TYPED_ARRAY_ELEMENT_TYPE_FLOAT) {
+        float elementValue = value.toFloat(&err);
+        if (err) {
+            return false;
+        }
+        ((float *)data)[elementIndex] = elementValue;
+    } else if (elementType == TYPED_ARRAY_ELEMENT_TYPE_DOUBLE) {
+        double elementValue = value.toDouble(&err);
+        if (err) {
+            return false;
+        }
+        ((double *)data)[elementIndex] = elementValue;
+    } else if (elementType == TYPED_ARRAY_ELEMENT_TYPE_INT32) {
+        int32_t elementValue = value.toInt32(&err);
+        if (err) {
+            return false;
+        }
+        ((int32_t *)data)[elementIndex] = elementValue;
+    } else {
+        int32_t elementValue = value.toInt32(&err);
+        if (err || elementValue < 0 || elementValue > 255) {
+            return false;
+        }
+        ((uint8_t *)data)[elementIndex] = (uint8_t)elementValue;
+    }
+
+    return true;
+}
+
 #if defined(EEZ_FOR_LVGL)
 Value Value::makeLVGLEventRef(uint32_t code, void *currentTarget, void *target, int32_t userData, uint32_t key, int32_t gestureDir, int32_t rotaryDiff, uint32_t id) {
     auto lvglEventRef = ObjectAllocator<LVGLEventRef>::allocate(id);
@@ -1624,7 +1852,12 @@ Value Value::clone() {
 
         return resultArrayValue;
     } else if (isString()) {
-        return makeStringRef(getString(), -1, 0x91846ff3);
+        uint32_t len;
+        auto str = getStringAndLength(len);
+        return makeStringRef(str, len, 0x91846ff3);
+    } else if (isTypedArray()) {
+        auto typedArrayRef = getTypedArray();
+        return makeTypedArrayRef((TypedArrayElementType)typedArrayRef->elementType, typedArrayRef->size, typedArrayRef->data, 0x3c1e5a0b);
     }
 
     return *this;
@@ -95,8 +95,18 @@ struct Ref {
 struct ArrayValue;
 struct ArrayElementValue;
 struct BlobRef;
+struct TypedArrayRef;
+struct DataSource;
+struct DataSourceRef;
 struct PropertyRef;
 
+enum TypedArrayElementType {
+    TYPED_ARRAY_ELEMENT_TYPE_FLOAT,
+    TYPED_ARRAY_ELEMENT_TYPE_DOUBLE,
+    TYPED_ARRAY_ELEMENT_TYPE_INT32,
+    TYPED_ARRAY_ELEMENT_TYPE_UINT8
+};
+
 #if defined(EEZ_FOR_LVGL)
 struct LVGLEventRef;
 #endif
@@ -369,7 +379,7 @@ struct Value {
 	}
 
 	bool isString() const {
-        return type == VALUE_TYPE_STRING || type == VALUE_TYPE_STRING_ASSET || type == VALUE_TYPE_STRING_REF;
+        return type == VALUE_TYPE_STRING || type == VALUE_TYPE_STRING_ASSET || type == VALUE_TYPE_STRING_REF || type == VALUE_TYPE_STRING_SLICE;
     }
 
     bool isArray() const {
@@ -380,6 +390,14 @@ struct Value {
         return type == VALUE_TYPE_BLOB_REF;
     }
 
+	bool isTypedArray() const {
+        return type == VALUE_TYPE_TYPED_ARRAY_REF;
+    }
+
+	bool isDataSource() const {
+        return type == VALUE_TYPE_DATA_SOURCE_REF;
+    }
+
 	bool isJson() const {
         return type == VALUE_TYPE_JSON;
     }
@@ -441,6 +459,9 @@ struct Value {
 	}
 
 	const char *getString() const;
+    // Returns string bytes and its length in bytes. Unlike getString this doesn't
+    // copy the string slice, so the returned string is not always zero terminated.
+    const char *getStringAndLength(uint32_t &len) const;
 
     const ArrayValue *getArray() const;
     ArrayValue *getArray();
@@ -503,6 +524,14 @@ struct Value {
         return (BlobRef *)refValue;
     }
 
+    TypedArrayRef *getTypedArray() const {
+        return (TypedArrayRef *)refValue;
+    }
+
+    DataSourceRef *getDataSource() const {
+        return (DataSourceRef *)refValue;
+    }
+
     void *getWidget() {
         return pVoidValue;
     }
@@ -539,6 +568,10 @@ struct Value {
 	Value toString(uint32_t id) const;
 
 	static Value makeStringRef(const char *str, int len, uint32_t id);
+    // string of len bytes, caller must fill the content
+    static Value makeUninitializedStringRef(uint32_t len, uint32_t id);
+    // substring [offset, offset + len) of str, shares the bytes with the str
+    static Value makeStringSlice(const Value &str, uint32_t offset, uint32_t len, uint32_t id);
 	static Value concatenateString(const Value &str1, const Value &str2);
 
     static Value makeArrayRef(int arraySize, int arrayType, uint32_t id);
@@ -548,6 +581,12 @@ struct Value {
     static Value makeBlobRef(const uint8_t *blob, uint32_t len, uint32_t id);
     static Value makeBlobRef(const uint8_t *blob1, uint32_t len1, const uint8_t *blob2, uint32_t len2, uint32_t id);
 
+    // if data is nullptr, elements are set to zero
+    static Value makeTypedArrayRef(TypedArrayElementType elementType, uint32_t size, const void *data, uint32_t id);
+
+    // see DataSourceRef in eez/core/data_source.h
+    static Value makeDataSourceRef(DataSource *dataSource, uint32_t id);
+
 #if defined(EEZ_FOR_LVGL)
     static Value makeLVGLEventRef(uint32_t code, void *currentTarget, void *target, int32_t userData, uint32_t key, int32_t gestureDir, int32_t rotaryDiff, uint32_t id);
 #endif
@@ -608,6 +647,19 @@ struct StringRef : public Ref {
         }
     }
 	char *str;
+    uint32_t len; // in bytes, without terminating zero
+};
+
+struct StringSliceRef : public Ref {
+    ~StringSliceRef() {
+        if (str) {
+            eez::free(str);
+        }
+    }
+    Value parent; // VALUE_TYPE_STRING_REF
+    uint32_t offset;
+    uint32_t len;
+    char *str; // zero terminated copy, created by getString on demand
 };
 
 struct ArrayValue {
@@ -631,6 +683,28 @@ struct BlobRef : public Ref {
     uint32_t len;
 };
 
+// Packed array of numbers, i.e. without Value per element, which is used for
+// the large arrays of samples. Elements are converted to/from Value only when
+// accessed from the flow (ARRAY_ELEMENT, assignment, debugger).
+struct TypedArrayRef : public Ref {
+    ~TypedArrayRef() {
+        if (data) {
+            eez::free(data);
+        }
+    }
+
+    uint8_t elementType;
+    uint32_t size;
+    void *data;
+
+    Value getElement(uint32_t elementIndex) const;
+    bool setElement(uint32_t elementIndex, const Value &value);
+};
+
+inline uint32_t getTypedArrayElementSize(uint8_t elementType) {
+    return elementType == TYPED_ARRAY_ELEMENT_TYPE_DOUBLE ? 8 : elementType == TYPED_ARRAY_ELEMENT_TYPE_UINT8 ? 1 : 4;
+}
+
 #if defined(EEZ_FOR_LVGL)
 struct LVGLEventRef : public Ref {
 	uint32_t code;
@@ -698,6 +772,12 @@ inline Value Value::getValue() const {
                 return Value();
             }
             return Value((uint32_t)blobRef->blob[arrayElementValue->elementIndex], VALUE_TYPE_UINT32);
+        } else if (arrayElementValue->arrayValue.isTypedArray()) {
+            auto typedArrayRef = arrayElementValue->arrayValue.getTypedArray();
+            if (arrayElementValue->elementIndex < 0 || arrayElementValue->elementIndex >= (int)typedArrayRef->size) {
+                return Value();
+            }
+            return typedArrayRef->getElement(arrayElementValue->elementIndex);
         } else {
             auto array = arrayElementValue->arrayValue.getArray();
 
@@ -52,6 +52,9 @@
     VALUE_TYPE(JSON_MEMBER_VALUE)                  /* 36 */ \
     VALUE_TYPE(EVENT)                              /* 37 */ \
     VALUE_TYPE(PROPERTY_REF)                       /* 38 */ \
+    VALUE_TYPE(TYPED_ARRAY_REF)                    /* 39 */ \
+    VALUE_TYPE(DATA_SOURCE_REF)                    /* 40 */ \
+    VALUE_TYPE(STRING_SLICE)                       /* 41 */ \
     CUSTOM_VALUE_TYPES
 
 namespace eez {
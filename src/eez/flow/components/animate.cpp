@@ -10,14 +10,17 @@
 
 #include <eez/conf-internal.h>
 
+#include <math.h>
+
 #include <eez/core/os.h>
 
 #include <eez/flow/components.h>
 #include <eez/flow/flow_defs_v3.h>
 #include <eez/flow/expression.h>
 #include <eez/flow/private.h>
-#include <eez/flow/queue.h>
+#include <eez/flow/timer_wheel.h>
 #include <eez/flow/debugger.h>
+#include <eez/flow/snapshot.h>
 
 #if EEZ_OPTION_GUI
 #include <eez/gui/gui.h>
@@ -27,13 +30,27 @@ using namespace eez::gui;
 namespace eez {
 namespace flow {
 
+#if !defined(EEZ_FLOW_ANIMATE_FRAME_PERIOD_MS)
+#define EEZ_FLOW_ANIMATE_FRAME_PERIOD_MS 16
+#endif
+static const uint32_t ANIMATE_FRAME_PERIOD_MS = EEZ_FLOW_ANIMATE_FRAME_PERIOD_MS;
+
 struct AnimateComponenentExecutionState : public ComponenentExecutionState {
     float startPosition;
     float endPosition;
     float speed;
     uint32_t startTimestamp;
+    uint32_t endTimestamp;
 };
 
+static bool scheduleNextFrame(FlowState *flowState, unsigned componentIndex, AnimateComponenentExecutionState *state) {
+    uint32_t deadline = millis() + ANIMATE_FRAME_PERIOD_MS;
+    if ((int32_t)(deadline - state->endTimestamp) > 0) {
+        deadline = state->endTimestamp;
+    }
+    return addTimer(flowState, componentIndex, deadline) != nullptr;
+}
+
 void executeAnimateComponent(FlowState *flowState, unsigned componentIndex) {
     FlowState *timelineFlowState = flowState;
     while (timelineFlowState->isAction && timelineFlowState->parentFlowState) {
@@ -61,7 +78,22 @@ void executeAnimateComponent(FlowState *flowState, unsigned componentIndex) {
         float to = toValue.toFloat();
         float speed = speedValue.toFloat();
 
-        if (speed == 0) {
+        if (!isfinite(from)) {
+            throwError(flowState, componentIndex, FlowError::PropertyInvalid("Animate", "From"));
+            return;
+        }
+
+        if (!isfinite(to)) {
+            throwError(flowState, componentIndex, FlowError::PropertyInvalid("Animate", "To"));
+            return;
+        }
+
+        if (isnan(speed)) {
+            throwError(flowState, componentIndex, FlowError::PropertyInvalid("Animate", "Speed"));
+            return;
+        }
+
+        if (speed == 0 || isinf(speed)) {
             timelineFlowState->timelinePosition = to;
             onFlowStateTimelineChanged(flowState);
 
@@ -74,7 +106,11 @@ void executeAnimateComponent(FlowState *flowState, unsigned componentIndex) {
             state->speed = speed;
             state->startTimestamp = millis();
 
-            if (!addToQueue(flowState, componentIndex, -1, -1, -1, true)) {
+            // timer deadlines are compared as int32_t, so the duration is clamped to INT32_MAX ms (~24 days)
+            double duration = ceil(fabs((double)to - (double)from) * 1000.0 / fabs((double)speed));
+            state->endTimestamp = state->startTimestamp + (duration < INT32_MAX ? (uint32_t)duration : (uint32_t)INT32_MAX);
+
+            if (!scheduleNextFrame(flowState, componentIndex, state)) {
                 return;
             }
         }
@@ -100,12 +136,35 @@ void executeAnimateComponent(FlowState *flowState, unsigned componentIndex) {
             deallocateComponentExecutionState(flowState, componentIndex);
             propagateValueThroughSeqout(flowState, componentIndex);
         } else {
-            if (!addToQueue(flowState, componentIndex, -1, -1, -1, true)) {
+            if (!scheduleNextFrame(flowState, componentIndex, state)) {
                 return;
             }
         }
     }
 }
 
+// timestamps are stored relative to millis(), timer of the next frame is restored by the snapshot
+bool snapshotAnimateComponentExecutionState(SnapshotWriter &writer, FlowState *flowState, unsigned componentIndex) {
+    auto state = (AnimateComponenentExecutionState *)flowState->componenentExecutionStates[componentIndex];
+    writer.writeFloat(state->startPosition);
+    writer.writeFloat(state->endPosition);
+    writer.writeFloat(state->speed);
+    writer.writeUint32(millis() - state->startTimestamp);
+    writer.writeUint32(state->endTimestamp - state->startTimestamp);
+    return true;
+}
+
+bool restoreAnimateComponentExecutionState(SnapshotReader &reader, FlowState *flowState, unsigned componentIndex) {
+    auto state = allocateComponentExecutionState<AnimateComponenentExecutionState>(flowState, componentIndex);
+    state->startPosition = reader.readFloat();
+    state->endPosition = reader.readFloat();
+    state->speed = reader.readFloat();
+    auto elapsed = reader.readUint32();
+    auto duration = reader.readUint32();
+    state->startTimestamp = millis() - elapsed;
+    state->endTimestamp = state->startTimestamp + duration;
+    return !reader.failed;
+}
+
 } // namespace flow
 } // namespace eez
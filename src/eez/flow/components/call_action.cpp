@@ -19,20 +19,18 @@
 #include <eez/flow/debugger.h>
 #include <eez/flow/queue.h>
 #include <eez/flow/expression.h>
+#include <eez/flow/context.h>
 
 namespace eez {
 namespace flow {
 
-FlowState *g_executeActionFlowState;
-unsigned g_executeActionComponentIndex;
-
 void executeCallAction(FlowState *flowState, unsigned componentIndex, int flowIndex, const Value& inputValue) {
     // if componentIndex == -1 then execute flow at flowIndex without CallAction component
 
 	if (flowIndex >= (int)flowState->assets->flowDefinition->flows.count) {
         // native action
-        g_executeActionFlowState = flowState;
-        g_executeActionComponentIndex = componentIndex;
+        g_flowContext->executeActionFlowState = flowState;
+        g_flowContext->executeActionComponentIndex = componentIndex;
 
 		executeActionFunction(flowIndex - flowState->assets->flowDefinition->flows.count);
 
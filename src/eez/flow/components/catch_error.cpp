@@ -13,6 +13,7 @@
 #include <eez/flow/components.h>
 #include <eez/flow/flow_defs_v3.h>
 #include <eez/flow/expression.h>
+#include <eez/flow/snapshot.h>
 
 namespace eez {
 namespace flow {
@@ -24,5 +25,15 @@ void executeCatchErrorComponent(FlowState *flowState, unsigned componentIndex) {
 	propagateValueThroughSeqout(flowState, componentIndex);
 }
 
+bool snapshotCatchErrorComponentExecutionState(SnapshotWriter &writer, FlowState *flowState, unsigned componentIndex) {
+	auto catchErrorComponentExecutionState = (CatchErrorComponenentExecutionState *)flowState->componenentExecutionStates[componentIndex];
+    return writer.writeValue(catchErrorComponentExecutionState->message);
+}
+
+bool restoreCatchErrorComponentExecutionState(SnapshotReader &reader, FlowState *flowState, unsigned componentIndex) {
+    auto catchErrorComponentExecutionState = allocateComponentExecutionState<CatchErrorComponenentExecutionState>(flowState, componentIndex);
+    return reader.readValue(catchErrorComponentExecutionState->message);
+}
+
 } // namespace flow
 } // namespace eez
@@ -14,6 +14,7 @@
 #include <eez/flow/flow_defs_v3.h>
 #include <eez/flow/expression.h>
 #include <eez/flow/operations.h>
+#include <eez/flow/snapshot.h>
 
 namespace eez {
 namespace flow {
@@ -45,5 +46,17 @@ void executeCounterComponent(FlowState *flowState, unsigned componentIndex) {
     }
 }
 
+bool snapshotCounterComponentExecutionState(SnapshotWriter &writer, FlowState *flowState, unsigned componentIndex) {
+    auto counterComponenentExecutionState = (CounterComponenentExecutionState *)flowState->componenentExecutionStates[componentIndex];
+    writer.writeInt32(counterComponenentExecutionState->counter);
+    return true;
+}
+
+bool restoreCounterComponentExecutionState(SnapshotReader &reader, FlowState *flowState, unsigned componentIndex) {
+    auto counterComponenentExecutionState = allocateComponentExecutionState<CounterComponenentExecutionState>(flowState, componentIndex);
+    counterComponenentExecutionState->counter = reader.readInt32();
+    return !reader.failed;
+}
+
 } // namespace flow
 } // namespace eez
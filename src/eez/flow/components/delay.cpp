@@ -17,7 +17,8 @@
 #include <eez/flow/components.h>
 #include <eez/flow/flow_defs_v3.h>
 #include <eez/flow/expression.h>
-#include <eez/flow/queue.h>
+#include <eez/flow/timer_wheel.h>
+#include <eez/flow/snapshot.h>
 
 namespace eez {
 namespace flow {
@@ -44,20 +45,33 @@ void executeDelayComponent(FlowState *flowState, unsigned componentIndex) {
 			return;
 		}
 
-		if (!addToQueue(flowState, componentIndex, -1, -1, -1, true)) {
+		if (!addTimer(flowState, componentIndex, delayComponentExecutionState->waitUntil)) {
 			return;
 		}
 	} else {
-		if (millis() >= delayComponentExecutionState->waitUntil) {
+		if ((int32_t)(millis() - delayComponentExecutionState->waitUntil) >= 0) {
 			deallocateComponentExecutionState(flowState, componentIndex);
 			propagateValueThroughSeqout(flowState, componentIndex);
 		} else {
-			if (!addToQueue(flowState, componentIndex, -1, -1, -1, true)) {
+			if (!addTimer(flowState, componentIndex, delayComponentExecutionState->waitUntil)) {
 				return;
 			}
 		}
 	}
 }
 
+// time is stored relative to millis(), timer itself is restored by the snapshot
+bool snapshotDelayComponentExecutionState(SnapshotWriter &writer, FlowState *flowState, unsigned componentIndex) {
+	auto delayComponentExecutionState = (DelayComponenentExecutionState *)flowState->componenentExecutionStates[componentIndex];
+	writer.writeInt32((int32_t)(delayComponentExecutionState->waitUntil - millis()));
+	return true;
+}
+
+bool restoreDelayComponentExecutionState(SnapshotReader &reader, FlowState *flowState, unsigned componentIndex) {
+	auto delayComponentExecutionState = allocateComponentExecutionState<DelayComponenentExecutionState>(flowState, componentIndex);
+	delayComponentExecutionState->waitUntil = millis() + reader.readInt32();
+	return !reader.failed;
+}
+
 } // namespace flow
 } // namespace eez
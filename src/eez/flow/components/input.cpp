@@ -15,6 +15,7 @@
 #include <eez/flow/components/input.h>
 #include <eez/flow/components/call_action.h>
 #include <eez/flow/flow_defs_v3.h>
+#include <eez/flow/snapshot.h>
 
 namespace eez {
 namespace flow {
@@ -77,5 +78,15 @@ void executeInputComponent(FlowState *flowState, unsigned componentIndex) {
     }
 }
 
+bool snapshotInputComponentExecutionState(SnapshotWriter &writer, FlowState *flowState, unsigned componentIndex) {
+    auto inputActionComponentExecutionState = (InputActionComponentExecutionState *)flowState->componenentExecutionStates[componentIndex];
+    return writer.writeValue(inputActionComponentExecutionState->value);
+}
+
+bool restoreInputComponentExecutionState(SnapshotReader &reader, FlowState *flowState, unsigned componentIndex) {
+    auto inputActionComponentExecutionState = allocateComponentExecutionState<InputActionComponentExecutionState>(flowState, componentIndex);
+    return reader.readValue(inputActionComponentExecutionState->value);
+}
+
 } // namespace flow
 } // namespace eez
@@ -180,6 +180,22 @@ void executeLineChartWidgetComponent(FlowState *flowState, unsigned componentInd
             if (updated) {
                 executionState->updated = true;
             }
+        } else if (inputValue.isTypedArray()) {
+            auto typedArrayRef = inputValue.getTypedArray();
+            bool updated = false;
+            executionState->startPointIndex = 0;
+            executionState->numPoints = 0;
+            for (uint32_t elementIndex = 0; elementIndex < typedArrayRef->size; elementIndex++) {
+                flowState->values[valueInputIndexInFlow] = typedArrayRef->getElement(elementIndex);
+                if (executionState->onInputValue(flowState, componentIndex)) {
+                    updated = true;
+                } else {
+                    break;
+                }
+            }
+            if (updated) {
+                executionState->updated = true;
+            }
         } else {
             if (executionState->onInputValue(flowState, componentIndex)) {
                 executionState->updated = true;
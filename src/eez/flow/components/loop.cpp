@@ -14,6 +14,7 @@
 #include <eez/flow/flow_defs_v3.h>
 #include <eez/flow/expression.h>
 #include <eez/flow/operations.h>
+#include <eez/flow/snapshot.h>
 
 namespace eez {
 namespace flow {
@@ -105,5 +106,21 @@ void executeLoopComponent(FlowState *flowState, unsigned componentIndex) {
     }
 }
 
+bool snapshotLoopComponentExecutionState(SnapshotWriter &writer, FlowState *flowState, unsigned componentIndex) {
+    auto loopComponentExecutionState = (LoopComponenentExecutionState *)flowState->componenentExecutionStates[componentIndex];
+    return
+        writer.writeValue(loopComponentExecutionState->dstValue) &&
+        writer.writeValue(loopComponentExecutionState->toValue) &&
+        writer.writeValue(loopComponentExecutionState->currentValue);
+}
+
+bool restoreLoopComponentExecutionState(SnapshotReader &reader, FlowState *flowState, unsigned componentIndex) {
+    auto loopComponentExecutionState = allocateComponentExecutionState<LoopComponenentExecutionState>(flowState, componentIndex);
+    return
+        reader.readValue(loopComponentExecutionState->dstValue) &&
+        reader.readValue(loopComponentExecutionState->toValue) &&
+        reader.readValue(loopComponentExecutionState->currentValue);
+}
+
 } // namespace flow
 } // namespace eez
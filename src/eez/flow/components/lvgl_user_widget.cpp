@@ -20,6 +20,7 @@
 #include <eez/flow/debugger.h>
 #include <eez/flow/components/input.h>
 #include <eez/flow/components/lvgl_user_widget.h>
+#include <eez/flow/snapshot.h>
 
 #if defined(EEZ_FOR_LVGL)
 
@@ -52,6 +53,27 @@ LVGLUserWidgetExecutionState *createUserWidgetFlowState(FlowState *flowState, un
     return userWidgetWidgetExecutionState;
 }
 
+// user widget flow state is already in the snapshot as the child flow state
+bool snapshotLVGLUserWidgetComponentExecutionState(SnapshotWriter &writer, FlowState *flowState, unsigned componentIndex) {
+    // child flow state is restored from the flow states list
+    EEZ_UNUSED(writer);
+    EEZ_UNUSED(flowState);
+    EEZ_UNUSED(componentIndex);
+    return true;
+}
+
+bool restoreLVGLUserWidgetComponentExecutionState(SnapshotReader &reader, FlowState *flowState, unsigned componentIndex) {
+    EEZ_UNUSED(reader);
+    for (auto childFlowState = flowState->firstChild; childFlowState; childFlowState = childFlowState->nextSibling) {
+        if (childFlowState->parentComponentIndex == (int)componentIndex) {
+            auto userWidgetWidgetExecutionState = allocateComponentExecutionState<LVGLUserWidgetExecutionState>(flowState, componentIndex);
+            userWidgetWidgetExecutionState->flowState = childFlowState;
+            return true;
+        }
+    }
+    return false;
+}
+
 void executeLVGLUserWidgetComponent(FlowState *flowState, unsigned componentIndex) {
     //auto component = (LVGLUserWidgetComponent *)flowState->flow->components[componentIndex];
 
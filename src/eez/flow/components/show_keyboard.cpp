@@ -52,24 +52,38 @@ void executeShowKeyboardComponent(FlowState *flowState, unsigned componentIndex)
         return;
     }
 
-	static FlowState *g_showKeyboardFlowState;
+	static FlowStateHandle g_showKeyboardFlowStateHandle;
 	static unsigned g_showKeyboardComponentIndex;
 
-	g_showKeyboardFlowState = flowState;
+	g_showKeyboardFlowStateHandle = flowState->handle;
 	g_showKeyboardComponentIndex = componentIndex;
 
 	startAsyncExecution(flowState, componentIndex);
 
 	auto onOk = [](char *value) {
-		propagateValue(g_showKeyboardFlowState, g_showKeyboardComponentIndex, 0, Value::makeStringRef(value, -1, 0x87d32fe2));
+		auto flowState = getFlowStateFromHandle(g_showKeyboardFlowStateHandle);
+		if (!flowState) {
+			// flow state was freed in the meantime
+			getAppContextFromId(APP_CONTEXT_ID_DEVICE)->popPage();
+			return;
+		}
+
+		propagateValue(flowState, g_showKeyboardComponentIndex, 0, Value::makeStringRef(value, -1, 0x87d32fe2));
 		getAppContextFromId(APP_CONTEXT_ID_DEVICE)->popPage();
-		endAsyncExecution(g_showKeyboardFlowState, g_showKeyboardComponentIndex);
+		endAsyncExecution(flowState, g_showKeyboardComponentIndex);
 	};
 
 	auto onCancel = []() {
-		propagateValue(g_showKeyboardFlowState, g_showKeyboardComponentIndex, 1);
+		auto flowState = getFlowStateFromHandle(g_showKeyboardFlowStateHandle);
+		if (!flowState) {
+			// flow state was freed in the meantime
+			getAppContextFromId(APP_CONTEXT_ID_DEVICE)->popPage();
+			return;
+		}
+
+		propagateValue(flowState, g_showKeyboardComponentIndex, 1);
 		getAppContextFromId(APP_CONTEXT_ID_DEVICE)->popPage();
-		endAsyncExecution(g_showKeyboardFlowState, g_showKeyboardComponentIndex);
+		endAsyncExecution(flowState, g_showKeyboardComponentIndex);
 	};
 
 	const char *label = labelValue.getString();
@@ -55,24 +55,31 @@ void executeShowKeypadComponent(FlowState *flowState, unsigned componentIndex) {
         return;
     }
 
-	static FlowState *g_showKeyboardFlowState;
+	static FlowStateHandle g_showKeyboardFlowStateHandle;
 	static unsigned g_showKeyboardComponentIndex;
 
-	g_showKeyboardFlowState = flowState;
+	g_showKeyboardFlowStateHandle = flowState->handle;
 	g_showKeyboardComponentIndex = componentIndex;
 
 	startAsyncExecution(flowState, componentIndex);
 
 	auto onOk = [](float value) {
+		auto flowState = getFlowStateFromHandle(g_showKeyboardFlowStateHandle);
+		if (!flowState) {
+			// flow state was freed in the meantime
+			getAppContextFromId(APP_CONTEXT_ID_DEVICE)->popPage();
+			return;
+		}
+
         Value precisionValue;
-        if (!evalProperty(g_showKeyboardFlowState, g_showKeyboardComponentIndex, defs_v3::SHOW_KEYPAD_ACTION_COMPONENT_PROPERTY_PRECISION, precisionValue, FlowError::Property("ShowKeypad", "Precision"))) {
+        if (!evalProperty(flowState, g_showKeyboardComponentIndex, defs_v3::SHOW_KEYPAD_ACTION_COMPONENT_PROPERTY_PRECISION, precisionValue, FlowError::Property("ShowKeypad", "Precision"))) {
             return;
         }
 
         float precision = precisionValue.toFloat();
 
         Value unitValue;
-        if (!evalProperty(g_showKeyboardFlowState, g_showKeyboardComponentIndex, defs_v3::SHOW_KEYPAD_ACTION_COMPONENT_PROPERTY_UNIT, unitValue, FlowError::Property("ShowKeypad", "Unit"))) {
+        if (!evalProperty(flowState, g_showKeyboardComponentIndex, defs_v3::SHOW_KEYPAD_ACTION_COMPONENT_PROPERTY_UNIT, unitValue, FlowError::Property("ShowKeypad", "Unit"))) {
             return;
         }
 
@@ -80,15 +87,22 @@ void executeShowKeypadComponent(FlowState *flowState, unsigned componentIndex) {
 
         value = roundPrec(value, precision) / getUnitFactor(unit);
 
-		propagateValue(g_showKeyboardFlowState, g_showKeyboardComponentIndex, 0, Value(value, VALUE_TYPE_FLOAT));
+		propagateValue(flowState, g_showKeyboardComponentIndex, 0, Value(value, VALUE_TYPE_FLOAT));
 		getAppContextFromId(APP_CONTEXT_ID_DEVICE)->popPage();
-        endAsyncExecution(g_showKeyboardFlowState, g_showKeyboardComponentIndex);
+        endAsyncExecution(flowState, g_showKeyboardComponentIndex);
 	};
 
 	auto onCancel = []() {
-		propagateValue(g_showKeyboardFlowState, g_showKeyboardComponentIndex, 1);
+		auto flowState = getFlowStateFromHandle(g_showKeyboardFlowStateHandle);
+		if (!flowState) {
+			// flow state was freed in the meantime
+			getAppContextFromId(APP_CONTEXT_ID_DEVICE)->popPage();
+			return;
+		}
+
+		propagateValue(flowState, g_showKeyboardComponentIndex, 1);
 		getAppContextFromId(APP_CONTEXT_ID_DEVICE)->popPage();
-		endAsyncExecution(g_showKeyboardFlowState, g_showKeyboardComponentIndex);
+		endAsyncExecution(flowState, g_showKeyboardComponentIndex);
 	};
 
 
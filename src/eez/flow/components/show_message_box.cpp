@@ -16,6 +16,7 @@
 #include <eez/flow/components.h>
 #include <eez/flow/flow_defs_v3.h>
 #include <eez/flow/expression.h>
+#include <eez/flow/context.h>
 
 #include <eez/gui/gui.h>
 
@@ -35,12 +36,21 @@ struct ShowMessagePageComponentExecutionState : public ComponenentExecutionState
     unsigned componentIndex;
 };
 
-ShowMessagePageComponentExecutionState *g_executionState;
+// message box is shown by the GUI, which runs flow of the default context
+static ShowMessagePageComponentExecutionState *takeMessageBoxExecutionState() {
+    auto executionState = (ShowMessagePageComponentExecutionState *)g_flowContext->messageBoxExecutionState;
+    g_flowContext->messageBoxExecutionState = nullptr;
+    return executionState;
+}
 
 void infoMessageCallback() {
-    auto flowState = g_executionState->flowState;
-    auto componentIndex = g_executionState->componentIndex;
-    g_executionState = nullptr;
+    auto executionState = takeMessageBoxExecutionState();
+    if (!executionState) {
+        return;
+    }
+
+    auto flowState = executionState->flowState;
+    auto componentIndex = executionState->componentIndex;
 
     deallocateComponentExecutionState(flowState, componentIndex);
 
@@ -48,9 +58,13 @@ void infoMessageCallback() {
 }
 
 void errorMessageCallback(int userParam) {
-    auto flowState = g_executionState->flowState;
-    auto componentIndex = g_executionState->componentIndex;
-    g_executionState = nullptr;
+    auto executionState = takeMessageBoxExecutionState();
+    if (!executionState) {
+        return;
+    }
+
+    auto flowState = executionState->flowState;
+    auto componentIndex = executionState->componentIndex;
 
     deallocateComponentExecutionState(flowState, componentIndex);
 
@@ -85,10 +99,10 @@ void executeShowMessageBoxComponent(FlowState *flowState, unsigned componentInde
     executionState->componentIndex = componentIndex;
 
 	if (component->type == MESSAGE_BOX_TYPE_INFO) {
-        g_executionState = executionState;
+        g_flowContext->messageBoxExecutionState = executionState;
 		getAppContextFromId(APP_CONTEXT_ID_DEVICE)->infoMessage(messageValue.getString(), infoMessageCallback, "Close");
 	} else if (component->type == MESSAGE_BOX_TYPE_ERROR) {
-        g_executionState = executionState;
+        g_flowContext->messageBoxExecutionState = executionState;
 		getAppContextFromId(APP_CONTEXT_ID_DEVICE)->errorMessageWithAction(messageValue, errorMessageCallback, "Close", 0);
 	} else if (component->type == MESSAGE_BOX_TYPE_QUESTION) {
         Value buttonsValue;
@@ -16,18 +16,21 @@
 #include <eez/core/util.h>
 #include <eez/core/debug.h>
 #include <eez/core/utf8.h>
+#include <eez/core/typed_array.h>
 
 #include <eez/flow/components.h>
 #include <eez/flow/flow_defs_v3.h>
 #include <eez/flow/expression.h>
 #include <eez/flow/debugger.h>
+#include <eez/flow/context.h>
 
 #include <eez/flow/components/sort_array.h>
 
 namespace eez {
 namespace flow {
 
-SortArrayActionComponent *g_sortArrayActionComponent;
+// qsort has no user parameter, it is per thread because each thread can run its own flow context
+static EEZ_FLOW_THREAD_LOCAL SortArrayActionComponent *g_sortArrayActionComponent;
 
 static int elementCompare(const void *a, const void *b) {
     auto aValue = *(const Value *)a;
@@ -97,6 +100,13 @@ void executeSortArrayComponent(FlowState *flowState, unsigned componentIndex) {
         return;
     }
 
+    if (srcArrayValue.isTypedArray() && component->arrayType == -1) {
+        auto typedArrayValue = srcArrayValue.clone();
+        typedArraySort(typedArrayValue.getTypedArray(), component->flags & SORT_ARRAY_FLAG_ASCENDING ? true : false);
+        propagateValue(flowState, componentIndex, component->outputs.count - 1, typedArrayValue);
+        return;
+    }
+
     if (!srcArrayValue.isArray()) {
         throwError(flowState, componentIndex, FlowError::Plain("SortArray: not an array\n"));
         return;
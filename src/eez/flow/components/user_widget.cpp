@@ -24,6 +24,7 @@
 #include <eez/flow/flow_defs_v3.h>
 #include <eez/flow/components/call_action.h>
 #include <eez/flow/components/input.h>
+#include <eez/flow/snapshot.h>
 
 namespace eez {
 namespace flow {
@@ -65,6 +66,27 @@ FlowState *getUserWidgetFlowState(FlowState *flowState, uint16_t userWidgetWidge
     return userWidgetWidgetExecutionState->flowState;
 }
 
+// user widget flow state is already in the snapshot as the child flow state
+bool snapshotUserWidgetWidgetComponentExecutionState(SnapshotWriter &writer, FlowState *flowState, unsigned componentIndex) {
+    // child flow state is restored from the flow states list
+    EEZ_UNUSED(writer);
+    EEZ_UNUSED(flowState);
+    EEZ_UNUSED(componentIndex);
+    return true;
+}
+
+bool restoreUserWidgetWidgetComponentExecutionState(SnapshotReader &reader, FlowState *flowState, unsigned componentIndex) {
+    EEZ_UNUSED(reader);
+    for (auto childFlowState = flowState->firstChild; childFlowState; childFlowState = childFlowState->nextSibling) {
+        if (childFlowState->parentComponentIndex == (int)componentIndex) {
+            auto userWidgetWidgetExecutionState = allocateComponentExecutionState<UserWidgetWidgetExecutionState>(flowState, componentIndex);
+            userWidgetWidgetExecutionState->flowState = childFlowState;
+            return true;
+        }
+    }
+    return false;
+}
+
 void executeUserWidgetWidgetComponent(FlowState *flowState, unsigned componentIndex) {
     auto component = (UserWidgetWidgetComponent *)flowState->flow->components[componentIndex];
 
@@ -20,6 +20,7 @@
 #include <eez/flow/expression.h>
 #include <eez/flow/queue.h>
 #include <eez/flow/watch_list.h>
+#include <eez/flow/snapshot.h>
 
 namespace eez {
 namespace flow {
@@ -51,5 +52,19 @@ void executeWatchVariableComponent(FlowState *flowState, unsigned componentIndex
 	}
 }
 
+bool snapshotWatchVariableComponentExecutionState(SnapshotWriter &writer, FlowState *flowState, unsigned componentIndex) {
+	auto watchVariableComponentExecutionState = (WatchVariableComponenentExecutionState *)flowState->componenentExecutionStates[componentIndex];
+    return writer.writeValue(watchVariableComponentExecutionState->value);
+}
+
+bool restoreWatchVariableComponentExecutionState(SnapshotReader &reader, FlowState *flowState, unsigned componentIndex) {
+    auto watchVariableComponentExecutionState = allocateComponentExecutionState<WatchVariableComponenentExecutionState>(flowState, componentIndex);
+    if (!reader.readValue(watchVariableComponentExecutionState->value)) {
+        return false;
+    }
+    watchVariableComponentExecutionState->node = watchListAdd(flowState, componentIndex);
+    return true;
+}
+
 } // namespace flow
 } // namespace eez
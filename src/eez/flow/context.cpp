@@ -0,0 +1,102 @@
+/*
+ * eez-framework
+ *
+ * MIT License
+ * Copyright 2024 Envox d.o.o.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <eez/conf-internal.h>
+
+#include <new>
+
+#include <eez/core/alloc.h>
+
+#include <eez/flow/flow.h>
+#include <eez/flow/context.h>
+
+namespace eez {
+namespace flow {
+
+static FlowContext g_defaultFlowContext;
+
+EEZ_FLOW_THREAD_LOCAL FlowContext *g_flowContext = &g_defaultFlowContext;
+
+FlowContext *createFlowContext() {
+    auto flowContext = (FlowContext *)alloc(sizeof(FlowContext), 0x5c9a3e71);
+    if (!flowContext) {
+        return nullptr;
+    }
+    // value initialization, so inbox atomics start from zero like in the default context
+    return new (flowContext) FlowContext();
+}
+
+void destroyFlowContext(FlowContext *flowContext) {
+    if (!flowContext || flowContext == &g_defaultFlowContext) {
+        return;
+    }
+
+    auto previousFlowContext = setFlowContext(flowContext);
+    if (!isFlowStopped()) {
+        stop();
+        tick();
+    }
+    destroyAllSampleBuffers();
+    setFlowContext(previousFlowContext == flowContext ? &g_defaultFlowContext : previousFlowContext);
+
+    if (flowContext->globalVariables) {
+        for (uint32_t i = 0; i < flowContext->globalVariables->count; i++) {
+            (flowContext->globalVariables->values + i)->~Value();
+        }
+        free(flowContext->globalVariables);
+    }
+
+    if (flowContext->flowStateSlotTable.slots) {
+        free(flowContext->flowStateSlotTable.slots);
+    }
+
+    flowContext->~FlowContext();
+    free(flowContext);
+}
+
+FlowContext *getDefaultFlowContext() {
+    return &g_defaultFlowContext;
+}
+
+bool isDefaultFlowContext() {
+    return g_flowContext == &g_defaultFlowContext;
+}
+
+FlowContext *getFlowContext() {
+    return g_flowContext;
+}
+
+FlowContext *setFlowContext(FlowContext *flowContext) {
+    auto previousFlowContext = g_flowContext;
+    g_flowContext = flowContext ? flowContext : &g_defaultFlowContext;
+    return previousFlowContext;
+}
+
+unsigned start(FlowContext *flowContext, Assets *assets) {
+    auto previousFlowContext = setFlowContext(flowContext);
+    auto result = start(assets);
+    setFlowContext(previousFlowContext);
+    return result;
+}
+
+void tick(FlowContext *flowContext) {
+    auto previousFlowContext = setFlowContext(flowContext);
+    tick();
+    setFlowContext(previousFlowContext);
+}
+
+void stop(FlowContext *flowContext, Assets *assets) {
+    auto previousFlowContext = setFlowContext(flowContext);
+    stop(assets);
+    setFlowContext(previousFlowContext);
+}
+
+} // flow
+} // eez
@@ -0,0 +1,95 @@
+/*
+ * eez-framework
+ *
+ * MIT License
+ * Copyright 2024 Envox d.o.o.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <eez/flow/private.h>
+#include <eez/flow/expression.h>
+#include <eez/flow/queue.h>
+#include <eez/flow/watch_list.h>
+#include <eez/flow/timer_wheel.h>
+#include <eez/flow/sample_buffer.h>
+#include <eez/flow/inbox.h>
+#include <eez/flow/date.h>
+
+// Set to 1 to select the flow context per thread (see setFlowContext), so each thread can run
+// its own flow. Off by default because thread_local is not supported by some embedded toolchains.
+#if !defined(EEZ_FLOW_CONTEXT_THREAD_LOCAL)
+#if defined(EEZ_PLATFORM_SIMULATOR)
+#define EEZ_FLOW_CONTEXT_THREAD_LOCAL 1
+#else
+#define EEZ_FLOW_CONTEXT_THREAD_LOCAL 0
+#endif
+#endif
+
+#if EEZ_FLOW_CONTEXT_THREAD_LOCAL
+#define EEZ_FLOW_THREAD_LOCAL thread_local
+#else
+#define EEZ_FLOW_THREAD_LOCAL
+#endif
+
+namespace eez {
+namespace flow {
+
+static const uint32_t NO_FREE_FLOW_STATE_SLOT = 0xFFFFFFFF;
+
+struct FlowStateSlot;
+
+struct FlowStateSlotTable {
+    FlowStateSlot *slots = nullptr;
+    uint32_t numSlots = 0;
+    uint32_t firstFreeSlotIndex = NO_FREE_FLOW_STATE_SLOT;
+    uint32_t lastFreeSlotIndex = NO_FREE_FLOW_STATE_SLOT;
+};
+
+// Complete runtime state of one flow engine instance. Engine functions work on the current
+// context (g_flowContext), by default it is the process-wide context used by start(), tick()
+// and stop() without context argument.
+struct FlowContext {
+    bool isStopping = false;
+    bool isStopped = true;
+    unsigned tickMaxDurationCount = 0;
+
+    // non external assets passed to start()
+    Assets *mainAssets = nullptr;
+
+    FlowState *firstFlowState = nullptr;
+    FlowState *lastFlowState = nullptr;
+
+    // global variables, if assets are not mutable
+    GlobalVariables *globalVariables = nullptr;
+
+    // set while native user action is executed
+    FlowState *executeActionFlowState = nullptr;
+    unsigned executeActionComponentIndex = 0;
+
+    bool enableThrowError = true;
+
+    EvalStack stack;
+
+    Queue queue;
+    WatchList watchList;
+    TimerWheel timerWheel;
+    FlowStateSlotTable flowStateSlotTable;
+    SampleBuffer *firstSampleBuffer = nullptr;
+    Inbox inbox;
+    date::DstCache dstCache;
+
+    // ShowMessageBox info and error message callbacks have no user parameter
+    ComponenentExecutionState *messageBoxExecutionState = nullptr;
+};
+
+extern EEZ_FLOW_THREAD_LOCAL FlowContext *g_flowContext;
+
+// Debugger is attached only to the default context, other contexts must not touch its state.
+bool isDefaultFlowContext();
+
+} // flow
+} // eez
@@ -23,6 +23,8 @@
 #include <eez/flow/dashboard_api.h>
 #include <eez/flow/private.h>
 #include <eez/flow/debugger.h>
+#include <eez/flow/watch_list.h>
+#include <eez/flow/context.h>
 
 using namespace eez;
 using namespace eez::flow;
@@ -363,27 +365,29 @@ EM_PORT_API(void) valueFree(Value *valuePtr) {
 
 EM_PORT_API(Value *) getGlobalVariable(int globalVariableIndex) {
     auto flowDefinition = static_cast<FlowDefinition *>(eez::g_mainAssets->flowDefinition);
-    if (g_globalVariables) {
-        return g_globalVariables->values + globalVariableIndex;
+    if (g_flowContext->globalVariables) {
+        return g_flowContext->globalVariables->values + globalVariableIndex;
     }
     return flowDefinition->globalVariables[globalVariableIndex];
 }
 
 EM_PORT_API(void) setGlobalVariable(int globalVariableIndex, Value *valuePtr) {
     auto flowDefinition = static_cast<FlowDefinition *>(eez::g_mainAssets->flowDefinition);
-    Value *globalVariableValuePtr = g_globalVariables
-        ? g_globalVariables->values + globalVariableIndex
+    Value *globalVariableValuePtr = g_flowContext->globalVariables
+        ? g_flowContext->globalVariables->values + globalVariableIndex
         : flowDefinition->globalVariables[globalVariableIndex];
     *globalVariableValuePtr = *valuePtr;
     onValueChanged(globalVariableValuePtr);
+    markWatchesDirty(globalVariableValuePtr);
 }
 
 EM_PORT_API(void) updateGlobalVariable(int globalVariableIndex, Value *valuePtr) {
     auto flowDefinition = static_cast<FlowDefinition *>(eez::g_mainAssets->flowDefinition);
-    Value *globalVariableValuePtr = g_globalVariables
-        ? g_globalVariables->values + globalVariableIndex
+    Value *globalVariableValuePtr = g_flowContext->globalVariables
+        ? g_flowContext->globalVariables->values + globalVariableIndex
         : flowDefinition->globalVariables[globalVariableIndex];
     updateArrayValue(globalVariableValuePtr->getArray(), valuePtr->getArray());
+    markAllWatchesDirty();
 }
 
 EM_PORT_API(int) getFlowIndex(int flowStateIndex) {
@@ -588,6 +592,7 @@ EM_PORT_API(void) setPropertyField(int flowStateIndex, int componentIndex, int p
 
     array->values[fieldIndex] = *valuePtr;
     onValueChanged(array->values + fieldIndex);
+    markAllWatchesDirty();
 }
 
 EM_PORT_API(void) propagateValue(int flowStateIndex, int componentIndex, int outputIndex, Value *valuePtr) {
@@ -631,10 +636,10 @@ EM_PORT_API(void) throwError(int flowStateIndex, int componentIndex, const char
 }
 
 EM_PORT_API(int) getFirstRootFlowState() {
-    if (!g_firstFlowState) {
+    if (!g_flowContext->firstFlowState) {
         return -1;
     }
-    return getFlowStateIndex(g_firstFlowState);
+    return getFlowStateIndex(g_flowContext->firstFlowState);
 }
 
 EM_PORT_API(int) getFirstChildFlowState(int flowStateIndex) {
@@ -16,6 +16,7 @@
 
 #include <eez/flow/date.h>
 #include <eez/flow/hooks.h>
+#include <eez/flow/context.h>
 
 namespace eez {
 namespace flow {
@@ -24,15 +25,7 @@ namespace date {
 #define SECONDS_PER_MINUTE 60UL
 #define SECONDS_PER_HOUR (SECONDS_PER_MINUTE * 60)
 #define SECONDS_PER_DAY (SECONDS_PER_HOUR * 24)
-
-// leap year calulator expects year argument as years offset from 1970
-#define LEAP_YEAR(Y)                                                                               \
-    (((1970 + Y) > 0) && !((1970 + Y) % 4) && (((1970 + Y) % 100) || !((1970 + Y) % 400)))
-
-////////////////////////////////////////////////////////////////////////////////
-
-// API starts months from 1, this array starts from 0
-static const uint8_t monthDays[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+#define MILLISECONDS_PER_DAY (SECONDS_PER_DAY * 1000)
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -68,6 +61,8 @@ DstRule g_dstRule = DST_RULE_OFF;
 
 static void convertTime24to12(int &hours, bool &am);
 //static void convertTime12to24(int &hours, bool am);
+static int64_t daysFromCivil(int year, int month, int day);
+static void civilFromDays(int64_t days, int &year, int &month, int &day);
 static bool isDst(Date time, DstRule dstRule);
 static uint8_t dayOfWeek(int y, int m, int d);
 static Date timeChangeRuleToLocal(TimeChangeRule &r, int year);
@@ -109,43 +104,25 @@ Date fromString(const char *str) {
 }
 
 Date makeDate(int year, int month, int day, int hours, int minutes, int seconds, int milliseconds) {
-    // seconds from 1970 till 1 jan 00:00:00 of the given year
-    year -= 1970;
-
-    Date time = year * 365 * SECONDS_PER_DAY;
-
-    for (int i = 0; i < year; i++) {
-        if (LEAP_YEAR(i)) {
-            time += SECONDS_PER_DAY; // add extra days for leap years
-        }
+    // months start from 1, months past December continue into the next year
+    if (month < 1) {
+        month = 1;
+    } else if (month > 12) {
+        year += (month - 1) / 12;
+        month = (month - 1) % 12 + 1;
     }
 
-    // add days for this year, months start from 1
-    for (int i = 1; i < month; i++) {
-        if ((i == 2) && LEAP_YEAR(year)) {
-            time += SECONDS_PER_DAY * 29;
-        } else {
-            time += SECONDS_PER_DAY * monthDays[i - 1]; // monthDay array starts from 0
-        }
-    }
-    time += (day - 1) * SECONDS_PER_DAY;
-    time += hours * SECONDS_PER_HOUR;
-    time += minutes * SECONDS_PER_MINUTE;
-    time += seconds;
-
-    time *= 1000;
-
-    time += milliseconds;
+    int64_t time = daysFromCivil(year, month, 1) + (day - 1);
+    time = time * 24 + hours;
+    time = time * 60 + minutes;
+    time = time * 60 + seconds;
+    time = time * 1000 + milliseconds;
 
-    return time;
+    return (Date)time;
 }
 
 void breakDate(Date time, int &result_year, int &result_month, int &result_day, int &result_hours, int &result_minutes, int &result_seconds, int &result_milliseconds) {
     // break the given time_t into time components
-    uint8_t year;
-    uint8_t month, monthLength;
-    uint32_t days;
-
     result_milliseconds = time % 1000;
     time /= 1000; // now it is seconds
 
@@ -158,81 +135,41 @@ void breakDate(Date time, int &result_year, int &result_month, int &result_day,
     result_hours = time % 24;
     time /= 24; // now it is days
 
-    year = 0;
-    days = 0;
-    while ((unsigned)(days += (LEAP_YEAR(year) ? 366 : 365)) <= time) {
-        year++;
-    }
-    result_year = year + 1970; // year is offset from 1970
-
-    days -= LEAP_YEAR(year) ? 366 : 365;
-    time -= days; // now it is days in this year, starting at 0
-
-    days = 0;
-    month = 0;
-    monthLength = 0;
-    for (month = 0; month < 12; ++month) {
-        if (month == 1) { // february
-            if (LEAP_YEAR(year)) {
-                monthLength = 29;
-            } else {
-                monthLength = 28;
-            }
-        } else {
-            monthLength = monthDays[month];
-        }
-
-        if (time >= monthLength) {
-            time -= monthLength;
-        } else {
-            break;
-        }
-    }
-
-    result_month = month + 1; // jan is month 1
-    result_day = time + 1;    // day of month
+    civilFromDays((int64_t)time, result_year, result_month, result_day);
 }
 
 int getYear(Date time) {
-    int year, month, day, hours, minutes, seconds, milliseconds;
-    breakDate(time, year, month, day, hours, minutes, seconds, milliseconds);
+    int year, month, day;
+    civilFromDays((int64_t)(time / MILLISECONDS_PER_DAY), year, month, day);
     return year;
 }
 
 int getMonth(Date time) {
-    int year, month, day, hours, minutes, seconds, milliseconds;
-    breakDate(time, year, month, day, hours, minutes, seconds, milliseconds);
+    int year, month, day;
+    civilFromDays((int64_t)(time / MILLISECONDS_PER_DAY), year, month, day);
     return month;
 }
 
 int getDay(Date time) {
-    int year, month, day, hours, minutes, seconds, milliseconds;
-    breakDate(time, year, month, day, hours, minutes, seconds, milliseconds);
+    int year, month, day;
+    civilFromDays((int64_t)(time / MILLISECONDS_PER_DAY), year, month, day);
     return day;
 }
 
 int getHours(Date time) {
-    int year, month, day, hours, minutes, seconds, milliseconds;
-    breakDate(time, year, month, day, hours, minutes, seconds, milliseconds);
-    return hours;
+    return (time / (SECONDS_PER_HOUR * 1000)) % 24;
 }
 
 int getMinutes(Date time) {
-    int year, month, day, hours, minutes, seconds, milliseconds;
-    breakDate(time, year, month, day, hours, minutes, seconds, milliseconds);
-    return minutes;
+    return (time / (SECONDS_PER_MINUTE * 1000)) % 60;
 }
 
 int getSeconds(Date time) {
-    int year, month, day, hours, minutes, seconds, milliseconds;
-    breakDate(time, year, month, day, hours, minutes, seconds, milliseconds);
-    return seconds;
+    return (time / 1000) % 60;
 }
 
 int getMilliseconds(Date time) {
-    int year, month, day, hours, minutes, seconds, milliseconds;
-    breakDate(time, year, month, day, hours, minutes, seconds, milliseconds);
-    return milliseconds;
+    return time % 1000;
 }
 
 Date utcToLocal(Date utc) {
@@ -251,6 +188,18 @@ Date localToUtc(Date local) {
     return utc;
 }
 
+void utcToLocal(const Date *utc, Date *local, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        local[i] = utcToLocal(utc[i]);
+    }
+}
+
+void localToUtc(const Date *local, Date *utc, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        utc[i] = localToUtc(local[i]);
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 // PRIVATE function definitions
@@ -282,16 +231,64 @@ static void convertTime24to12(int &hours, bool &am) {
 //    }
 //}
 
+// Howard Hinnant's days_from_civil, days since 1970-01-01 of the proleptic Gregorian date
+static int64_t daysFromCivil(int year, int month, int day) {
+    int64_t y = month <= 2 ? year - 1 : year;
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    int64_t yoe = y - era * 400; // [0, 399]
+    int64_t doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1; // [0, 365]
+    int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy; // [0, 146096]
+    return era * 146097 + doe - 719468;
+}
+
+// inverse of daysFromCivil
+static void civilFromDays(int64_t days, int &year, int &month, int &day) {
+    days += 719468;
+    int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    int64_t doe = days - era * 146097; // [0, 146096]
+    int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365; // [0, 399]
+    int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100); // [0, 365]
+    int64_t mp = (5 * doy + 2) / 153; // [0, 11], starting from March
+    day = (int)(doy - (153 * mp + 2) / 5 + 1);
+    month = (int)(mp < 10 ? mp + 3 : mp - 9);
+    year = (int)(yoe + era * 400 + (month <= 2 ? 1 : 0));
+}
+
+// isDst is called for every utcToLocal/localToUtc and the timestamps are usually from the same year,
+// cache is in the current flow context, so contexts running in different threads don't share it
+static const DstCacheEntry &getDstCacheEntry(Date local, DstRule dstRule) {
+    auto &dstCache = g_flowContext->dstCache;
+
+    for (uint32_t i = 0; i < EEZ_FLOW_DATE_DST_CACHE_SIZE; i++) {
+        auto &entry = dstCache.entries[i];
+        if (entry.dstRule == dstRule && local >= entry.yearStart && local < entry.yearEnd) {
+            return entry;
+        }
+    }
+
+    int year, month, day;
+    civilFromDays((int64_t)(local / MILLISECONDS_PER_DAY), year, month, day);
+
+    auto &entry = dstCache.entries[dstCache.next];
+    dstCache.next = (dstCache.next + 1) % EEZ_FLOW_DATE_DST_CACHE_SIZE;
+
+    entry.dstRule = dstRule;
+    entry.yearStart = makeDate(year, 1, 1, 0, 0, 0, 0);
+    entry.yearEnd = makeDate(year + 1, 1, 1, 0, 0, 0, 0);
+    entry.dstStart = timeChangeRuleToLocal(g_dstRules[dstRule - 1].dstStart, year);
+    entry.dstEnd = timeChangeRuleToLocal(g_dstRules[dstRule - 1].dstEnd, year);
+
+    return entry;
+}
+
 static bool isDst(Date local, DstRule dstRule) {
     if (dstRule == DST_RULE_OFF) {
         return false;
     }
 
-    int year, month, day, hours, minutes, seconds, milliseconds;
-    breakDate(local, year, month, day, hours, minutes, seconds, milliseconds);
-
-    Date dstStart = timeChangeRuleToLocal(g_dstRules[dstRule - 1].dstStart, year);
-    Date dstEnd = timeChangeRuleToLocal(g_dstRules[dstRule - 1].dstEnd, year);
+    auto &entry = getDstCacheEntry(local, dstRule);
+    Date dstStart = entry.dstStart;
+    Date dstEnd = entry.dstEnd;
 
     return (dstStart < dstEnd && (local >= dstStart && local < dstEnd)) ||
            (dstStart > dstEnd && (local >= dstStart || local < dstEnd));
@@ -320,9 +317,9 @@ static Date timeChangeRuleToLocal(TimeChangeRule &r, int year) {
 
     uint8_t dow = dayOfWeek(year, month, 1);
 
-    time += (7 * (week - 1) + (r.dow - dow + 7) % 7) * SECONDS_PER_DAY;
+    time += (7 * (week - 1) + (r.dow - dow + 7) % 7) * MILLISECONDS_PER_DAY;
     if (r.week == 0) {
-        time -= 7 * SECONDS_PER_DAY; // back up a week if this is a "Last" rule
+        time -= 7 * MILLISECONDS_PER_DAY; // back up a week if this is a "Last" rule
     }
 
     return time;
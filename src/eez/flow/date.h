@@ -12,6 +12,10 @@
 
 #include <stdint.h>
 
+#if !defined(EEZ_FLOW_DATE_DST_CACHE_SIZE)
+#define EEZ_FLOW_DATE_DST_CACHE_SIZE 4
+#endif
+
 namespace eez {
 namespace flow {
 namespace date {
@@ -46,6 +50,24 @@ int getMilliseconds(Date time);
 Date utcToLocal(Date utc);
 Date localToUtc(Date local);
 
+// batched conversions, e.g. for chart axes and log tables
+void utcToLocal(const Date *utc, Date *local, uint32_t count);
+void localToUtc(const Date *local, Date *utc, uint32_t count);
+
+// DST transitions of the recently used years
+struct DstCacheEntry {
+    DstRule dstRule;
+    Date yearStart;
+    Date yearEnd;
+    Date dstStart;
+    Date dstEnd;
+};
+
+struct DstCache {
+    DstCacheEntry entries[EEZ_FLOW_DATE_DST_CACHE_SIZE] = {};
+    uint32_t next = 0;
+};
+
 } // namespace date
 } // namespace flow
 } // namespace eez
@@ -24,6 +24,8 @@
 #include <eez/flow/private.h>
 #include <eez/flow/debugger.h>
 #include <eez/flow/hooks.h>
+#include <eez/flow/flow_defs_v3.h>
+#include <eez/flow/context.h>
 
 namespace eez {
 namespace flow {
@@ -103,7 +105,7 @@ void setDebuggerMessageSubsciptionFilter(uint32_t filter) {
 }
 
 static bool isSubscribedTo(MessagesToDebugger messageType) {
-    if (g_debuggerIsConnected && (g_messageSubsciptionFilter & (1 << messageType)) != 0) {
+    if (g_debuggerIsConnected && isDefaultFlowContext() && (g_messageSubsciptionFilter & (1 << messageType)) != 0) {
         startToDebuggerMessageHook();
         return true;
     }
@@ -164,7 +166,7 @@ void processDebuggerInput(char *buffer, uint32_t length) {
 				auto flowIndex = (uint32_t)strtol(g_inputFromDebugger + 2, &p, 10);
 				auto componentIndex = (uint32_t)strtol(p + 1, nullptr, 10);
 
-				auto assets = g_firstFlowState->assets;
+				auto assets = g_flowContext->firstFlowState->assets;
 				auto flowDefinition = static_cast<FlowDefinition *>(assets->flowDefinition);
 				if (flowIndex < flowDefinition->flows.count) {
 					auto flow = flowDefinition->flows[flowIndex];
@@ -200,7 +202,7 @@ void processDebuggerInput(char *buffer, uint32_t length) {
 ////////////////////////////////////////////////////////////////////////////////
 
 bool canExecuteStep(FlowState *&flowState, unsigned &componentIndex) {
-    if (!g_debuggerIsConnected) {
+    if (!g_debuggerIsConnected || !isDefaultFlowContext()) {
         return true;
     }
 
@@ -339,6 +341,50 @@ static void writeArray(const ArrayValue *arrayValue) {
     }
 }
 
+static void writeValue(const Value &value);
+
+static void writeTypedArray(const TypedArrayRef *typedArrayRef) {
+	WRITE_TO_OUTPUT_BUFFER('{');
+
+	writeValueAddr(typedArrayRef);
+
+    WRITE_TO_OUTPUT_BUFFER(',');
+    writeArrayType(typedArrayRef->size);
+
+    WRITE_TO_OUTPUT_BUFFER(',');
+    writeArrayType(
+        typedArrayRef->elementType == TYPED_ARRAY_ELEMENT_TYPE_FLOAT ? defs_v3::ARRAY_TYPE_FLOAT :
+        typedArrayRef->elementType == TYPED_ARRAY_ELEMENT_TYPE_DOUBLE ? defs_v3::ARRAY_TYPE_DOUBLE :
+        defs_v3::ARRAY_TYPE_INTEGER
+    );
+
+    auto transferredSize = typedArrayRef->size > MAX_ARRAY_SIZE_TRANSFERRED_IN_DEBUGGER ? MAX_ARRAY_SIZE_TRANSFERRED_IN_DEBUGGER : typedArrayRef->size;
+    auto elementSize = getTypedArrayElementSize(typedArrayRef->elementType);
+
+    // elements are not stored as Value's, so element address is used as value address
+	for (uint32_t i = 0; i < transferredSize; i++) {
+		WRITE_TO_OUTPUT_BUFFER(',');
+		writeValueAddr((const uint8_t *)typedArrayRef->data + i * elementSize);
+	}
+
+	WRITE_TO_OUTPUT_BUFFER('}');
+	WRITE_TO_OUTPUT_BUFFER('\n');
+	FLUSH_OUTPUT_BUFFER();
+
+    if (isSubscribedTo(MESSAGE_TO_DEBUGGER_VALUE_CHANGED)) {
+        for (uint32_t i = 0; i < transferredSize; i++) {
+            char buffer[256];
+            snprintf(buffer, sizeof(buffer), "%d\t%p\t",
+                MESSAGE_TO_DEBUGGER_VALUE_CHANGED,
+                (const void *)((const uint8_t *)typedArrayRef->data + i * elementSize)
+            );
+            writeDebuggerBufferHook(buffer, strlen(buffer));
+
+            writeValue(typedArrayRef->getElement(i));
+        }
+    }
+}
+
 static void writeHex(char *dst, uint8_t *src, size_t srcLength) {
     *dst++ = 'H';
     for (size_t i = 0; i < srcLength; i++) {
@@ -420,6 +466,7 @@ static void writeValue(const Value &value) {
 	case VALUE_TYPE_STRING:
     case VALUE_TYPE_STRING_ASSET:
 	case VALUE_TYPE_STRING_REF:
+	case VALUE_TYPE_STRING_SLICE:
 		writeString(value.getString());
 		return;
 
@@ -429,6 +476,10 @@ static void writeValue(const Value &value) {
 		writeArray(value.getArray());
 		return;
 
+	case VALUE_TYPE_TYPED_ARRAY_REF:
+		writeTypedArray(value.getTypedArray());
+		return;
+
 	case VALUE_TYPE_BLOB_REF:
 		snprintf(tempStr, sizeof(tempStr) - 1, "@%d", (int)((BlobRef *)value.refValue)->len);
 		break;
@@ -478,9 +529,9 @@ void onStarted(Assets *assets) {
     if (!assets->external && isSubscribedTo(MESSAGE_TO_DEBUGGER_GLOBAL_VARIABLE_INIT)) {
 		auto flowDefinition = static_cast<FlowDefinition *>(assets->flowDefinition);
 
-        if (g_globalVariables) {
-            for (uint32_t i = 0; i < g_globalVariables->count; i++) {
-                auto pValue = g_globalVariables->values + i;
+        if (g_flowContext->globalVariables) {
+            for (uint32_t i = 0; i < g_flowContext->globalVariables->count; i++) {
+                auto pValue = g_flowContext->globalVariables->values + i;
 
                 char buffer[256];
                 snprintf(buffer, sizeof(buffer), "%d\t%d\t%p\t",
@@ -511,7 +562,9 @@ void onStarted(Assets *assets) {
 }
 
 void onStopped() {
-    setDebuggerState(DEBUGGER_STATE_STOPPED);
+    if (isDefaultFlowContext()) {
+        setDebuggerState(DEBUGGER_STATE_STOPPED);
+    }
 }
 
 void onAddToQueue(FlowState *flowState, int sourceComponentIndex, int sourceOutputIndex, unsigned targetComponentIndex, int targetInputIndex) {
@@ -13,8 +13,11 @@
 
 #include <stdio.h>
 
+#include <eez/core/data_source.h>
+
 #include <eez/flow/private.h>
 #include <eez/flow/operations.h>
+#include <eez/flow/context.h>
 
 #if EEZ_OPTION_GUI
 #include <eez/gui/gui.h>
@@ -24,9 +27,8 @@ using namespace eez::gui;
 namespace eez {
 namespace flow {
 
-EvalStack g_stack;
-
 static void evalExpression(FlowState *flowState, const uint8_t *instructions, int *numInstructionBytes) {
+	auto &stack = g_flowContext->stack;
 	auto flowDefinition = static_cast<FlowDefinition*>(flowState->assets->flowDefinition);
 	auto flow = flowState->flow;
 
@@ -36,30 +38,30 @@ static void evalExpression(FlowState *flowState, const uint8_t *instructions, in
 		auto instructionType = instruction & EXPR_EVAL_INSTRUCTION_TYPE_MASK;
 		auto instructionArg = instruction & EXPR_EVAL_INSTRUCTION_PARAM_MASK;
 		if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_PUSH_CONSTANT) {
-			g_stack.push(*flowDefinition->constants[instructionArg]);
+			stack.push(*flowDefinition->constants[instructionArg]);
 		} else if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_PUSH_INPUT) {
-			g_stack.push(flowState->values[instructionArg]);
+			stack.push(flowState->values[instructionArg]);
 		} else if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_PUSH_LOCAL_VAR) {
-			g_stack.push(&flowState->values[flow->componentInputs.count + instructionArg]);
+			stack.push(&flowState->values[flow->componentInputs.count + instructionArg]);
 		} else if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_PUSH_GLOBAL_VAR) {
 			if ((uint32_t)instructionArg < flowDefinition->globalVariables.count) {
-                if (g_globalVariables && !flowState->assets->external) {
-				    g_stack.push(g_globalVariables->values + instructionArg);
+                if (g_flowContext->globalVariables && !flowState->assets->external) {
+				    stack.push(g_flowContext->globalVariables->values + instructionArg);
                 } else {
-                    g_stack.push(flowDefinition->globalVariables[instructionArg]);
+                    stack.push(flowDefinition->globalVariables[instructionArg]);
                 }
 			} else {
 				// native variable
-				g_stack.push(Value((int)(instructionArg - flowDefinition->globalVariables.count + 1), VALUE_TYPE_NATIVE_VARIABLE));
+				stack.push(Value((int)(instructionArg - flowDefinition->globalVariables.count + 1), VALUE_TYPE_NATIVE_VARIABLE));
 			}
 		} else if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_PUSH_OUTPUT) {
-			g_stack.push(Value((uint16_t)instructionArg, VALUE_TYPE_FLOW_OUTPUT));
+			stack.push(Value((uint16_t)instructionArg, VALUE_TYPE_FLOW_OUTPUT));
 		} else if (instructionType == EXPR_EVAL_INSTRUCTION_ARRAY_ELEMENT) {
-			auto elementIndexValue = g_stack.pop().getValue();
-			auto arrayValue = g_stack.pop().getValue();
+			auto elementIndexValue = stack.pop().getValue();
+			auto arrayValue = stack.pop().getValue();
 
             if (arrayValue.getType() == VALUE_TYPE_UNDEFINED || arrayValue.getType() == VALUE_TYPE_NULL) {
-                g_stack.push(Value(0, VALUE_TYPE_UNDEFINED));
+                stack.push(Value(0, VALUE_TYPE_UNDEFINED));
             } else {
                 if (arrayValue.isArray()) {
                     auto array = arrayValue.getArray();
@@ -68,14 +70,14 @@ static void evalExpression(FlowState *flowState, const uint8_t *instructions, in
                     auto elementIndex = elementIndexValue.toInt32(&err);
                     if (!err) {
                         if (elementIndex >= 0 && elementIndex < (int)array->arraySize) {
-                            g_stack.push(Value::makeArrayElementRef(arrayValue, elementIndex, 0x132e0e2f));
+                            stack.push(Value::makeArrayElementRef(arrayValue, elementIndex, 0x132e0e2f));
                         } else {
-                            g_stack.push(Value::makeError());
-                            g_stack.setErrorMessage("Array element index out of bounds\n");
+                            stack.push(Value::makeError());
+                            stack.setErrorMessage("Array element index out of bounds\n");
                         }
                     } else {
-                        g_stack.push(Value::makeError());
-                        g_stack.setErrorMessage("Integer value expected for array element index\n");
+                        stack.push(Value::makeError());
+                        stack.setErrorMessage("Integer value expected for array element index\n");
                     }
                 } else if (arrayValue.isBlob()) {
                     auto blobRef = arrayValue.getBlob();
@@ -84,28 +86,60 @@ static void evalExpression(FlowState *flowState, const uint8_t *instructions, in
                     auto elementIndex = elementIndexValue.toInt32(&err);
                     if (!err) {
                         if (elementIndex >= 0 && elementIndex < (int)blobRef->len) {
-                            g_stack.push(Value::makeArrayElementRef(arrayValue, elementIndex, 0x132e0e2f));
+                            stack.push(Value::makeArrayElementRef(arrayValue, elementIndex, 0x132e0e2f));
                         } else {
-                            g_stack.push(Value::makeError());
-                            g_stack.setErrorMessage("Blob element index out of bounds\n");
+                            stack.push(Value::makeError());
+                            stack.setErrorMessage("Blob element index out of bounds\n");
                         }
                     } else {
-                        g_stack.push(Value::makeError());
-                        g_stack.setErrorMessage("Integer value expected for blob element index\n");
+                        stack.push(Value::makeError());
+                        stack.setErrorMessage("Integer value expected for blob element index\n");
                     }
+                } else if (arrayValue.isTypedArray()) {
+                    auto typedArrayRef = arrayValue.getTypedArray();
 
+                    int err;
+                    auto elementIndex = elementIndexValue.toInt32(&err);
+                    if (!err) {
+                        if (elementIndex >= 0 && elementIndex < (int)typedArrayRef->size) {
+                            stack.push(Value::makeArrayElementRef(arrayValue, elementIndex, 0x132e0e2f));
+                        } else {
+                            stack.push(Value::makeError());
+                            stack.setErrorMessage("Typed array element index out of bounds\n");
+                        }
+                    } else {
+                        stack.push(Value::makeError());
+                        stack.setErrorMessage("Integer value expected for typed array element index\n");
+                    }
+                } else if (arrayValue.isDataSource()) {
+                    auto dataSourceRef = arrayValue.getDataSource();
+
+                    // rows are read only, so there is no element reference
+                    int err;
+                    auto elementIndex = elementIndexValue.toInt32(&err);
+                    if (!err) {
+                        if (elementIndex >= 0 && elementIndex < (int)dataSourceRef->getNumRows()) {
+                            stack.push(dataSourceRef->getRow(elementIndex));
+                        } else {
+                            stack.push(Value::makeError());
+                            stack.setErrorMessage("Data source row index out of bounds\n");
+                        }
+                    } else {
+                        stack.push(Value::makeError());
+                        stack.setErrorMessage("Integer value expected for data source row index\n");
+                    }
                 } else {
-                    g_stack.push(Value::makeError());
-                    g_stack.setErrorMessage("Array value expected\n");
+                    stack.push(Value::makeError());
+                    stack.setErrorMessage("Array value expected\n");
                 }
             }
 		} else if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_OPERATION) {
-			g_evalOperations[instructionArg](g_stack);
+			g_evalOperations[instructionArg](stack);
 		} else {
             if (instruction == EXPR_EVAL_INSTRUCTION_TYPE_END_WITH_DST_VALUE_TYPE) {
     			i += 2;
-                if (g_stack.sp == 1) {
-                    auto finalResult = g_stack.pop();
+                if (stack.sp == 1) {
+                    auto finalResult = stack.pop();
 
                     #define VALUE_TYPE (instructions[i] + (instructions[i + 1] << 8) + (instructions[i + 2] << 16) + (instructions[i + 3] << 24))
                     if (finalResult.getType() == VALUE_TYPE_VALUE_PTR) {
@@ -115,7 +149,7 @@ static void evalExpression(FlowState *flowState, const uint8_t *instructions, in
                         arrayElementValue->dstValueType = VALUE_TYPE;
                     }
 
-                    g_stack.push(finalResult);
+                    stack.push(finalResult);
                 }
                 i += 4;
                 break;
@@ -138,30 +172,32 @@ bool evalExpression(FlowState *flowState, int componentIndex, const uint8_t *ins
 #else
 bool evalExpression(FlowState *flowState, int componentIndex, const uint8_t *instructions, Value &result, const FlowError &errorMessage, int *numInstructionBytes, const int32_t *iterators) {
 #endif
-	//g_stack.sp = 0;
+	auto &stack = g_flowContext->stack;
+
+	//stack.sp = 0;
 
-    size_t savedSp = g_stack.sp;
-    FlowState *savedFlowState = g_stack.flowState;
-	int savedComponentIndex = g_stack.componentIndex;
-	const int32_t *savedIterators = g_stack.iterators;
-    const char *savedErrorMessage = g_stack.errorMessage;
+    size_t savedSp = stack.sp;
+    FlowState *savedFlowState = stack.flowState;
+	int savedComponentIndex = stack.componentIndex;
+	const int32_t *savedIterators = stack.iterators;
+    const char *savedErrorMessage = stack.errorMessage;
 
-	g_stack.flowState = flowState;
-	g_stack.componentIndex = componentIndex;
-	g_stack.iterators = iterators;
-    g_stack.errorMessage = nullptr;
+	stack.flowState = flowState;
+	stack.componentIndex = componentIndex;
+	stack.iterators = iterators;
+    stack.errorMessage = nullptr;
 
 	evalExpression(flowState, instructions, numInstructionBytes);
 
-	g_stack.flowState = savedFlowState;
-	g_stack.componentIndex = savedComponentIndex;
-	g_stack.iterators = savedIterators;
-    g_stack.errorMessage = savedErrorMessage;
+	stack.flowState = savedFlowState;
+	stack.componentIndex = savedComponentIndex;
+	stack.iterators = savedIterators;
+    stack.errorMessage = savedErrorMessage;
 
-    if (g_stack.sp == savedSp + 1) {
+    if (stack.sp == savedSp + 1) {
 #if EEZ_OPTION_GUI
         if (operation == DATA_OPERATION_GET_TEXT_REFRESH_RATE) {
-            result = g_stack.pop();
+            result = stack.pop();
             if (!result.isError()) {
                 if (result.getType() == VALUE_TYPE_NATIVE_VARIABLE) {
                     auto nativeVariableId = result.getInt();
@@ -172,7 +208,7 @@ bool evalExpression(FlowState *flowState, int componentIndex, const uint8_t *ins
                 return true;
             }
         } else if (operation == DATA_OPERATION_GET_TEXT_CURSOR_POSITION) {
-            result = g_stack.pop();
+            result = stack.pop();
             if (!result.isError()) {
                 if (result.getType() == VALUE_TYPE_NATIVE_VARIABLE) {
                     auto nativeVariableId = result.getInt();
@@ -183,7 +219,7 @@ bool evalExpression(FlowState *flowState, int componentIndex, const uint8_t *ins
                 return true;
             }
         }  else if (operation == DATA_OPERATION_GET_CANVAS_REFRESH_STATE) {
-            result = g_stack.pop();
+            result = stack.pop();
             if (!result.isError()) {
                 if (result.getType() == VALUE_TYPE_NATIVE_VARIABLE) {
                     auto nativeVariableId = result.getInt();
@@ -195,7 +231,7 @@ bool evalExpression(FlowState *flowState, int componentIndex, const uint8_t *ins
             }
         } else {
 #endif
-            result = g_stack.pop().getValue();
+            result = stack.pop().getValue();
             if (!result.isError()) {
                 return true;
             }
@@ -204,31 +240,32 @@ bool evalExpression(FlowState *flowState, int componentIndex, const uint8_t *ins
 #endif
     }
 
-    FlowError flowError = errorMessage.setDescription(g_stack.errorMessage);
+    FlowError flowError = errorMessage.setDescription(stack.errorMessage);
     throwError(flowState, componentIndex, flowError);
 	return false;
 }
 
 bool evalAssignableExpression(FlowState *flowState, int componentIndex, const uint8_t *instructions, Value &result, const FlowError &errorMessage, int *numInstructionBytes, const int32_t *iterators) {
-    FlowState *savedFlowState = g_stack.flowState;
-	int savedComponentIndex = g_stack.componentIndex;
-	const int32_t *savedIterators = g_stack.iterators;
-    const char *savedErrorMessage = g_stack.errorMessage;
+	auto &stack = g_flowContext->stack;
+    FlowState *savedFlowState = stack.flowState;
+	int savedComponentIndex = stack.componentIndex;
+	const int32_t *savedIterators = stack.iterators;
+    const char *savedErrorMessage = stack.errorMessage;
 
-	g_stack.flowState = flowState;
-	g_stack.componentIndex = componentIndex;
-	g_stack.iterators = iterators;
-    g_stack.errorMessage = nullptr;
+	stack.flowState = flowState;
+	stack.componentIndex = componentIndex;
+	stack.iterators = iterators;
+    stack.errorMessage = nullptr;
 
 	evalExpression(flowState, instructions, numInstructionBytes);
 
-	g_stack.flowState = savedFlowState;
-	g_stack.componentIndex = savedComponentIndex;
-	g_stack.iterators = savedIterators;
-    g_stack.errorMessage = savedErrorMessage;
+	stack.flowState = savedFlowState;
+	stack.componentIndex = savedComponentIndex;
+	stack.iterators = savedIterators;
+    stack.errorMessage = savedErrorMessage;
 
-    if (g_stack.sp == 1) {
-        auto finalResult = g_stack.pop();
+    if (stack.sp == 1) {
+        auto finalResult = stack.pop();
         if (
             finalResult.getType() == VALUE_TYPE_VALUE_PTR ||
             finalResult.getType() == VALUE_TYPE_NATIVE_VARIABLE ||
@@ -241,7 +278,7 @@ bool evalAssignableExpression(FlowState *flowState, int componentIndex, const ui
         }
     }
 
-    errorMessage.setDescription(g_stack.errorMessage);
+    errorMessage.setDescription(stack.errorMessage);
     throwError(flowState, componentIndex, errorMessage);
 
 	return false;
@@ -293,8 +330,69 @@ bool evalAssignableProperty(FlowState *flowState, int componentIndex, int proper
     return evalAssignableExpression(flowState, componentIndex, component->properties[propertyIndex]->evalInstructions, result, errorMessage, numInstructionBytes, iterators);
 }
 
+bool getExpressionDependencies(FlowState *flowState, const uint8_t *instructions, const Value **dependencies, unsigned &numDependencies, unsigned maxDependencies) {
+	auto flowDefinition = static_cast<FlowDefinition*>(flowState->assets->flowDefinition);
+	auto flow = flowState->flow;
+
+    numDependencies = 0;
+
+	int i = 0;
+	while (true) {
+		uint16_t instruction = instructions[i] + (instructions[i + 1] << 8);
+		auto instructionType = instruction & EXPR_EVAL_INSTRUCTION_TYPE_MASK;
+		auto instructionArg = instruction & EXPR_EVAL_INSTRUCTION_PARAM_MASK;
+
+        const Value *pValue = nullptr;
+
+		if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_PUSH_INPUT) {
+            return false;
+		} else if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_PUSH_LOCAL_VAR) {
+			pValue = &flowState->values[flow->componentInputs.count + instructionArg];
+		} else if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_PUSH_GLOBAL_VAR) {
+			if ((uint32_t)instructionArg >= flowDefinition->globalVariables.count) {
+                // native variable
+                return false;
+            }
+            if (g_flowContext->globalVariables && !flowState->assets->external) {
+                pValue = g_flowContext->globalVariables->values + instructionArg;
+            } else {
+                pValue = flowDefinition->globalVariables[instructionArg];
+            }
+		} else if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_OPERATION) {
+            if (isVolatileOperation(instructionArg)) {
+                return false;
+            }
+		} else if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_END) {
+            break;
+        }
+
+        if (pValue) {
+            // Variable slot holds a reference (user widget property, action parameter passed by
+            // reference, native variable), so the actual value can change without a write to this slot.
+            if (pValue->type == VALUE_TYPE_PROPERTY_REF || pValue->type == VALUE_TYPE_VALUE_PTR || pValue->type == VALUE_TYPE_NATIVE_VARIABLE) {
+                return false;
+            }
+
+            unsigned j;
+            for (j = 0; j < numDependencies && dependencies[j] != pValue; j++) {
+            }
+            if (j == numDependencies) {
+                if (numDependencies == maxDependencies) {
+                    return false;
+                }
+                dependencies[numDependencies++] = pValue;
+            }
+        }
+
+		i += 2;
+	}
+
+    return true;
+}
+
 #if EEZ_OPTION_GUI
 int16_t getNativeVariableId(const WidgetCursor &widgetCursor) {
+	auto &stack = g_flowContext->stack;
 	if (widgetCursor.flowState) {
 		FlowState *flowState = widgetCursor.flowState;
 		auto flow = flowState->flow;
@@ -304,25 +402,25 @@ int16_t getNativeVariableId(const WidgetCursor &widgetCursor) {
 			auto component = flow->components[widgetDataItem->componentIndex];
 			auto property = component->properties[widgetDataItem->propertyValueIndex];
 
-            FlowState *savedFlowState = g_stack.flowState;
-            int savedComponentIndex = g_stack.componentIndex;
-            const int32_t *savedIterators = g_stack.iterators;
-            const char *savedErrorMessage = g_stack.errorMessage;
+            FlowState *savedFlowState = stack.flowState;
+            int savedComponentIndex = stack.componentIndex;
+            const int32_t *savedIterators = stack.iterators;
+            const char *savedErrorMessage = stack.errorMessage;
 
-			g_stack.flowState = flowState;
-			g_stack.componentIndex = widgetDataItem->componentIndex;
-			g_stack.iterators = widgetCursor.iterators;
-            g_stack.errorMessage = nullptr;
+			stack.flowState = flowState;
+			stack.componentIndex = widgetDataItem->componentIndex;
+			stack.iterators = widgetCursor.iterators;
+            stack.errorMessage = nullptr;
 
 			evalExpression(flowState, property->evalInstructions, nullptr);
 
-            g_stack.flowState = savedFlowState;
-            g_stack.componentIndex = savedComponentIndex;
-            g_stack.iterators = savedIterators;
-            g_stack.errorMessage = savedErrorMessage;
+            stack.flowState = savedFlowState;
+            stack.componentIndex = savedComponentIndex;
+            stack.iterators = savedIterators;
+            stack.errorMessage = savedErrorMessage;
 
-            if (g_stack.sp == 1) {
-                auto finalResult = g_stack.pop();
+            if (stack.sp == 1) {
+                auto finalResult = stack.pop();
                 if (finalResult.getType() == VALUE_TYPE_NATIVE_VARIABLE) {
                     return finalResult.getInt();
                 }
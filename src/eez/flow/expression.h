@@ -79,5 +79,11 @@ bool evalProperty(FlowState *flowState, int componentIndex, int propertyIndex, V
 #endif
 bool evalAssignableProperty(FlowState *flowState, int componentIndex, int propertyIndex, Value &result, const FlowError &errorMessage, int *numInstructionBytes = nullptr, const int32_t *iterators = nullptr);
 
+// Collects pointers to the variables read by the expression.
+// Returns false if expression result can change without writing to one of these variables,
+// i.e. if it reads component inputs, native variables, variables holding a reference
+// (user widget property, value pointer) or uses some volatile operation.
+bool getExpressionDependencies(FlowState *flowState, const uint8_t *instructions, const Value **dependencies, unsigned &numDependencies, unsigned maxDependencies);
+
 } // flow
 } // eez
@@ -13,6 +13,7 @@
 #include <stdio.h>
 
 #include <eez/core/util.h>
+#include <eez/core/data_source.h>
 
 #include <eez/core/os.h>
 
@@ -24,7 +25,11 @@
 #include <eez/flow/hooks.h>
 #include <eez/flow/components/lvgl_user_widget.h>
 #include <eez/flow/watch_list.h>
+#include <eez/flow/timer_wheel.h>
+#include <eez/flow/sample_buffer.h>
+#include <eez/flow/inbox.h>
 #include <eez/flow/expression.h>
+#include <eez/flow/context.h>
 
 #if EEZ_OPTION_GUI
 #include <eez/gui/gui.h>
@@ -50,17 +55,14 @@ uint32_t g_wasmModuleId = 0;
 #endif
 static const uint32_t FLOW_TICK_MAX_DURATION_MS = EEZ_FLOW_TICK_MAX_DURATION_MS;
 
-static unsigned g_tick_max_duration_count = 0;
-
 int g_selectedLanguage = 0;
-FlowState *g_firstFlowState;
-FlowState *g_lastFlowState;
-
-static bool g_isStopping = false;
-static bool g_isStopped = true;
 
 static void doStop();
 
+static inline Assets *getMainAssets() {
+    return g_flowContext->mainAssets ? g_flowContext->mainAssets : g_mainAssets;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 unsigned start(Assets *assets) {
@@ -69,14 +71,17 @@ unsigned start(Assets *assets) {
 		return 0;
 	}
 
-    g_isStopped = false;
-    g_isStopping = false;
+    g_flowContext->isStopped = false;
+    g_flowContext->isStopping = false;
 
     initGlobalVariables(assets);
 
     if (!assets->external) {
+        g_flowContext->mainAssets = assets;
+
 	    queueReset();
         watchListReset();
+        timerWheelReset();
     }
 
     scpiComponentInitHook();
@@ -91,18 +96,27 @@ void tick() {
 		return;
 	}
 
-    if (g_isStopping) {
+    if (g_flowContext->isStopping) {
         doStop();
         return;
     }
 
 	uint32_t startTickCount = millis();
 
+    // execute commands posted from the other threads
+    processInbox();
+
     visitWatchList();
 
+    // move components with expired deadlines to the queue
+    processTimers();
+
+    // deliver samples pushed by the producer threads since the last tick
+    flushSampleBuffers();
+
     auto queueSizeAtTickStart = getQueueSize();
 
-    for (size_t i = 0; i < queueSizeAtTickStart || g_numNonContinuousTaskInQueue > 0; i++) {
+    for (size_t i = 0; i < queueSizeAtTickStart || g_flowContext->queue.numNonContinuousTasks > 0; i++) {
 		FlowState *flowState;
 		unsigned componentIndex;
         bool continuousTask;
@@ -111,6 +125,7 @@ void tick() {
 		}
 
         if (!flowState) {
+            // flow state was freed after this task was added
             removeNextTaskFromQueue();
             continue;
         }
@@ -137,7 +152,7 @@ void tick() {
             }
         }
 
-        if (isFlowStopped() || g_isStopping) {
+        if (isFlowStopped() || g_flowContext->isStopping) {
             break;
         }
 
@@ -149,16 +164,18 @@ void tick() {
 
         if ((i + 1) % 5 == 0) {
             if (millis() - startTickCount >= FLOW_TICK_MAX_DURATION_MS) {
-                g_tick_max_duration_count++;
+                g_flowContext->tickMaxDurationCount++;
                 break;
             }
         }
 	}
 
-	finishToDebuggerMessageHook();
+    if (isDefaultFlowContext()) {
+        finishToDebuggerMessageHook();
+    }
 
     // delete flow states marked with deleteOnNextTick
-    for (FlowState *flowState = g_firstFlowState; flowState; ) {
+    for (FlowState *flowState = g_flowContext->firstFlowState; flowState; ) {
         FlowState* nextFlowState = flowState->nextSibling;
         if (flowState->deleteOnNextTick) {
             freeFlowState(flowState);
@@ -169,41 +186,64 @@ void tick() {
 
 void stop(Assets* assets) {
     if (!assets) {
-        assets = g_mainAssets;
+        assets = getMainAssets();
     }
 
     if (assets->external) {
-        for (FlowState *flowState = g_firstFlowState; flowState; flowState = flowState->nextSibling) {
+        for (FlowState *flowState = g_flowContext->firstFlowState; flowState; flowState = flowState->nextSibling) {
             if (flowState->assets == assets) {
                 flowState->deleteOnNextTick = true;
             }
         }
     } else {
-        g_isStopping = true;
+        g_flowContext->isStopping = true;
     }
 }
 
 void doStop() {
     onStopped();
-    finishToDebuggerMessageHook();
-    g_debuggerIsConnected = false;
+    if (isDefaultFlowContext()) {
+        finishToDebuggerMessageHook();
+        g_debuggerIsConnected = false;
+    }
 
-    freeAllChildrenFlowStates(g_firstFlowState);
-    g_firstFlowState = nullptr;
-    g_lastFlowState = nullptr;
+    freeAllChildrenFlowStates(g_flowContext->firstFlowState);
+    g_flowContext->firstFlowState = nullptr;
+    g_flowContext->lastFlowState = nullptr;
+    g_flowContext->messageBoxExecutionState = nullptr;
 
-    g_isStopped = true;
+    g_flowContext->isStopped = true;
 
 	queueReset();
     watchListReset();
+    timerWheelReset();
+    inboxReset();
 }
 
 bool isFlowStopped() {
-    return g_isStopped;
+    return g_flowContext->isStopped;
 }
 
 unsigned getTickMaxDurationCounter() {
-    return g_tick_max_duration_count;
+    return g_flowContext->tickMaxDurationCount;
+}
+
+uint32_t getNextTickTimeout() {
+    if (isFlowStopped()) {
+        return NO_TICK_TIMEOUT;
+    }
+
+    if (g_flowContext->isStopping || getQueueSize() > 0 || hasDirtyWatches() || hasPendingSamples() || !isInboxEmpty()) {
+        return 0;
+    }
+
+    uint32_t deadline;
+    if (!getNextTimerDeadline(deadline)) {
+        return NO_TICK_TIMEOUT;
+    }
+
+    int32_t timeout = (int32_t)(deadline - millis());
+    return timeout > 0 ? (uint32_t)timeout : 0;
 }
 
 #if EEZ_OPTION_GUI
@@ -227,7 +267,7 @@ FlowState *getPageFlowState(Assets *assets, int16_t pageIndex, const WidgetCurso
 		auto page = assets->pages[pageIndex];
 		if (!(page->flags & PAGE_IS_USED_AS_USER_WIDGET)) {
             FlowState *flowState;
-            for (flowState = g_firstFlowState; flowState; flowState = flowState->nextSibling) {
+            for (flowState = g_flowContext->firstFlowState; flowState; flowState = flowState->nextSibling) {
                 if (flowState->assets == assets && flowState->flowIndex == pageIndex) {
                     break;
                 }
@@ -258,7 +298,7 @@ FlowState *getPageFlowState(Assets *assets, int16_t pageIndex) {
 	}
 
     FlowState *flowState;
-    for (flowState = g_firstFlowState; flowState; flowState = flowState->nextSibling) {
+    for (flowState = g_flowContext->firstFlowState; flowState; flowState = flowState->nextSibling) {
         if (flowState->flowIndex == pageIndex) {
             break;
         }
@@ -288,7 +328,7 @@ int getPageIndexIncludeParents(FlowState *flowState) {
 
 void deletePageFlowState(Assets *assets, int16_t pageIndex) {
     EEZ_UNUSED(assets);
-    for (FlowState *flowState = g_firstFlowState; flowState; flowState = flowState->nextSibling) {
+    for (FlowState *flowState = g_flowContext->firstFlowState; flowState; flowState = flowState->nextSibling) {
         if (flowState->flowIndex == pageIndex) {
             flowState->deleteOnNextTick = true;
             return;
@@ -297,72 +337,86 @@ void deletePageFlowState(Assets *assets, int16_t pageIndex) {
 }
 
 Value getGlobalVariable(uint32_t globalVariableIndex) {
-    return getGlobalVariable(g_mainAssets, globalVariableIndex);
+    return getGlobalVariable(getMainAssets(), globalVariableIndex);
 }
 
 Value getGlobalVariable(Assets *assets, uint32_t globalVariableIndex) {
     if (globalVariableIndex < assets->flowDefinition->globalVariables.count) {
-        return g_globalVariables && !assets->external ? g_globalVariables->values[globalVariableIndex] : *assets->flowDefinition->globalVariables[globalVariableIndex];
+        return g_flowContext->globalVariables && !assets->external ? g_flowContext->globalVariables->values[globalVariableIndex] : *assets->flowDefinition->globalVariables[globalVariableIndex];
     }
     return Value();
 }
 
 void setGlobalVariable(uint32_t globalVariableIndex, const Value &value) {
-    setGlobalVariable(g_mainAssets, globalVariableIndex, value);
+    setGlobalVariable(getMainAssets(), globalVariableIndex, value);
 }
 
 void setGlobalVariable(Assets *assets, uint32_t globalVariableIndex, const Value &value) {
     if (globalVariableIndex < assets->flowDefinition->globalVariables.count) {
-        if (g_globalVariables && !assets->external) {
-            g_globalVariables->values[globalVariableIndex] = value;
+        if (g_flowContext->globalVariables && !assets->external) {
+            g_flowContext->globalVariables->values[globalVariableIndex] = value;
+            markWatchesDirty(g_flowContext->globalVariables->values + globalVariableIndex);
         } else {
             *assets->flowDefinition->globalVariables[globalVariableIndex] = value;
+            markWatchesDirty(assets->flowDefinition->globalVariables[globalVariableIndex]);
         }
     }
 }
 
 Value getUserProperty(unsigned propertyIndex) {
     Value value;
-    evalProperty(g_executeActionFlowState, g_executeActionComponentIndex, propertyIndex, value, FlowError::PropertyNum("CallAction", propertyIndex));
+    evalProperty(g_flowContext->executeActionFlowState, g_flowContext->executeActionComponentIndex, propertyIndex, value, FlowError::PropertyNum("CallAction", propertyIndex));
     return value;
 }
 
 void setUserProperty(unsigned propertyIndex, const Value &value) {
     Value dstValue;
-    if (!evalAssignableProperty(g_executeActionFlowState, g_executeActionComponentIndex, propertyIndex, dstValue, FlowError::PropertyInArray("CallAction", "Assignable property", propertyIndex))) {
+    if (!evalAssignableProperty(g_flowContext->executeActionFlowState, g_flowContext->executeActionComponentIndex, propertyIndex, dstValue, FlowError::PropertyInArray("CallAction", "Assignable property", propertyIndex))) {
         return;
     }
-    assignValue(g_executeActionFlowState, g_executeActionComponentIndex, dstValue, value);
+    assignValue(g_flowContext->executeActionFlowState, g_flowContext->executeActionComponentIndex, dstValue, value);
 }
 
 // signal to the flow engine that async action has been started
 AsyncAction *beginAsyncExecution() {
-    startAsyncExecution(g_executeActionFlowState, g_executeActionComponentIndex);
+    startAsyncExecution(g_flowContext->executeActionFlowState, g_flowContext->executeActionComponentIndex);
     AsyncAction *asyncAction = (AsyncAction *) alloc(sizeof(AsyncAction), 0xcb44f51e);
-    asyncAction->flowState = g_executeActionFlowState;
-    asyncAction->componentIndex = g_executeActionComponentIndex;
+    asyncAction->flowState = g_flowContext->executeActionFlowState;
+    asyncAction->flowStateHandle = g_flowContext->executeActionFlowState->handle;
+    asyncAction->componentIndex = g_flowContext->executeActionComponentIndex;
     return asyncAction;
 }
 
 // signal to the flow engine that async action has been ended
 void endAsyncExecution(AsyncAction *asyncAction) {
-    endAsyncExecution(asyncAction->flowState, asyncAction->componentIndex);
-    propagateValueThroughSeqout(asyncAction->flowState, asyncAction->componentIndex);
+    // flow state could be freed while async action was running, e.g. when page is closed
+    auto flowState = getFlowStateFromHandle(asyncAction->flowStateHandle);
+    if (flowState) {
+        // propagate first, because flow state is freed in endAsyncExecution if nothing else keeps it alive
+        propagateValueThroughSeqout(flowState, asyncAction->componentIndex);
+        endAsyncExecution(flowState, asyncAction->componentIndex);
+    }
     eez::free(asyncAction);
 }
 
 Value getUserPropertyAsync(AsyncAction *asyncAction, unsigned propertyIndex) {
     Value value;
+    if (!getFlowStateFromHandle(asyncAction->flowStateHandle)) {
+        return value;
+    }
     evalProperty(asyncAction->flowState, asyncAction->componentIndex, propertyIndex, value, FlowError::PropertyNum("CallAction", propertyIndex));
     return value;
 }
 
 void setUserPropertyAsync(AsyncAction *asyncAction, unsigned propertyIndex, const Value &value) {
+    if (!getFlowStateFromHandle(asyncAction->flowStateHandle)) {
+        return;
+    }
     Value dstValue;
     if (!evalAssignableProperty(asyncAction->flowState, asyncAction->componentIndex, propertyIndex, dstValue, FlowError::PropertyInArray("CallAction", "Assignable property", propertyIndex))) {
         return;
     }
-    assignValue(g_executeActionFlowState, g_executeActionComponentIndex, dstValue, value);
+    assignValue(asyncAction->flowState, asyncAction->componentIndex, dstValue, value);
 }
 
 #if EEZ_OPTION_GUI
@@ -458,9 +512,18 @@ void dataOperation(int16_t dataId, DataOperationEnum operation, const WidgetCurs
                 } else {
 				    value = array->arraySize;
                 }
+			} else if (arrayValue.isDataSource()) {
+                value = (int)arrayValue.getDataSource()->getNumRows();
 			} else {
                 value = arrayValue;
             }
+		} else if (operation == DATA_OPERATION_SET_VIEWPORT) {
+			Value dataSourceValue;
+			getValue(flowDataId, operation, widgetCursor, dataSourceValue);
+			if (dataSourceValue.isDataSource()) {
+                auto params = (SetViewportParams *)value.getVoidPointer();
+                dataSourceValue.getDataSource()->setViewport(params->first, params->count);
+			}
 		}
 		else if (operation == DATA_OPERATION_GET_MIN) {
 			if (component->type == WIDGET_TYPE_INPUT) {
@@ -567,6 +630,7 @@ void dataOperation(int16_t dataId, DataOperationEnum operation, const WidgetCurs
                     }
                     array->values[defs_v3::SYSTEM_STRUCTURE_SCROLLBAR_STATE_FIELD_POSITION] = newPosition;
                     onValueChanged(&array->values[defs_v3::SYSTEM_STRUCTURE_SCROLLBAR_STATE_FIELD_POSITION]);
+                    markAllWatchesDirty();
                 } else {
                     value = 0;
                 }
@@ -26,13 +26,51 @@ extern uint32_t g_wasmModuleId;
 
 struct FlowState;
 
+// Flow state is referenced through the handle (slot index and generation) from the places that
+// can outlive it: queue, watch list, timers and async actions. Handle of the freed flow state
+// doesn't resolve anymore, so such references are detected when used instead of being
+// searched for when flow state is freed.
+struct FlowStateHandle {
+    uint32_t slotIndex;
+    uint32_t generation; // 0 for the null handle
+
+    bool operator==(const FlowStateHandle &other) const {
+        return slotIndex == other.slotIndex && generation == other.generation;
+    }
+};
+
+FlowStateHandle getFlowStateHandle(FlowState *flowState);
+
 unsigned start(Assets *assets);
 void tick();
 void stop(Assets* assets = nullptr);
 
+// Each flow context is a separate instance of the flow engine with its own flow states, queue,
+// watch list, timers and inbox. Functions without context argument work on the current
+// context, which is the default context unless changed with setFlowContext (per thread
+// if EEZ_FLOW_CONTEXT_THREAD_LOCAL is enabled). Debugger and GUI always use the default context.
+struct FlowContext;
+
+FlowContext *createFlowContext();
+void destroyFlowContext(FlowContext *flowContext);
+FlowContext *getFlowContext();
+FlowContext *getDefaultFlowContext();
+// Returns the previous current context
+FlowContext *setFlowContext(FlowContext *flowContext);
+
+unsigned start(FlowContext *flowContext, Assets *assets);
+void tick(FlowContext *flowContext);
+void stop(FlowContext *flowContext, Assets* assets = nullptr);
+
 bool isFlowStopped();
 unsigned getTickMaxDurationCounter();
 
+// Returns the number of milliseconds host can sleep before the next tick() call is required:
+// 0 if there is pending work and NO_TICK_TIMEOUT if nothing is scheduled.
+// Any external event (touch, variable change, ...) can require earlier tick().
+static const uint32_t NO_TICK_TIMEOUT = 0xFFFFFFFF;
+uint32_t getNextTickTimeout();
+
 #if EEZ_OPTION_GUI
 FlowState *getPageFlowState(Assets *assets, int16_t pageIndex, const WidgetCursor &widgetCursor);
 #else
@@ -55,6 +93,7 @@ void setUserProperty(unsigned propertyIndex, const Value &value);
 //
 struct AsyncAction {
     eez::flow::FlowState *flowState;
+    FlowStateHandle flowStateHandle;
     unsigned componentIndex;
 };
 
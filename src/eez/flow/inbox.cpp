@@ -0,0 +1,200 @@
+/*
+ * eez-framework
+ *
+ * MIT License
+ * Copyright 2024 Envox d.o.o.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <eez/conf-internal.h>
+
+#include <string.h>
+
+#include <eez/flow/inbox.h>
+#include <eez/flow/context.h>
+
+namespace eez {
+namespace flow {
+
+static inline InboxCell &getCell(Inbox &inbox, uint32_t position) {
+    return inbox.cells[position & (INBOX_SIZE - 1)];
+}
+
+static inline uint32_t getSequence(Inbox &inbox, uint32_t position) {
+    return getCell(inbox, position).relativeSequence.load(std::memory_order_acquire) + (position & (INBOX_SIZE - 1));
+}
+
+static inline void setSequence(Inbox &inbox, uint32_t position, uint32_t sequence) {
+    getCell(inbox, position).relativeSequence.store(sequence - (position & (INBOX_SIZE - 1)), std::memory_order_release);
+}
+
+void inboxReset() {
+    auto &inbox = g_flowContext->inbox;
+
+    // discard pending commands
+    while (!isInboxEmpty()) {
+        auto &command = getCell(inbox, inbox.dequeuePosition).command;
+        if (command.type == INBOX_COMMAND_END_ASYNC_EXECUTION) {
+            eez::free(command.asyncAction);
+        }
+        setSequence(inbox, inbox.dequeuePosition, inbox.dequeuePosition + INBOX_SIZE);
+        inbox.dequeuePosition++;
+    }
+}
+
+static bool claimPosition(Inbox &inbox, uint32_t &position) {
+    position = inbox.enqueuePosition.load(std::memory_order_relaxed);
+    while (true) {
+        int32_t diff = (int32_t)(getSequence(inbox, position) - position);
+        if (diff == 0) {
+            if (inbox.enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                return true;
+            }
+        } else if (diff < 0) {
+            // full
+            return false;
+        } else {
+            // other producer claimed this position
+            position = inbox.enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+static bool canPostValue(const Value &value) {
+    if (value.isString()) {
+        // every string is copied, also the non reference ones, because they can point to
+        // the stack or temporary buffer of the posting thread
+        uint32_t len;
+        return value.getStringAndLength(len) && len <= INBOX_MAX_STRING_LENGTH;
+    }
+
+    // only the scalar values, all other types hold a pointer
+    switch (value.type) {
+    case VALUE_TYPE_UNDEFINED:
+    case VALUE_TYPE_NULL:
+    case VALUE_TYPE_BOOLEAN:
+    case VALUE_TYPE_INT8:
+    case VALUE_TYPE_UINT8:
+    case VALUE_TYPE_INT16:
+    case VALUE_TYPE_UINT16:
+    case VALUE_TYPE_INT32:
+    case VALUE_TYPE_UINT32:
+    case VALUE_TYPE_INT64:
+    case VALUE_TYPE_UINT64:
+    case VALUE_TYPE_FLOAT:
+    case VALUE_TYPE_DOUBLE:
+    case VALUE_TYPE_DATE:
+    case VALUE_TYPE_ENUM:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static void setCommandValue(InboxCommand &command, const Value &value) {
+    if (value.isString()) {
+        // only the bytes are copied, reference counter of the value is not touched
+        const char *str = value.getStringAndLength(command.strLen);
+        memcpy(command.str, str, command.strLen);
+        command.isString = true;
+    } else {
+        command.isString = false;
+        command.value = value;
+    }
+}
+
+static bool post(FlowContext *flowContext, InboxCommandType type, Assets *assets, AsyncAction *asyncAction, const FlowStateHandle &flowStateHandle, int componentIndex, int index, const Value &value) {
+    if (!canPostValue(value)) {
+        return false;
+    }
+
+    auto &inbox = (flowContext ? flowContext : getDefaultFlowContext())->inbox;
+
+    uint32_t position;
+    if (!claimPosition(inbox, position)) {
+        return false;
+    }
+
+    auto &command = getCell(inbox, position).command;
+    command.type = type;
+    command.assets = assets;
+    command.asyncAction = asyncAction;
+    command.flowStateHandle = flowStateHandle;
+    command.componentIndex = componentIndex;
+    command.index = index;
+    setCommandValue(command, value);
+
+    setSequence(inbox, position, position + 1);
+
+    return true;
+}
+
+bool postSetGlobalVariable(FlowContext *flowContext, Assets *assets, uint32_t globalVariableIndex, const Value &value) {
+    return post(flowContext, INBOX_COMMAND_SET_GLOBAL_VARIABLE, assets, nullptr, FlowStateHandle { 0, 0 }, -1, (int)globalVariableIndex, value);
+}
+
+bool postPropagateValue(FlowContext *flowContext, const FlowStateHandle &flowStateHandle, unsigned componentIndex, unsigned outputIndex, const Value &value) {
+    return post(flowContext, INBOX_COMMAND_PROPAGATE_VALUE, nullptr, nullptr, flowStateHandle, (int)componentIndex, (int)outputIndex, value);
+}
+
+bool postEndAsyncExecution(FlowContext *flowContext, AsyncAction *asyncAction) {
+    return post(flowContext, INBOX_COMMAND_END_ASYNC_EXECUTION, nullptr, asyncAction, asyncAction->flowStateHandle, (int)asyncAction->componentIndex, -1, Value());
+}
+
+bool postCallAction(FlowContext *flowContext, const FlowStateHandle &flowStateHandle, int componentIndex, int flowIndex, const Value &value) {
+    return post(flowContext, INBOX_COMMAND_CALL_ACTION, nullptr, nullptr, flowStateHandle, componentIndex, flowIndex, value);
+}
+
+static void executeCommand(InboxCommand &command) {
+    Value value;
+    if (command.isString) {
+        value = Value::makeStringRef(command.str, command.strLen, 0x2f84b6d1);
+    } else {
+        value = command.value;
+    }
+
+    if (command.type == INBOX_COMMAND_SET_GLOBAL_VARIABLE) {
+        setGlobalVariable(command.assets, (uint32_t)command.index, value);
+    } else if (command.type == INBOX_COMMAND_END_ASYNC_EXECUTION) {
+        endAsyncExecution(command.asyncAction);
+    } else {
+        // command is ignored if flow state was freed in the meantime
+        auto flowState = getFlowStateFromHandle(command.flowStateHandle);
+        if (flowState) {
+            if (command.type == INBOX_COMMAND_PROPAGATE_VALUE) {
+                propagateValue(flowState, (unsigned)command.componentIndex, (unsigned)command.index, value);
+            } else {
+                executeCallAction(flowState, (unsigned)command.componentIndex, command.index, value);
+            }
+        }
+    }
+}
+
+void processInbox() {
+    auto &inbox = g_flowContext->inbox;
+
+    // only commands posted before this call are executed, so producers can't keep the flow thread busy
+    uint32_t numCommands = inbox.enqueuePosition.load(std::memory_order_acquire) - inbox.dequeuePosition;
+
+    for (uint32_t i = 0; i < numCommands; i++) {
+        if (getSequence(inbox, inbox.dequeuePosition) != inbox.dequeuePosition + 1) {
+            // position is claimed but command is not yet written
+            break;
+        }
+
+        executeCommand(getCell(inbox, inbox.dequeuePosition).command);
+
+        setSequence(inbox, inbox.dequeuePosition, inbox.dequeuePosition + INBOX_SIZE);
+        inbox.dequeuePosition++;
+    }
+}
+
+bool isInboxEmpty() {
+    auto &inbox = g_flowContext->inbox;
+    return getSequence(inbox, inbox.dequeuePosition) != inbox.dequeuePosition + 1;
+}
+
+} // namespace flow
+} // namespace eez
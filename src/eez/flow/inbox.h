@@ -0,0 +1,97 @@
+/*
+ * eez-framework
+ *
+ * MIT License
+ * Copyright 2024 Envox d.o.o.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+
+#include <eez/flow/private.h>
+
+namespace eez {
+namespace flow {
+
+// Thread-safe entry points into the flow engine. Any thread can post a command into the lock-free
+// inbox (bounded, multiple producers / single consumer) and commands are executed by the flow thread
+// at the start of the next tick(), in the order they were posted.
+//
+// Values are passed by value: strings (of any string type) are copied into the command (up to
+// EEZ_FLOW_INBOX_MAX_STRING_LENGTH bytes) and scalar values (boolean, integer, float, double, date, enum,
+// null and undefined) are copied as they are. All other types hold a pointer (arrays, blobs, value pointers, ...)
+// and can't be passed. Post functions return false if the inbox is full or value can't be passed.
+
+// Target flow context is always passed explicitly (nullptr is the default context), because the current
+// context of the posting thread (g_flowContext) is not related to the flow that should execute the command.
+
+#if !defined(EEZ_FLOW_INBOX_SIZE)
+#define EEZ_FLOW_INBOX_SIZE 32
+#endif
+static const uint32_t INBOX_SIZE = EEZ_FLOW_INBOX_SIZE;
+static_assert((INBOX_SIZE & (INBOX_SIZE - 1)) == 0, "EEZ_FLOW_INBOX_SIZE must be power of 2");
+
+#if !defined(EEZ_FLOW_INBOX_MAX_STRING_LENGTH)
+#define EEZ_FLOW_INBOX_MAX_STRING_LENGTH 64
+#endif
+static const uint32_t INBOX_MAX_STRING_LENGTH = EEZ_FLOW_INBOX_MAX_STRING_LENGTH;
+
+enum InboxCommandType {
+    INBOX_COMMAND_SET_GLOBAL_VARIABLE,
+    INBOX_COMMAND_PROPAGATE_VALUE,
+    INBOX_COMMAND_END_ASYNC_EXECUTION,
+    INBOX_COMMAND_CALL_ACTION
+};
+
+struct InboxCommand {
+    InboxCommandType type;
+
+    Assets *assets;
+    AsyncAction *asyncAction;
+    FlowStateHandle flowStateHandle;
+    int componentIndex;
+
+    // global variable index, output index or flow index
+    int index;
+
+    // scalar value or, if isString is set, string copied into str
+    Value value;
+    bool isString;
+    uint32_t strLen;
+    char str[INBOX_MAX_STRING_LENGTH];
+};
+
+// Bounded MPSC queue, every cell has a sequence number:
+//   - sequence == position: cell is free for the producer that claims this position
+//   - sequence == position + 1: command is written and can be executed
+// Sequence is stored relative to the cell index, so zero initialized inbox is valid
+// and commands can be posted even before the flow is started.
+struct InboxCell {
+    std::atomic<uint32_t> relativeSequence;
+    InboxCommand command;
+};
+
+struct Inbox {
+    InboxCell cells[INBOX_SIZE];
+    std::atomic<uint32_t> enqueuePosition;
+    uint32_t dequeuePosition;
+};
+
+struct FlowContext;
+
+bool postSetGlobalVariable(FlowContext *flowContext, Assets *assets, uint32_t globalVariableIndex, const Value &value);
+bool postPropagateValue(FlowContext *flowContext, const FlowStateHandle &flowStateHandle, unsigned componentIndex, unsigned outputIndex, const Value &value);
+bool postEndAsyncExecution(FlowContext *flowContext, AsyncAction *asyncAction);
+bool postCallAction(FlowContext *flowContext, const FlowStateHandle &flowStateHandle, int componentIndex, int flowIndex, const Value &value);
+
+// Called from the flow thread
+void processInbox();
+void inboxReset();
+bool isInboxEmpty();
+
+} // flow
+} // eez
@@ -0,0 +1,787 @@
+/*
+ * eez-framework
+ *
+ * MIT License
+ * Copyright 2024 Envox d.o.o.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <eez/conf-internal.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <inttypes.h>
+
+#include <new>
+
+#include <eez/core/alloc.h>
+
+#include <eez/flow/json.h>
+#include <eez/flow/flow_defs_v3.h>
+
+namespace eez {
+namespace flow {
+namespace json {
+
+////////////////////////////////////////////////////////////////////////////////
+
+enum ReaderState {
+    STATE_VALUE,
+    STATE_VALUE_OR_END,
+    STATE_KEY,
+    STATE_KEY_OR_END,
+    STATE_COMMA_OR_END,
+    STATE_DONE,
+    STATE_ERROR
+};
+
+Reader::Reader(const char *json, uint32_t len)
+    : tokenStart(nullptr), tokenLength(0), tokenHasEscapes(false), depth(0),
+      m_json(json), m_len(len), m_pos(0), m_state(STATE_VALUE)
+{
+}
+
+TokenType Reader::next() {
+    while (true) {
+        skipWhitespace();
+
+        if (m_state == STATE_ERROR) {
+            return TOKEN_ERROR;
+        }
+
+        if (m_state == STATE_DONE) {
+            return m_pos == m_len ? TOKEN_END : error();
+        }
+
+        if (m_pos == m_len) {
+            return error();
+        }
+
+        char c = m_json[m_pos];
+
+        if (m_state == STATE_KEY || m_state == STATE_KEY_OR_END) {
+            if (c == '}' && m_state == STATE_KEY_OR_END) {
+                m_pos++;
+                return endContainer(TOKEN_END_OBJECT);
+            }
+
+            if (c != '"' || !scanString()) {
+                return error();
+            }
+
+            skipWhitespace();
+            if (m_pos == m_len || m_json[m_pos] != ':') {
+                return error();
+            }
+            m_pos++;
+
+            m_state = STATE_VALUE;
+            return TOKEN_KEY;
+        }
+
+        if (m_state == STATE_COMMA_OR_END) {
+            bool isObject = m_containerIsObject[depth - 1];
+            if (c == ',') {
+                m_pos++;
+                m_state = isObject ? STATE_KEY : STATE_VALUE;
+                continue;
+            }
+            if (c == (isObject ? '}' : ']')) {
+                m_pos++;
+                return endContainer(isObject ? TOKEN_END_OBJECT : TOKEN_END_ARRAY);
+            }
+            return error();
+        }
+
+        if (m_state == STATE_VALUE_OR_END && c == ']') {
+            m_pos++;
+            return endContainer(TOKEN_END_ARRAY);
+        }
+
+        return readValue();
+    }
+}
+
+void Reader::skipWhitespace() {
+    while (m_pos < m_len) {
+        char c = m_json[m_pos];
+        if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+            break;
+        }
+        m_pos++;
+    }
+}
+
+TokenType Reader::readValue() {
+    char c = m_json[m_pos];
+
+    if (c == '{' || c == '[') {
+        if (depth == EEZ_FLOW_JSON_MAX_DEPTH) {
+            return error();
+        }
+        m_pos++;
+        m_containerIsObject[depth++] = c == '{';
+        m_state = c == '{' ? STATE_KEY_OR_END : STATE_VALUE_OR_END;
+        return c == '{' ? TOKEN_BEGIN_OBJECT : TOKEN_BEGIN_ARRAY;
+    }
+
+    if (c == '"') {
+        return scanString() ? afterValue(TOKEN_STRING) : error();
+    }
+
+    if (c == '-' || (c >= '0' && c <= '9')) {
+        return scanNumber() ? afterValue(TOKEN_NUMBER) : error();
+    }
+
+    if (c == 't') {
+        return scanLiteral("true", 4) ? afterValue(TOKEN_TRUE) : error();
+    }
+
+    if (c == 'f') {
+        return scanLiteral("false", 5) ? afterValue(TOKEN_FALSE) : error();
+    }
+
+    if (c == 'n') {
+        return scanLiteral("null", 4) ? afterValue(TOKEN_NULL) : error();
+    }
+
+    return error();
+}
+
+TokenType Reader::afterValue(TokenType tokenType) {
+    m_state = depth == 0 ? STATE_DONE : STATE_COMMA_OR_END;
+    return tokenType;
+}
+
+TokenType Reader::endContainer(TokenType tokenType) {
+    depth--;
+    return afterValue(tokenType);
+}
+
+static bool isHexDigit(char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+bool Reader::scanString() {
+    m_pos++; // skip opening quote
+
+    tokenStart = m_json + m_pos;
+    tokenHasEscapes = false;
+
+    while (m_pos < m_len) {
+        char c = m_json[m_pos];
+
+        if (c == '"') {
+            tokenLength = m_json + m_pos - tokenStart;
+            m_pos++;
+            return true;
+        }
+
+        if ((uint8_t)c < 0x20) {
+            return false;
+        }
+
+        if (c == '\\') {
+            tokenHasEscapes = true;
+
+            if (++m_pos == m_len) {
+                return false;
+            }
+
+            c = m_json[m_pos];
+            if (c == 'u') {
+                if (m_len - m_pos < 5) {
+                    return false;
+                }
+                for (int i = 1; i <= 4; i++) {
+                    if (!isHexDigit(m_json[m_pos + i])) {
+                        return false;
+                    }
+                }
+                m_pos += 4;
+            } else if (!strchr("\"\\/bfnrt", c)) {
+                return false;
+            }
+        }
+
+        m_pos++;
+    }
+
+    return false;
+}
+
+bool Reader::scanNumber() {
+    tokenStart = m_json + m_pos;
+
+    if (m_json[m_pos] == '-') {
+        m_pos++;
+    }
+
+    auto isDigit = [this]() {
+        return m_pos < m_len && m_json[m_pos] >= '0' && m_json[m_pos] <= '9';
+    };
+
+    if (!isDigit()) {
+        return false;
+    }
+
+    if (m_json[m_pos] == '0') {
+        m_pos++;
+    } else {
+        while (isDigit()) {
+            m_pos++;
+        }
+    }
+
+    if (m_pos < m_len && m_json[m_pos] == '.') {
+        m_pos++;
+        if (!isDigit()) {
+            return false;
+        }
+        while (isDigit()) {
+            m_pos++;
+        }
+    }
+
+    if (m_pos < m_len && (m_json[m_pos] == 'e' || m_json[m_pos] == 'E')) {
+        m_pos++;
+        if (m_pos < m_len && (m_json[m_pos] == '+' || m_json[m_pos] == '-')) {
+            m_pos++;
+        }
+        if (!isDigit()) {
+            return false;
+        }
+        while (isDigit()) {
+            m_pos++;
+        }
+    }
+
+    tokenLength = m_json + m_pos - tokenStart;
+    return true;
+}
+
+bool Reader::scanLiteral(const char *literal, uint32_t literalLen) {
+    if (m_len - m_pos < literalLen || memcmp(m_json + m_pos, literal, literalLen) != 0) {
+        return false;
+    }
+    m_pos += literalLen;
+    return true;
+}
+
+TokenType Reader::error() {
+    m_state = STATE_ERROR;
+    return TOKEN_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+static uint32_t parseHex4(const char *str) {
+    uint32_t result = 0;
+    for (int i = 0; i < 4; i++) {
+        char c = str[i];
+        result <<= 4;
+        if (c >= '0' && c <= '9') {
+            result |= c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            result |= c - 'a' + 10;
+        } else {
+            result |= c - 'A' + 10;
+        }
+    }
+    return result;
+}
+
+uint32_t unescapeString(const char *src, uint32_t len, char *dst) {
+    uint32_t n = 0;
+
+    for (uint32_t i = 0; i < len; i++) {
+        char c = src[i];
+        if (c != '\\') {
+            dst[n++] = c;
+            continue;
+        }
+
+        c = src[++i];
+        if (c == 'b') {
+            dst[n++] = '\b';
+        } else if (c == 'f') {
+            dst[n++] = '\f';
+        } else if (c == 'n') {
+            dst[n++] = '\n';
+        } else if (c == 'r') {
+            dst[n++] = '\r';
+        } else if (c == 't') {
+            dst[n++] = '\t';
+        } else if (c == 'u') {
+            uint32_t codePoint = parseHex4(src + i + 1);
+            i += 4;
+
+            if (codePoint >= 0xD800 && codePoint < 0xDC00 && i + 6 < len && src[i + 1] == '\\' && src[i + 2] == 'u') {
+                uint32_t lowSurrogate = parseHex4(src + i + 3);
+                if (lowSurrogate >= 0xDC00 && lowSurrogate < 0xE000) {
+                    codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (lowSurrogate - 0xDC00);
+                    i += 6;
+                }
+            }
+
+            // UTF-8 encoding is never longer than the escape sequence
+            if (codePoint < 0x80) {
+                dst[n++] = (char)codePoint;
+            } else if (codePoint < 0x800) {
+                dst[n++] = (char)(0xC0 | (codePoint >> 6));
+                dst[n++] = (char)(0x80 | (codePoint & 0x3F));
+            } else if (codePoint < 0x10000) {
+                dst[n++] = (char)(0xE0 | (codePoint >> 12));
+                dst[n++] = (char)(0x80 | ((codePoint >> 6) & 0x3F));
+                dst[n++] = (char)(0x80 | (codePoint & 0x3F));
+            } else {
+                dst[n++] = (char)(0xF0 | (codePoint >> 18));
+                dst[n++] = (char)(0x80 | ((codePoint >> 12) & 0x3F));
+                dst[n++] = (char)(0x80 | ((codePoint >> 6) & 0x3F));
+                dst[n++] = (char)(0x80 | (codePoint & 0x3F));
+            }
+        } else {
+            // '"', '\\' or '/'
+            dst[n++] = c;
+        }
+    }
+
+    return n;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+static Value parseString(Reader &reader, const Value &jsonStringValue, const char *json, uint32_t id) {
+    if (!reader.tokenHasEscapes) {
+        return Value::makeStringSlice(jsonStringValue, reader.tokenStart - json, reader.tokenLength, id);
+    }
+
+    auto value = Value::makeUninitializedStringRef(reader.tokenLength, id);
+    if (value.type == VALUE_TYPE_NULL) {
+        return value;
+    }
+
+    auto stringRef = (StringRef *)value.refValue;
+    stringRef->len = unescapeString(reader.tokenStart, reader.tokenLength, stringRef->str);
+    stringRef->str[stringRef->len] = 0;
+
+    return value;
+}
+
+static Value parseNumber(Reader &reader) {
+    // token is not zero terminated, long numbers are copied to the heap
+    char buffer[64];
+    char *str = buffer;
+    if (reader.tokenLength >= sizeof(buffer)) {
+        str = (char *)eez::alloc(reader.tokenLength + 1, 0x3c81f5a7);
+        if (!str) {
+            return Value::makeError();
+        }
+    }
+    memcpy(str, reader.tokenStart, reader.tokenLength);
+    str[reader.tokenLength] = 0;
+
+    Value value;
+
+    if (!strpbrk(str, ".eE")) {
+        char *end;
+        long long num = strtoll(str, &end, 10);
+        if (num >= INT32_MIN && num <= INT32_MAX) {
+            value = Value((int)num, VALUE_TYPE_INT32);
+        }
+    }
+
+    if (value.type == VALUE_TYPE_UNDEFINED) {
+        value = Value(strtod(str, nullptr), VALUE_TYPE_DOUBLE);
+    }
+
+    if (str != buffer) {
+        eez::free(str);
+    }
+
+    return value;
+}
+
+static Value parseScalar(Reader &reader, TokenType token, const Value &jsonStringValue, const char *json, uint32_t id) {
+    if (token == TOKEN_STRING) {
+        return parseString(reader, jsonStringValue, json, id);
+    }
+    if (token == TOKEN_NUMBER) {
+        return parseNumber(reader);
+    }
+    if (token == TOKEN_TRUE) {
+        return Value(true, VALUE_TYPE_BOOLEAN);
+    }
+    if (token == TOKEN_FALSE) {
+        return Value(false, VALUE_TYPE_BOOLEAN);
+    }
+    if (token == TOKEN_NULL) {
+        return Value(0, VALUE_TYPE_NULL);
+    }
+    return Value::makeError();
+}
+
+// Parsed values are waiting here until their container ends, then they are moved
+// into the array of the exact size. This way JSON is read only once.
+struct ParseStack {
+    Value *values;
+    uint32_t count;
+    uint32_t capacity;
+
+    ParseStack() : values(nullptr), count(0), capacity(0) {}
+
+    ~ParseStack() {
+        pop(count);
+        if (values) {
+            eez::free(values);
+        }
+    }
+
+    bool push(const Value &value) {
+        if (count == capacity) {
+            uint32_t newCapacity = capacity ? 2 * capacity : 16;
+            auto newValues = (Value *)eez::alloc(newCapacity * sizeof(Value), 0x6a0e53d9);
+            if (!newValues) {
+                return false;
+            }
+            if (values) {
+                // Value is moved bitwise, old copies are not destroyed
+                memcpy((void *)newValues, (const void *)values, count * sizeof(Value));
+                eez::free(values);
+            }
+            values = newValues;
+            capacity = newCapacity;
+        }
+        new (values + count++) Value(value);
+        return true;
+    }
+
+    void pop(uint32_t n) {
+        for (uint32_t i = count - n; i < count; i++) {
+            values[i].~Value();
+        }
+        count -= n;
+    }
+};
+
+// Returns index of the field with the name of the current key token or -1.
+static int findField(Reader &reader, const ObjectSchema *schema) {
+    const char *key = reader.tokenStart;
+    uint32_t keyLength = reader.tokenLength;
+
+    char *unescapedKey = nullptr;
+    if (reader.tokenHasEscapes) {
+        unescapedKey = (char *)eez::alloc(reader.tokenLength, 0x8d2e4b16);
+        if (!unescapedKey) {
+            return -1;
+        }
+        keyLength = unescapeString(reader.tokenStart, reader.tokenLength, unescapedKey);
+        key = unescapedKey;
+    }
+
+    int fieldIndex = -1;
+    for (uint32_t i = 0; i < schema->numFields; i++) {
+        auto fieldName = schema->fieldNames[i];
+        if (strlen(fieldName) == keyLength && memcmp(fieldName, key, keyLength) == 0) {
+            fieldIndex = (int)i;
+            break;
+        }
+    }
+
+    if (unescapedKey) {
+        eez::free(unescapedKey);
+    }
+
+    return fieldIndex;
+}
+
+Value parse(const Value &jsonStringValue, const ObjectSchema *schema, uint32_t id) {
+    uint32_t len;
+    const char *json = jsonStringValue.getStringAndLength(len);
+    if (!json) {
+        return Value::makeError();
+    }
+
+    Reader reader(json, len);
+    ParseStack stack;
+
+    // Object fields are reserved on the stack when the object begins and member values
+    // are stored in place, array elements are pushed.
+    uint32_t containerStart[EEZ_FLOW_JSON_MAX_DEPTH];
+    const ObjectSchema *containerSchema[EEZ_FLOW_JSON_MAX_DEPTH];
+    bool containerIsObject[EEZ_FLOW_JSON_MAX_DEPTH];
+    int containerField[EEZ_FLOW_JSON_MAX_DEPTH];
+
+    // value of the unknown member is skipped until reader returns to this depth
+    int skipDepth = -1;
+
+    while (true) {
+        auto token = reader.next();
+
+        if (token == TOKEN_ERROR) {
+            return Value::makeError();
+        }
+
+        if (token == TOKEN_END) {
+            break;
+        }
+
+        if (skipDepth != -1) {
+            if (reader.depth == skipDepth) {
+                skipDepth = -1;
+            }
+            continue;
+        }
+
+        if (token == TOKEN_KEY) {
+            auto c = reader.depth - 1;
+            containerField[c] = findField(reader, containerSchema[c]);
+            if (containerField[c] == -1) {
+                skipDepth = reader.depth;
+            }
+            continue;
+        }
+
+        if (token == TOKEN_BEGIN_OBJECT || token == TOKEN_BEGIN_ARRAY) {
+            auto c = reader.depth - 1;
+
+            const ObjectSchema *containerSchemaValue = schema;
+            if (c > 0) {
+                auto p = c - 1;
+                if (containerIsObject[p]) {
+                    auto fieldSchemas = containerSchema[p]->fieldSchemas;
+                    containerSchemaValue = fieldSchemas ? fieldSchemas[containerField[p]] : nullptr;
+                } else {
+                    containerSchemaValue = containerSchema[p];
+                }
+            }
+
+            containerStart[c] = stack.count;
+            containerSchema[c] = containerSchemaValue;
+            containerIsObject[c] = token == TOKEN_BEGIN_OBJECT;
+
+            if (token == TOKEN_BEGIN_OBJECT) {
+                if (!containerSchemaValue) {
+                    // members can't be mapped to the struct fields
+                    return Value::makeError();
+                }
+
+                for (uint32_t i = 0; i < containerSchemaValue->numFields; i++) {
+                    if (!stack.push(Value())) {
+                        return Value::makeError();
+                    }
+                }
+            }
+
+            continue;
+        }
+
+        Value value;
+
+        if (token == TOKEN_END_OBJECT || token == TOKEN_END_ARRAY) {
+            auto start = containerStart[reader.depth];
+            auto numElements = stack.count - start;
+
+            value = Value::makeArrayRef(numElements, defs_v3::ARRAY_TYPE_ANY, id);
+            if (value.type == VALUE_TYPE_NULL) {
+                return Value::makeError();
+            }
+
+            auto array = value.getArray();
+            for (uint32_t i = 0; i < numElements; i++) {
+                array->values[i] = stack.values[start + i];
+            }
+            stack.pop(numElements);
+        } else {
+            value = parseScalar(reader, token, jsonStringValue, json, id);
+            if (value.isError()) {
+                return value;
+            }
+        }
+
+        if (reader.depth > 0 && containerIsObject[reader.depth - 1]) {
+            auto p = reader.depth - 1;
+            stack.values[containerStart[p] + containerField[p]] = value;
+        } else if (!stack.push(value)) {
+            return Value::makeError();
+        }
+    }
+
+    // Reader returns TOKEN_END only after exactly one complete top level value
+    return stack.values[0];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Stringify is done in two passes, first pass only counts the bytes (buffer is nullptr),
+// so the result string is allocated once with the exact size.
+struct Writer {
+    char *buffer;
+    uint32_t pos;
+
+    void write(const char *str, uint32_t len) {
+        if (buffer) {
+            memcpy(buffer + pos, str, len);
+        }
+        pos += len;
+    }
+
+    void write(char c) {
+        if (buffer) {
+            buffer[pos] = c;
+        }
+        pos++;
+    }
+};
+
+static void writeString(Writer &writer, const char *str, uint32_t len) {
+    static const char HEX[] = "0123456789abcdef";
+
+    writer.write('"');
+
+    uint32_t start = 0;
+    for (uint32_t i = 0; i < len; i++) {
+        uint8_t c = (uint8_t)str[i];
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+
+        writer.write(str + start, i - start);
+        start = i + 1;
+
+        if (c == '"') {
+            writer.write("\\\"", 2);
+        } else if (c == '\\') {
+            writer.write("\\\\", 2);
+        } else if (c == '\n') {
+            writer.write("\\n", 2);
+        } else if (c == '\r') {
+            writer.write("\\r", 2);
+        } else if (c == '\t') {
+            writer.write("\\t", 2);
+        } else if (c == '\b') {
+            writer.write("\\b", 2);
+        } else if (c == '\f') {
+            writer.write("\\f", 2);
+        } else {
+            char escape[6] = { '\\', 'u', '0', '0', HEX[c >> 4], HEX[c & 0xF] };
+            writer.write(escape, 6);
+        }
+    }
+    writer.write(str + start, len - start);
+
+    writer.write('"');
+}
+
+static void writeDouble(Writer &writer, double value, int precision) {
+    if (isnan(value) || isinf(value)) {
+        writer.write("null", 4);
+        return;
+    }
+
+    // use the shortest representation which converts back to the same value
+    char str[32];
+    int len = snprintf(str, sizeof(str), "%.*g", precision - 2, value);
+    if (strtod(str, nullptr) != value) {
+        len = snprintf(str, sizeof(str), "%.*g", precision, value);
+    }
+    writer.write(str, len);
+}
+
+static bool writeValue(Writer &writer, const Value &value, int depth);
+
+static bool writeArrayElements(Writer &writer, const Value *values, uint32_t size, int depth) {
+    writer.write('[');
+    for (uint32_t i = 0; i < size; i++) {
+        if (i > 0) {
+            writer.write(',');
+        }
+        if (!writeValue(writer, values[i], depth + 1)) {
+            return false;
+        }
+    }
+    writer.write(']');
+    return true;
+}
+
+static bool writeValue(Writer &writer, const Value &valueArg, int depth) {
+    if (depth > EEZ_FLOW_JSON_MAX_DEPTH) {
+        return false;
+    }
+
+    auto value = valueArg.getValue();
+
+    if (value.isError()) {
+        return false;
+    }
+
+    if (value.isString()) {
+        uint32_t len;
+        const char *str = value.getStringAndLength(len);
+        writeString(writer, str, len);
+    } else if (value.isArray()) {
+        auto array = value.getArray();
+        return writeArrayElements(writer, array->values, array->arraySize, depth);
+    } else if (value.isTypedArray()) {
+        auto typedArray = value.getTypedArray();
+        writer.write('[');
+        for (uint32_t i = 0; i < typedArray->size; i++) {
+            if (i > 0) {
+                writer.write(',');
+            }
+            writeValue(writer, typedArray->getElement(i), depth + 1);
+        }
+        writer.write(']');
+    } else if (value.type == VALUE_TYPE_BOOLEAN) {
+        if (value.getBoolean()) {
+            writer.write("true", 4);
+        } else {
+            writer.write("false", 5);
+        }
+    } else if (value.type == VALUE_TYPE_FLOAT) {
+        writeDouble(writer, value.floatValue, 9);
+    } else if (value.type == VALUE_TYPE_DOUBLE) {
+        writeDouble(writer, value.doubleValue, 17);
+    } else if (value.type == VALUE_TYPE_DATE) {
+        char str[32];
+        int len = snprintf(str, sizeof(str), "%" PRId64, (int64_t)value.doubleValue);
+        writer.write(str, len);
+    } else if (value.type == VALUE_TYPE_UINT64) {
+        char str[32];
+        int len = snprintf(str, sizeof(str), "%" PRIu64, value.getUInt64());
+        writer.write(str, len);
+    } else if (value.isInt32OrLess() || value.type == VALUE_TYPE_INT64 || value.type == VALUE_TYPE_ENUM) {
+        char str[32];
+        int len = snprintf(str, sizeof(str), "%" PRId64, value.toInt64());
+        writer.write(str, len);
+    } else {
+        writer.write("null", 4);
+    }
+
+    return true;
+}
+
+Value stringify(const Value &value, uint32_t id) {
+    Writer counter = { nullptr, 0 };
+    if (!writeValue(counter, value, 0)) {
+        return Value::makeError();
+    }
+
+    auto result = Value::makeUninitializedStringRef(counter.pos, id);
+    if (result.type == VALUE_TYPE_NULL) {
+        return Value::makeError();
+    }
+
+    Writer writer = { (char *)result.getString(), 0 };
+    writeValue(writer, value, 0);
+
+    return result;
+}
+
+} // namespace json
+} // namespace flow
+} // namespace eez
@@ -0,0 +1,115 @@
+/*
+ * eez-framework
+ *
+ * MIT License
+ * Copyright 2024 Envox d.o.o.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <eez/core/value.h>
+
+#if !defined(EEZ_FLOW_JSON_MAX_DEPTH)
+#define EEZ_FLOW_JSON_MAX_DEPTH 32
+#endif
+
+namespace eez {
+namespace flow {
+namespace json {
+
+// Native JSON support, i.e. it doesn't depend on the dashboard (JavaScript) JSON values.
+// There are no expression operations for it, it is API for the native code, for example
+// native user actions can parse the string received from the flow into the struct value.
+//
+// Value to JSON (stringify):
+//   - array -> JSON array, struct is written as array of its field values, because
+//     field names are not stored in the assets
+//   - typed array -> JSON array of numbers
+//   - string -> JSON string
+//   - boolean -> true/false
+//   - integer, float, double -> JSON number (NaN and Infinity are written as null)
+//   - date -> number of milliseconds since epoch
+//   - anything else -> null
+//
+// JSON to Value (parse):
+//   - object -> array of struct field values, members are matched to the fields by name
+//     using the ObjectSchema (see below), missing members are undefined and unknown are skipped,
+//     object without the schema is an error because member order is not guaranteed
+//   - array -> array
+//   - string -> string, slice of the JSON string when there are no escape sequences
+//   - number -> integer if it fits into int32, otherwise double
+//   - true/false -> boolean
+//   - null -> null
+//
+// Both functions return error value in case of invalid input or too deep nesting.
+// JSON is read in a single pass, stringify writes the value twice: to count the bytes and
+// then to the exactly sized string.
+
+// Field names of the struct, because they are not stored in the assets. fieldSchemas can be
+// nullptr, otherwise it has numFields entries with the schema of the object in that field
+// (nullptr if field is not an object). Schema of the array is applied to its elements.
+struct ObjectSchema {
+    const char *const *fieldNames;
+    uint32_t numFields;
+    const ObjectSchema *const *fieldSchemas;
+};
+
+Value stringify(const Value &value, uint32_t id);
+Value parse(const Value &jsonStringValue, const ObjectSchema *schema, uint32_t id);
+
+enum TokenType {
+    TOKEN_ERROR,
+    TOKEN_END,
+    TOKEN_BEGIN_OBJECT,
+    TOKEN_END_OBJECT,
+    TOKEN_BEGIN_ARRAY,
+    TOKEN_END_ARRAY,
+    TOKEN_KEY,
+    TOKEN_STRING,
+    TOKEN_NUMBER,
+    TOKEN_TRUE,
+    TOKEN_FALSE,
+    TOKEN_NULL
+};
+
+// Pull reader, validates and tokenizes JSON in place without allocating any memory.
+struct Reader {
+    Reader(const char *json, uint32_t len);
+
+    TokenType next();
+
+    // TOKEN_KEY and TOKEN_STRING (without quotes, escape sequences are not decoded) and TOKEN_NUMBER
+    const char *tokenStart;
+    uint32_t tokenLength;
+    bool tokenHasEscapes;
+
+    // current nesting level
+    int depth;
+
+private:
+    const char *m_json;
+    uint32_t m_len;
+    uint32_t m_pos;
+    uint8_t m_state;
+    bool m_containerIsObject[EEZ_FLOW_JSON_MAX_DEPTH];
+
+    void skipWhitespace();
+    TokenType readValue();
+    TokenType afterValue(TokenType tokenType);
+    TokenType endContainer(TokenType tokenType);
+    bool scanString();
+    bool scanNumber();
+    bool scanLiteral(const char *literal, uint32_t literalLen);
+    TokenType error();
+};
+
+// Decodes JSON string escape sequences, dst must have room for at least len bytes.
+// Returns number of bytes written.
+uint32_t unescapeString(const char *src, uint32_t len, char *dst);
+
+} // namespace json
+} // namespace flow
+} // namespace eez
@@ -27,9 +27,11 @@ using namespace eez::gui;
 #include <eez/flow/flow_defs_v3.h>
 #include <eez/flow/hooks.h>
 #include <eez/flow/watch_list.h>
+#include <eez/flow/timer_wheel.h>
 #include <eez/flow/components.h>
 #include <eez/flow/components/call_action.h>
 #include <eez/flow/components/on_event.h>
+#include <eez/flow/context.h>
 
 #if defined(EEZ_DASHBOARD_API)
 #include <eez/flow/dashboard_api.h>
@@ -38,12 +40,8 @@ using namespace eez::gui;
 namespace eez {
 namespace flow {
 
-GlobalVariables *g_globalVariables = nullptr;
-
 static const unsigned NO_COMPONENT_INDEX = 0xFFFFFFFF;
 
-static bool g_enableThrowError = true;
-
 inline bool isInputEmpty(const Value& inputValue) {
     return inputValue.type == VALUE_TYPE_UNDEFINED && inputValue.int32Value > 0;
 }
@@ -68,15 +66,16 @@ void initGlobalVariables(Assets *assets) {
 
     auto numVars = flowDefinition->globalVariables.count;
 
-    g_globalVariables = (GlobalVariables *) alloc(
+    g_flowContext->globalVariables = (GlobalVariables *) alloc(
         sizeof(GlobalVariables) +
         (numVars > 0 ? numVars - 1 : 0) * sizeof(Value),
         0xcc34ca8e
     );
+    g_flowContext->globalVariables->count = numVars;
 
     for (uint32_t i = 0; i < numVars; i++) {
-		new (g_globalVariables->values + i) Value();
-        g_globalVariables->values[i] = flowDefinition->globalVariables[i]->clone();
+		new (g_flowContext->globalVariables->values + i) Value();
+        g_flowContext->globalVariables->values[i] = flowDefinition->globalVariables[i]->clone();
 	}
 }
 
@@ -157,7 +156,109 @@ static bool pingComponent(FlowState *flowState, unsigned componentIndex, int sou
 }
 
 
-static FlowState *initFlowState(Assets *assets, int flowIndex, FlowState *parentFlowState, int parentComponentIndex, const Value& inputValue) {
+////////////////////////////////////////////////////////////////////////////////
+
+#if !defined(EEZ_FLOW_STATE_SLOTS_INITIAL)
+#define EEZ_FLOW_STATE_SLOTS_INITIAL 32
+#endif
+
+struct FlowStateSlot {
+    FlowState *flowState;
+    // incremented when flow state is freed, so handles of the freed flow state don't match anymore
+    uint32_t generation;
+    uint32_t nextFreeSlotIndex;
+};
+
+static bool growFlowStateSlots() {
+    auto &slotTable = g_flowContext->flowStateSlotTable;
+    uint32_t numSlots = slotTable.numSlots ? 2 * slotTable.numSlots : EEZ_FLOW_STATE_SLOTS_INITIAL;
+
+    auto slots = (FlowStateSlot *)alloc(numSlots * sizeof(FlowStateSlot), 0x1e6a4d93);
+    if (!slots) {
+        return false;
+    }
+
+    if (slotTable.slots) {
+        memcpy(slots, slotTable.slots, slotTable.numSlots * sizeof(FlowStateSlot));
+        free(slotTable.slots);
+    }
+
+    // all new slots are free (free list is empty when table is full)
+    for (uint32_t i = slotTable.numSlots; i < numSlots; i++) {
+        slots[i].flowState = nullptr;
+        slots[i].generation = 1;
+        slots[i].nextFreeSlotIndex = i + 1 < numSlots ? i + 1 : NO_FREE_FLOW_STATE_SLOT;
+    }
+    slotTable.firstFreeSlotIndex = slotTable.numSlots;
+    slotTable.lastFreeSlotIndex = numSlots - 1;
+
+    slotTable.slots = slots;
+    slotTable.numSlots = numSlots;
+
+    return true;
+}
+
+static FlowStateHandle allocFlowStateHandle(FlowState *flowState) {
+    auto &slotTable = g_flowContext->flowStateSlotTable;
+    if (slotTable.firstFreeSlotIndex == NO_FREE_FLOW_STATE_SLOT && !growFlowStateSlots()) {
+        return FlowStateHandle { 0, 0 };
+    }
+
+    auto slotIndex = slotTable.firstFreeSlotIndex;
+    auto &slot = slotTable.slots[slotIndex];
+
+    slotTable.firstFreeSlotIndex = slot.nextFreeSlotIndex;
+    if (slotTable.firstFreeSlotIndex == NO_FREE_FLOW_STATE_SLOT) {
+        slotTable.lastFreeSlotIndex = NO_FREE_FLOW_STATE_SLOT;
+    }
+
+    slot.flowState = flowState;
+
+    return FlowStateHandle { slotIndex, slot.generation };
+}
+
+static void freeFlowStateHandle(const FlowStateHandle &handle) {
+    auto &slotTable = g_flowContext->flowStateSlotTable;
+    if (!getFlowStateFromHandle(handle)) {
+        return;
+    }
+
+    auto &slot = slotTable.slots[handle.slotIndex];
+
+    slot.flowState = nullptr;
+    if (++slot.generation == 0) {
+        slot.generation = 1;
+    }
+
+    // freed slot is appended to the end of the free list, so the same slot (and generation)
+    // is reused as late as possible
+    slot.nextFreeSlotIndex = NO_FREE_FLOW_STATE_SLOT;
+    if (slotTable.lastFreeSlotIndex != NO_FREE_FLOW_STATE_SLOT) {
+        slotTable.slots[slotTable.lastFreeSlotIndex].nextFreeSlotIndex = handle.slotIndex;
+    } else {
+        slotTable.firstFreeSlotIndex = handle.slotIndex;
+    }
+    slotTable.lastFreeSlotIndex = handle.slotIndex;
+}
+
+FlowStateHandle getFlowStateHandle(FlowState *flowState) {
+    return flowState ? flowState->handle : FlowStateHandle { 0, 0 };
+}
+
+FlowState *getFlowStateFromHandle(const FlowStateHandle &handle) {
+    auto &slotTable = g_flowContext->flowStateSlotTable;
+    if (handle.slotIndex < slotTable.numSlots) {
+        auto &slot = slotTable.slots[handle.slotIndex];
+        if (slot.generation == handle.generation) {
+            return slot.flowState;
+        }
+    }
+    return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+static FlowState *initFlowState(Assets *assets, int flowIndex, FlowState *parentFlowState, int parentComponentIndex, const Value& inputValue, bool pingComponents = true) {
 	auto flowDefinition = static_cast<FlowDefinition *>(assets->flowDefinition);
 	auto flow = flowDefinition->flows[flowIndex];
 
@@ -176,6 +277,7 @@ static FlowState *initFlowState(Assets *assets, int flowIndex, FlowState *parent
 	flowState->assets = assets;
 
     flowState->flowStateIndex = (int)((uint8_t *)flowState - ALLOC_BUFFER);
+    flowState->handle = allocFlowStateHandle(flowState);
 	flowState->flow = flowDefinition->flows[flowIndex];
 	flowState->flowIndex = flowIndex;
 	flowState->error = false;
@@ -187,6 +289,9 @@ static FlowState *initFlowState(Assets *assets, int flowIndex, FlowState *parent
 
     flowState->timelinePosition = 0;
 
+    flowState->firstTimer = nullptr;
+    flowState->firstWatch = nullptr;
+
 #if defined(EEZ_FOR_LVGL)
     flowState->lvglWidgetStartIndex = 0;
 #endif
@@ -205,14 +310,14 @@ static FlowState *initFlowState(Assets *assets, int flowIndex, FlowState *parent
 		flowState->parentComponentIndex = parentComponentIndex;
 		flowState->parentComponent = parentComponentIndex == -1 ? nullptr : parentFlowState->flow->components[parentComponentIndex];
 	} else {
-        if (g_lastFlowState) {
-            g_lastFlowState->nextSibling = flowState;
-            flowState->previousSibling = g_lastFlowState;
-            g_lastFlowState = flowState;
+        if (g_flowContext->lastFlowState) {
+            g_flowContext->lastFlowState->nextSibling = flowState;
+            flowState->previousSibling = g_flowContext->lastFlowState;
+            g_flowContext->lastFlowState = flowState;
         } else {
             flowState->previousSibling = nullptr;
-            g_firstFlowState = flowState;
-            g_lastFlowState = flowState;
+            g_flowContext->firstFlowState = flowState;
+            g_flowContext->lastFlowState = flowState;
         }
 
 		flowState->parentComponentIndex = -1;
@@ -252,9 +357,11 @@ static FlowState *initFlowState(Assets *assets, int flowIndex, FlowState *parent
 
 	onFlowStateCreated(flowState);
 
-	for (unsigned componentIndex = 0; componentIndex < flow->components.count; componentIndex++) {
-		pingComponent(flowState, componentIndex);
-	}
+    if (pingComponents) {
+        for (unsigned componentIndex = 0; componentIndex < flow->components.count; componentIndex++) {
+            pingComponent(flowState, componentIndex);
+        }
+    }
 
 	return flowState;
 }
@@ -275,6 +382,14 @@ FlowState *initPageFlowState(Assets *assets, int flowIndex, FlowState *parentFlo
 	return flowState;
 }
 
+FlowState *initRestoredFlowState(Assets *assets, int flowIndex, bool isAction, FlowState *parentFlowState, int parentComponentIndex) {
+	auto flowState = initFlowState(assets, flowIndex, parentFlowState, parentComponentIndex, Value(), false);
+	if (flowState) {
+		flowState->isAction = isAction;
+	}
+	return flowState;
+}
+
 void incRefCounterForFlowState(FlowState *flowState) {
     if (!flowState) {
         return;
@@ -325,11 +440,11 @@ void freeFlowState(FlowState *flowState) {
             parentFlowState->lastChild = flowState->previousSibling;
         }
     } else {
-        if (g_firstFlowState == flowState) {
-            g_firstFlowState = flowState->nextSibling;
+        if (g_flowContext->firstFlowState == flowState) {
+            g_flowContext->firstFlowState = flowState->nextSibling;
         }
-        if (g_lastFlowState == flowState) {
-            g_lastFlowState = flowState->previousSibling;
+        if (g_flowContext->lastFlowState == flowState) {
+            g_flowContext->lastFlowState = flowState->previousSibling;
         }
     }
 
@@ -352,8 +467,11 @@ void freeFlowState(FlowState *flowState) {
         deallocateComponentExecutionState(flowState, i);
 	}
 
-    removeTasksFromQueueForFlowState(flowState);
-    removeWatchesForFlowState(flowState);
+    freeFlowStateTimers(flowState);
+    freeFlowStateWatches(flowState);
+
+    // queue entries of this flow state are dropped when visited
+    freeFlowStateHandle(flowState->handle);
 
     freeAllChildrenFlowStates(flowState->firstChild);
 
@@ -445,6 +563,25 @@ void propagateValue(FlowState *flowState, unsigned componentIndex, unsigned outp
 	propagateValue(flowState, componentIndex, outputIndex, nullValue);
 }
 
+void propagateSamples(FlowState *flowState, unsigned componentIndex, unsigned outputIndex, TypedArrayElementType elementType,
+    const void *samples, uint32_t numSamples, const void *samples2, uint32_t numSamples2)
+{
+    auto value = Value::makeTypedArrayRef(elementType, numSamples + numSamples2, nullptr, 0x6b2e9f14);
+    if (value.type == VALUE_TYPE_NULL) {
+        throwError(flowState, componentIndex, "Out of memory for samples\n");
+        return;
+    }
+
+    auto elementSize = getTypedArrayElementSize(elementType);
+    auto data = (uint8_t *)value.getTypedArray()->data;
+    memcpy(data, samples, numSamples * elementSize);
+    if (numSamples2 > 0) {
+        memcpy(data + numSamples * elementSize, samples2, numSamples2 * elementSize);
+    }
+
+    propagateValue(flowState, componentIndex, outputIndex, value);
+}
+
 void propagateValueThroughSeqout(FlowState *flowState, unsigned componentIndex) {
 	// find @seqout output
 	// TODO optimization hint: always place @seqout at 0-th index
@@ -506,6 +643,9 @@ void assignValue(FlowState *flowState, int componentIndex, Value &dstValue, cons
         uint32_t dstValueType = VALUE_TYPE_UNDEFINED;
 
         if (dstValue.getType() == VALUE_TYPE_ARRAY_ELEMENT_VALUE) {
+            // array can be referenced from many variables
+            markAllWatchesDirty();
+
             auto arrayElementValue = (ArrayElementValue *)dstValue.refValue;
             if (arrayElementValue->arrayValue.isBlob()) {
                 auto blobRef = arrayElementValue->arrayValue.getBlob();
@@ -527,6 +667,17 @@ void assignValue(FlowState *flowState, int componentIndex, Value &dstValue, cons
                     // TODO: onValueChanged
                 }
                 return;
+            } else if (arrayElementValue->arrayValue.isTypedArray()) {
+                auto typedArrayRef = arrayElementValue->arrayValue.getTypedArray();
+                if (arrayElementValue->elementIndex < 0 || arrayElementValue->elementIndex >= (int)typedArrayRef->size) {
+                    throwError(flowState, componentIndex, FlowError::Plain("Can not assign, typed array element index out of bounds"));
+                    return;
+                }
+
+                if (!typedArrayRef->setElement(arrayElementValue->elementIndex, srcValue)) {
+                    throwError(flowState, componentIndex, FlowError::Plain("Can not assign, value out of typed array element range"));
+                }
+                return;
             } else {
                 auto array = arrayElementValue->arrayValue.getArray();
                 if (arrayElementValue->elementIndex < 0 || arrayElementValue->elementIndex >= (int)array->arraySize) {
@@ -582,6 +733,7 @@ void assignValue(FlowState *flowState, int componentIndex, Value &dstValue, cons
 
             if (pDstValue->type == VALUE_TYPE_VALUE_PTR) {
                 onValueChanged(pDstValue);
+                markWatchesDirty(pDstValue);
                 pDstValue = pDstValue->pValueValue;
             } else {
                 break;
@@ -590,6 +742,7 @@ void assignValue(FlowState *flowState, int componentIndex, Value &dstValue, cons
 
         if (assignValue(*pDstValue, srcValue, dstValueType)) {
             onValueChanged(pDstValue);
+            markWatchesDirty(pDstValue);
         } else {
             char errorMessage[100];
             snprintf(errorMessage, sizeof(errorMessage), "Can not assign %s to %s\n",
@@ -619,7 +772,7 @@ void startAsyncExecution(FlowState *flowState, int componentIndex) {
 }
 
 void endAsyncExecution(FlowState *flowState, int componentIndex) {
-    if (!g_firstFlowState) {
+    if (!g_flowContext->firstFlowState) {
         // flow engine is stopped
         return;
     }
@@ -692,7 +845,7 @@ static bool findCatchErrorComponent(FlowState *flowState, FlowState *&catchError
 void throwError(FlowState *flowState, int componentIndex, const char *errorMessage) {
     auto component = flowState->flow->components[componentIndex];
 
-    if (!g_enableThrowError) {
+    if (!g_flowContext->enableThrowError) {
         return;
     }
 
@@ -854,7 +1007,7 @@ void throwError(FlowState *flowState, int componentIndex, const FlowError &error
 }
 
 void enableThrowError(bool enable) {
-    g_enableThrowError = enable;
+    g_flowContext->enableThrowError = enable;
 }
 
 } // namespace flow
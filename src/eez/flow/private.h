@@ -14,6 +14,8 @@
 #include <eez/core/assets.h>
 #include <eez/core/value.h>
 
+#include <eez/flow/flow.h>
+
 #if EEZ_OPTION_GUI
 #include <eez/gui/gui.h>
 using namespace eez::gui;
@@ -27,8 +29,6 @@ struct GlobalVariables {
     Value values[1];
 };
 
-extern struct GlobalVariables *g_globalVariables;
-
 void initGlobalVariables(Assets *assets);
 
 static const int UNDEFINED_VALUE_INDEX = 0;
@@ -46,6 +46,9 @@ struct ComponenentExecutionState {
 	virtual ~ComponenentExecutionState() {}
 };
 
+struct TimerNode;
+struct WatchListNode;
+
 struct CatchErrorComponenentExecutionState : public ComponenentExecutionState {
 	Value message;
 };
@@ -54,6 +57,7 @@ struct FlowState {
 	Assets *assets;
 
     uint32_t flowStateIndex;
+    FlowStateHandle handle;
 	Flow *flow;
 	uint16_t flowIndex;
 	bool isAction;
@@ -89,14 +93,21 @@ struct FlowState {
     FlowState *lastChild;
     FlowState *previousSibling;
     FlowState *nextSibling;
+
+    // timer wheel and watch list nodes of this flow state, freed together with it
+    TimerNode *firstTimer;
+    WatchListNode *firstWatch;
 };
 
 extern int g_selectedLanguage;
-extern FlowState *g_firstFlowState;
-extern FlowState *g_lastFlowState;
 
 FlowState *initActionFlowState(int flowIndex, FlowState *parentFlowState, int parentComponentIndex, const Value &value);
 FlowState *initPageFlowState(Assets *assets, int flowIndex, FlowState *parentFlowState, int parentComponentIndex);
+// used by restoreSnapshot, components are not added to the queue
+FlowState *initRestoredFlowState(Assets *assets, int flowIndex, bool isAction, FlowState *parentFlowState, int parentComponentIndex);
+
+// returns nullptr if flow state is already freed
+FlowState *getFlowStateFromHandle(const FlowStateHandle &handle);
 
 void incRefCounterForFlowState(FlowState *flowState);
 void decRefCounterForFlowState(FlowState *flowState);
@@ -131,6 +142,11 @@ void propagateValue(FlowState *flowState, unsigned componentIndex, unsigned outp
 void propagateValue(FlowState *flowState, unsigned componentIndex, unsigned outputIndex); // propagates null value
 void propagateValueThroughSeqout(FlowState *flowState, unsigned componentIndex); // propagates null value through @seqout (0-th output)
 
+// Propagates block of samples as one typed array value, so connected components are pinged
+// only once for the whole block. Block can be given in two parts, i.e. as a ring buffer view.
+void propagateSamples(FlowState *flowState, unsigned componentIndex, unsigned outputIndex, TypedArrayElementType elementType,
+    const void *samples, uint32_t numSamples, const void *samples2 = nullptr, uint32_t numSamples2 = 0);
+
 #if EEZ_OPTION_GUI
 void getValue(uint16_t dataId, DataOperationEnum operation, const WidgetCursor &widgetCursor, Value &value);
 void setValue(uint16_t dataId, const WidgetCursor &widgetCursor, const Value& value);
@@ -145,9 +161,6 @@ void endAsyncExecution(FlowState *flowState, int componentIndex);
 
 void executeCallAction(FlowState *flowState, unsigned componentIndex, int flowIndex, const Value& value);
 
-extern FlowState *g_executeActionFlowState;
-extern unsigned g_executeActionComponentIndex;
-
 enum FlowEvent {
     FLOW_EVENT_OPEN_PAGE,
     FLOW_EVENT_CLOSE_PAGE,
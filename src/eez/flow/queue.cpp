@@ -11,75 +11,64 @@
 #include <eez/conf-internal.h>
 
 #include <eez/flow/queue.h>
+#include <eez/flow/context.h>
 #include <eez/flow/debugger.h>
 #include <eez/flow/flow_defs_v3.h>
 
 namespace eez {
 namespace flow {
 
-#if !defined(EEZ_FLOW_QUEUE_SIZE)
-#define EEZ_FLOW_QUEUE_SIZE 1000
-#endif
-static const unsigned QUEUE_SIZE = EEZ_FLOW_QUEUE_SIZE;
-static struct {
-	FlowState *flowState;
-	unsigned componentIndex;
-    bool continuousTask;
-} g_queue[QUEUE_SIZE];
-static unsigned g_queueHead;
-static unsigned g_queueTail;
-static unsigned g_queueMax;
-static bool g_queueIsFull = false;
-unsigned g_numNonContinuousTaskInQueue;
-
 void queueReset() {
-	g_queueHead = 0;
-	g_queueTail = 0;
-	g_queueMax  = 0;
-	g_queueIsFull = false;
-    g_numNonContinuousTaskInQueue = 0;
+    auto &queue = g_flowContext->queue;
+	queue.head = 0;
+	queue.tail = 0;
+	queue.max  = 0;
+	queue.isFull = false;
+    queue.numNonContinuousTasks = 0;
 }
 
 size_t getQueueSize() {
-	if (g_queueHead == g_queueTail) {
-		if (g_queueIsFull) {
-			return QUEUE_SIZE;
+    auto &queue = g_flowContext->queue;
+	if (queue.head == queue.tail) {
+		if (queue.isFull) {
+			return EEZ_FLOW_QUEUE_SIZE;
 		}
 		return 0;
 	}
 
-	if (g_queueHead < g_queueTail) {
-		return g_queueTail - g_queueHead;
+	if (queue.head < queue.tail) {
+		return queue.tail - queue.head;
 	}
 
-	return QUEUE_SIZE - g_queueHead + g_queueTail;
+	return EEZ_FLOW_QUEUE_SIZE - queue.head + queue.tail;
 }
 
 size_t getMaxQueueSize() {
-	return g_queueMax;
+	return g_flowContext->queue.max;
 }
 
 bool addToQueue(FlowState *flowState, unsigned componentIndex, int sourceComponentIndex, int sourceOutputIndex, int targetInputIndex, bool continuousTask) {
-	if (g_queueIsFull) {
+    auto &queue = g_flowContext->queue;
+	if (queue.isFull) {
         throwError(flowState, componentIndex, "Execution queue is full\n");
 		return false;
 	}
 
-	g_queue[g_queueTail].flowState = flowState;
-	g_queue[g_queueTail].componentIndex = componentIndex;
-    g_queue[g_queueTail].continuousTask = continuousTask;
+	queue.tasks[queue.tail].flowStateHandle = flowState->handle;
+	queue.tasks[queue.tail].componentIndex = componentIndex;
+    queue.tasks[queue.tail].continuousTask = continuousTask;
 
-	g_queueTail = (g_queueTail + 1) % QUEUE_SIZE;
+	queue.tail = (queue.tail + 1) % EEZ_FLOW_QUEUE_SIZE;
 
-	if (g_queueHead == g_queueTail) {
-		g_queueIsFull = true;
+	if (queue.head == queue.tail) {
+		queue.isFull = true;
 	}
 
 	size_t queueSize = getQueueSize();
-	g_queueMax = g_queueMax < queueSize ? queueSize : g_queueMax;
+	queue.max = queue.max < queueSize ? queueSize : queue.max;
 
     if (!continuousTask) {
-        ++g_numNonContinuousTaskInQueue;
+        ++queue.numNonContinuousTasks;
 	    onAddToQueue(flowState, sourceComponentIndex, sourceOutputIndex, componentIndex, targetInputIndex);
     }
 
@@ -89,45 +78,49 @@ bool addToQueue(FlowState *flowState, unsigned componentIndex, int sourceCompone
 }
 
 bool peekNextTaskFromQueue(FlowState *&flowState, unsigned &componentIndex, bool &continuousTask) {
-	if (g_queueHead == g_queueTail && !g_queueIsFull) {
+    auto &queue = g_flowContext->queue;
+	if (queue.head == queue.tail && !queue.isFull) {
 		return false;
 	}
 
-	flowState = g_queue[g_queueHead].flowState;
-	componentIndex = g_queue[g_queueHead].componentIndex;
-    continuousTask = g_queue[g_queueHead].continuousTask;
+	// nullptr if flow state was freed after the task was added
+	flowState = getFlowStateFromHandle(queue.tasks[queue.head].flowStateHandle);
+	componentIndex = queue.tasks[queue.head].componentIndex;
+    continuousTask = queue.tasks[queue.head].continuousTask;
 
 	return true;
 }
 
 void removeNextTaskFromQueue() {
-	auto flowState = g_queue[g_queueHead].flowState;
+    auto &queue = g_flowContext->queue;
+	auto flowState = getFlowStateFromHandle(queue.tasks[queue.head].flowStateHandle);
     decRefCounterForFlowState(flowState);
 
-    auto continuousTask = g_queue[g_queueHead].continuousTask;
+    auto continuousTask = queue.tasks[queue.head].continuousTask;
 
-	g_queueHead = (g_queueHead + 1) % QUEUE_SIZE;
-	g_queueIsFull = false;
+	queue.head = (queue.head + 1) % EEZ_FLOW_QUEUE_SIZE;
+	queue.isFull = false;
 
     if (!continuousTask) {
-        --g_numNonContinuousTaskInQueue;
+        --queue.numNonContinuousTasks;
 	    onRemoveFromQueue();
     }
 }
 
 bool isInQueue(FlowState *flowState, unsigned componentIndex) {
-	if (g_queueHead == g_queueTail && !g_queueIsFull) {
+    auto &queue = g_flowContext->queue;
+	if (queue.head == queue.tail && !queue.isFull) {
 		return false;
 	}
 
-    unsigned int it = g_queueHead;
+    unsigned int it = queue.head;
     while (true) {
-		if (g_queue[it].flowState == flowState && g_queue[it].componentIndex == componentIndex) {
+		if (queue.tasks[it].flowStateHandle == flowState->handle && queue.tasks[it].componentIndex == componentIndex) {
             return true;
 		}
 
-        it = (it + 1) % QUEUE_SIZE;
-        if (it == g_queueTail) {
+        it = (it + 1) % EEZ_FLOW_QUEUE_SIZE;
+        if (it == queue.tail) {
             break;
         }
 	}
@@ -135,23 +128,5 @@ bool isInQueue(FlowState *flowState, unsigned componentIndex) {
     return false;
 }
 
-void removeTasksFromQueueForFlowState(FlowState *flowState) {
-	if (g_queueHead == g_queueTail && !g_queueIsFull) {
-		return;
-	}
-
-    unsigned int it = g_queueHead;
-    while (true) {
-		if (g_queue[it].flowState == flowState) {
-            g_queue[it].flowState = 0;
-		}
-
-        it = (it + 1) % QUEUE_SIZE;
-        if (it == g_queueTail) {
-            break;
-        }
-	}
-}
-
 } // namespace flow
 } // namespace eez
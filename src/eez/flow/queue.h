@@ -15,10 +15,28 @@
 namespace eez {
 namespace flow {
 
+#if !defined(EEZ_FLOW_QUEUE_SIZE)
+#define EEZ_FLOW_QUEUE_SIZE 1000
+#endif
+
+struct QueueTask {
+	FlowStateHandle flowStateHandle;
+	unsigned componentIndex;
+    bool continuousTask;
+};
+
+struct Queue {
+    QueueTask tasks[EEZ_FLOW_QUEUE_SIZE];
+    unsigned head;
+    unsigned tail;
+    unsigned max;
+    bool isFull;
+    unsigned numNonContinuousTasks;
+};
+
 void queueReset();
 size_t getQueueSize();
 size_t getMaxQueueSize();
-extern unsigned g_numNonContinuousTaskInQueue;
 bool addToQueue(FlowState *flowState, unsigned componentIndex,
     int sourceComponentIndex, int sourceOutputIndex, int targetInputIndex,
     bool continuousTask);
@@ -27,7 +45,5 @@ void removeNextTaskFromQueue();
 
 bool isInQueue(FlowState *flowState, unsigned componentIndex);
 
-void removeTasksFromQueueForFlowState(FlowState *flowState);
-
 } // flow
 } // eez
@@ -0,0 +1,180 @@
+/*
+ * eez-framework
+ *
+ * MIT License
+ * Copyright 2024 Envox d.o.o.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <eez/conf-internal.h>
+
+#include <string.h>
+
+#include <atomic>
+
+#include <eez/flow/sample_buffer.h>
+#include <eez/flow/context.h>
+
+namespace eez {
+namespace flow {
+
+struct SampleBuffer {
+    FlowStateHandle flowStateHandle;
+    unsigned componentIndex;
+    unsigned outputIndex;
+
+    TypedArrayElementType elementType;
+    uint32_t elementSize;
+    uint32_t capacity; // power of two, so the index doesn't jump when the counter wraps around
+    uint8_t *data;
+
+    // Free running counters, written only by the producer (head) or only by the flow thread (tail).
+    std::atomic<uint32_t> head;
+    std::atomic<uint32_t> tail;
+    std::atomic<uint32_t> numDropped;
+
+    SampleBuffer *next;
+};
+
+SampleBuffer *createSampleBuffer(FlowState *flowState, unsigned componentIndex, unsigned outputIndex, TypedArrayElementType elementType, uint32_t capacity) {
+    if (capacity == 0 || capacity > 0x80000000u) {
+        return nullptr;
+    }
+
+    // round up to the power of two
+    uint32_t roundedCapacity = 1;
+    while (roundedCapacity < capacity) {
+        roundedCapacity <<= 1;
+    }
+    capacity = roundedCapacity;
+
+    auto elementSize = getTypedArrayElementSize(elementType);
+    if ((uint64_t)capacity * elementSize > UINT32_MAX) {
+        return nullptr;
+    }
+
+    auto sampleBuffer = ObjectAllocator<SampleBuffer>::allocate(0x47d0e2b8);
+    if (!sampleBuffer) {
+        return nullptr;
+    }
+
+    sampleBuffer->elementSize = elementSize;
+    sampleBuffer->data = (uint8_t *)alloc(capacity * sampleBuffer->elementSize, 0x9c35a1f6);
+    if (!sampleBuffer->data) {
+        ObjectAllocator<SampleBuffer>::deallocate(sampleBuffer);
+        return nullptr;
+    }
+
+    sampleBuffer->flowStateHandle = flowState->handle;
+    sampleBuffer->componentIndex = componentIndex;
+    sampleBuffer->outputIndex = outputIndex;
+    sampleBuffer->elementType = elementType;
+    sampleBuffer->capacity = capacity;
+    sampleBuffer->head = 0;
+    sampleBuffer->tail = 0;
+    sampleBuffer->numDropped = 0;
+
+    sampleBuffer->next = g_flowContext->firstSampleBuffer;
+    g_flowContext->firstSampleBuffer = sampleBuffer;
+
+    return sampleBuffer;
+}
+
+void destroySampleBuffer(SampleBuffer *sampleBuffer) {
+    for (auto pNext = &g_flowContext->firstSampleBuffer; *pNext; pNext = &(*pNext)->next) {
+        if (*pNext == sampleBuffer) {
+            *pNext = sampleBuffer->next;
+            break;
+        }
+    }
+
+    free(sampleBuffer->data);
+    ObjectAllocator<SampleBuffer>::deallocate(sampleBuffer);
+}
+
+void destroyAllSampleBuffers() {
+    for (auto sampleBuffer = g_flowContext->firstSampleBuffer; sampleBuffer; ) {
+        auto nextSampleBuffer = sampleBuffer->next;
+        free(sampleBuffer->data);
+        ObjectAllocator<SampleBuffer>::deallocate(sampleBuffer);
+        sampleBuffer = nextSampleBuffer;
+    }
+    g_flowContext->firstSampleBuffer = nullptr;
+}
+
+uint32_t pushSamples(SampleBuffer *sampleBuffer, const void *samples, uint32_t numSamples) {
+    uint32_t head = sampleBuffer->head.load(std::memory_order_relaxed);
+    uint32_t tail = sampleBuffer->tail.load(std::memory_order_acquire);
+
+    uint32_t numFree = sampleBuffer->capacity - (head - tail);
+    uint32_t numWritten = numSamples < numFree ? numSamples : numFree;
+
+    if (numWritten < numSamples) {
+        sampleBuffer->numDropped.fetch_add(numSamples - numWritten, std::memory_order_relaxed);
+    }
+
+    if (numWritten > 0) {
+        auto elementSize = sampleBuffer->elementSize;
+
+        uint32_t index = head & (sampleBuffer->capacity - 1);
+        uint32_t numFirstPart = sampleBuffer->capacity - index;
+        if (numFirstPart > numWritten) {
+            numFirstPart = numWritten;
+        }
+
+        memcpy(sampleBuffer->data + index * elementSize, samples, numFirstPart * elementSize);
+        memcpy(sampleBuffer->data, (const uint8_t *)samples + numFirstPart * elementSize, (numWritten - numFirstPart) * elementSize);
+
+        sampleBuffer->head.store(head + numWritten, std::memory_order_release);
+    }
+
+    return numWritten;
+}
+
+uint32_t getNumDroppedSamples(SampleBuffer *sampleBuffer) {
+    return sampleBuffer->numDropped.load(std::memory_order_relaxed);
+}
+
+void flushSampleBuffers() {
+    for (auto sampleBuffer = g_flowContext->firstSampleBuffer; sampleBuffer; sampleBuffer = sampleBuffer->next) {
+        uint32_t tail = sampleBuffer->tail.load(std::memory_order_relaxed);
+        uint32_t head = sampleBuffer->head.load(std::memory_order_acquire);
+
+        uint32_t numSamples = head - tail;
+        if (numSamples == 0) {
+            continue;
+        }
+
+        // samples are dropped if flow state doesn't exist anymore
+        auto flowState = getFlowStateFromHandle(sampleBuffer->flowStateHandle);
+        if (flowState) {
+            auto elementSize = sampleBuffer->elementSize;
+
+            uint32_t index = tail & (sampleBuffer->capacity - 1);
+            uint32_t numFirstPart = sampleBuffer->capacity - index;
+            if (numFirstPart > numSamples) {
+                numFirstPart = numSamples;
+            }
+
+            propagateSamples(flowState, sampleBuffer->componentIndex, sampleBuffer->outputIndex, sampleBuffer->elementType,
+                sampleBuffer->data + index * elementSize, numFirstPart,
+                sampleBuffer->data, numSamples - numFirstPart);
+        }
+
+        sampleBuffer->tail.store(head, std::memory_order_release);
+    }
+}
+
+bool hasPendingSamples() {
+    for (auto sampleBuffer = g_flowContext->firstSampleBuffer; sampleBuffer; sampleBuffer = sampleBuffer->next) {
+        if (sampleBuffer->head.load(std::memory_order_relaxed) != sampleBuffer->tail.load(std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace flow
+} // namespace eez
@@ -0,0 +1,41 @@
+/*
+ * eez-framework
+ *
+ * MIT License
+ * Copyright 2024 Envox d.o.o.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <eez/flow/private.h>
+
+namespace eez {
+namespace flow {
+
+// Staging buffer for the samples produced outside of the flow thread (for example by the data
+// acquisition thread). Producer only writes into the lock-free single producer / single consumer
+// ring buffer and never touches flow internals, flow thread moves everything that was pushed
+// since the previous tick to the component output as one typed array (see propagateSamples).
+
+struct SampleBuffer;
+
+// Create and destroy must be called from the flow thread. Capacity is rounded up to the power of two.
+SampleBuffer *createSampleBuffer(FlowState *flowState, unsigned componentIndex, unsigned outputIndex, TypedArrayElementType elementType, uint32_t capacity);
+void destroySampleBuffer(SampleBuffer *sampleBuffer);
+// Frees buffers that were not destroyed by the owner, when flow context is destroyed.
+void destroyAllSampleBuffers();
+
+// Called from the producer thread (only one producer per buffer). Returns the number of samples
+// written, samples that don't fit are dropped and counted.
+uint32_t pushSamples(SampleBuffer *sampleBuffer, const void *samples, uint32_t numSamples);
+uint32_t getNumDroppedSamples(SampleBuffer *sampleBuffer);
+
+// Called from tick()
+void flushSampleBuffers();
+bool hasPendingSamples();
+
+} // flow
+} // eez
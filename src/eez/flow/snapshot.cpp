@@ -0,0 +1,845 @@
+/*
+ * eez-framework
+ *
+ * MIT License
+ * Copyright 2024 Envox d.o.o.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <eez/conf-internal.h>
+
+#include <string.h>
+
+#include <eez/core/alloc.h>
+#include <eez/core/os.h>
+
+#include <eez/flow/flow.h>
+#include <eez/flow/snapshot.h>
+#include <eez/flow/context.h>
+#include <eez/flow/debugger.h>
+#include <eez/flow/timer_wheel.h>
+#include <eez/flow/flow_defs_v3.h>
+
+namespace eez {
+namespace flow {
+
+bool snapshotWatchVariableComponentExecutionState(SnapshotWriter &writer, FlowState *flowState, unsigned componentIndex);
+bool restoreWatchVariableComponentExecutionState(SnapshotReader &reader, FlowState *flowState, unsigned componentIndex);
+bool snapshotCounterComponentExecutionState(SnapshotWriter &writer, FlowState *flowState, unsigned componentIndex);
+bool restoreCounterComponentExecutionState(SnapshotReader &reader, FlowState *flowState, unsigned componentIndex);
+bool snapshotDelayComponentExecutionState(SnapshotWriter &writer, FlowState *flowState, unsigned componentIndex);
+bool restoreDelayComponentExecutionState(SnapshotReader &reader, FlowState *flowState, unsigned componentIndex);
+bool snapshotAnimateComponentExecutionState(SnapshotWriter &writer, FlowState *flowState, unsigned componentIndex);
+bool restoreAnimateComponentExecutionState(SnapshotReader &reader, FlowState *flowState, unsigned componentIndex);
+bool snapshotLoopComponentExecutionState(SnapshotWriter &writer, FlowState *flowState, unsigned componentIndex);
+bool restoreLoopComponentExecutionState(SnapshotReader &reader, FlowState *flowState, unsigned componentIndex);
+bool snapshotInputComponentExecutionState(SnapshotWriter &writer, FlowState *flowState, unsigned componentIndex);
+bool restoreInputComponentExecutionState(SnapshotReader &reader, FlowState *flowState, unsigned componentIndex);
+bool snapshotCatchErrorComponentExecutionState(SnapshotWriter &writer, FlowState *flowState, unsigned componentIndex);
+bool restoreCatchErrorComponentExecutionState(SnapshotReader &reader, FlowState *flowState, unsigned componentIndex);
+#if EEZ_OPTION_GUI
+bool snapshotUserWidgetWidgetComponentExecutionState(SnapshotWriter &writer, FlowState *flowState, unsigned componentIndex);
+bool restoreUserWidgetWidgetComponentExecutionState(SnapshotReader &reader, FlowState *flowState, unsigned componentIndex);
+#endif
+#if defined(EEZ_FOR_LVGL)
+bool snapshotLVGLUserWidgetComponentExecutionState(SnapshotWriter &writer, FlowState *flowState, unsigned componentIndex);
+bool restoreLVGLUserWidgetComponentExecutionState(SnapshotReader &reader, FlowState *flowState, unsigned componentIndex);
+#endif
+
+static const uint32_t SNAPSHOT_MAGIC = 0x53465a45; // "EZFS"
+static const uint32_t SNAPSHOT_VERSION = 2;
+
+// value tag used instead of the value type for the reference value that is already in the image
+static const uint8_t SNAPSHOT_VALUE_BACK_REFERENCE = 0xFF;
+
+static const uint8_t SNAPSHOT_VALUE_PTR_GLOBAL_VARIABLE = 0;
+static const uint8_t SNAPSHOT_VALUE_PTR_FLOW_STATE_VALUE = 1;
+
+static const uint32_t NO_PARENT_FLOW_STATE = 0xFFFFFFFF;
+
+// FNV-1a
+static const uint32_t CHECKSUM_INIT = 2166136261u;
+
+static uint32_t updateChecksum(uint32_t checksum, const uint8_t *data, uint32_t len) {
+    for (uint32_t i = 0; i < len; i++) {
+        checksum = (checksum ^ data[i]) * 16777619u;
+    }
+    return checksum;
+}
+
+static Value *getGlobalVariablePtr(Assets *assets, uint32_t globalVariableIndex) {
+    if (g_flowContext->globalVariables && !assets->external) {
+        return g_flowContext->globalVariables->values + globalVariableIndex;
+    }
+    return assets->flowDefinition->globalVariables[globalVariableIndex];
+}
+
+static uint32_t getNumFlowStateValues(FlowState *flowState) {
+    return flowState->flow->componentInputs.count + flowState->flow->localVariables.count;
+}
+
+static uint32_t findFlowState(FlowState **flowStates, uint32_t numFlowStates, FlowState *flowState) {
+    for (uint32_t i = 0; i < numFlowStates; i++) {
+        if (flowStates[i] == flowState) {
+            return i;
+        }
+    }
+    return NO_PARENT_FLOW_STATE;
+}
+
+// values that don't reference anything, i.e. they are completely stored inside Value
+static bool isPlainValueType(uint8_t type) {
+    switch (type) {
+    case VALUE_TYPE_UNDEFINED:
+    case VALUE_TYPE_NULL:
+    case VALUE_TYPE_BOOLEAN:
+    case VALUE_TYPE_INT8:
+    case VALUE_TYPE_UINT8:
+    case VALUE_TYPE_INT16:
+    case VALUE_TYPE_UINT16:
+    case VALUE_TYPE_INT32:
+    case VALUE_TYPE_UINT32:
+    case VALUE_TYPE_INT64:
+    case VALUE_TYPE_UINT64:
+    case VALUE_TYPE_FLOAT:
+    case VALUE_TYPE_DOUBLE:
+    case VALUE_TYPE_DATE:
+    case VALUE_TYPE_FLOW_OUTPUT:
+    case VALUE_TYPE_ERROR:
+    case VALUE_TYPE_RANGE:
+    case VALUE_TYPE_ENUM:
+    case VALUE_TYPE_IP_ADDRESS:
+    case VALUE_TYPE_TIME_ZONE:
+        return true;
+    default:
+        return false;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void SnapshotWriter::write(const void *data, uint32_t len) {
+    if (buffer && size + len <= bufferSize) {
+        memcpy(buffer + size, data, len);
+    }
+    checksum = updateChecksum(checksum, (const uint8_t *)data, len);
+    size += len;
+}
+
+// Every string, array, blob and typed array gets the next index, in the same order as
+// in SnapshotReader, but only the reference counted ones can be referenced again.
+static bool addWrittenRef(SnapshotWriter &writer, Ref *ref) {
+    if (writer.numRefs == writer.refsCapacity) {
+        auto refsCapacity = writer.refsCapacity ? 2 * writer.refsCapacity : 16;
+        auto refs = (Ref **)alloc(refsCapacity * sizeof(Ref *), 0x93c4e1b6);
+        if (!refs) {
+            return false;
+        }
+        if (writer.refs) {
+            memcpy(refs, writer.refs, writer.numRefs * sizeof(Ref *));
+            free(writer.refs);
+        }
+        writer.refs = refs;
+        writer.refsCapacity = refsCapacity;
+    }
+    writer.refs[writer.numRefs++] = ref;
+    return true;
+}
+
+bool SnapshotWriter::writeValue(const Value &value) {
+    if (isPlainValueType(value.type)) {
+        writeUint8(value.type);
+        writeUint8(value.unit);
+        writeUint16(value.options);
+        writeUint32(value.dstValueType);
+        write(&value.uint64Value, sizeof(value.uint64Value));
+        return true;
+    }
+
+    if (value.isString() || value.isArray() || value.isBlob() || value.isTypedArray()) {
+        Ref *ref = value.options & VALUE_OPTIONS_REF ? value.refValue : nullptr;
+        if (ref) {
+            for (uint32_t i = 0; i < numRefs; i++) {
+                if (refs[i] == ref) {
+                    writeUint8(SNAPSHOT_VALUE_BACK_REFERENCE);
+                    writeUint32(i);
+                    return true;
+                }
+            }
+        }
+
+        if (!addWrittenRef(*this, ref)) {
+            return false;
+        }
+
+        if (value.isString()) {
+            uint32_t len;
+            auto str = value.getStringAndLength(len);
+            writeUint8(VALUE_TYPE_STRING_REF);
+            writeUint32(len);
+            write(str, len);
+        } else if (value.isArray()) {
+            auto array = value.getArray();
+            writeUint8(VALUE_TYPE_ARRAY_REF);
+            writeUint32(array->arraySize);
+            writeUint32(array->arrayType);
+            for (uint32_t i = 0; i < array->arraySize; i++) {
+                if (!writeValue(array->values[i])) {
+                    return false;
+                }
+            }
+        } else if (value.isBlob()) {
+            auto blobRef = value.getBlob();
+            writeUint8(VALUE_TYPE_BLOB_REF);
+            writeUint32(blobRef->len);
+            write(blobRef->blob, blobRef->len);
+        } else {
+            auto typedArrayRef = value.getTypedArray();
+            writeUint8(VALUE_TYPE_TYPED_ARRAY_REF);
+            writeUint8(typedArrayRef->elementType);
+            writeUint32(typedArrayRef->size);
+            write(typedArrayRef->data, typedArrayRef->size * getTypedArrayElementSize(typedArrayRef->elementType));
+        }
+        return true;
+    }
+
+    if (value.type == VALUE_TYPE_VALUE_PTR) {
+        // result of the assignable expression, i.e. it points to the global variable or into the flow state
+        auto assets = g_flowContext->mainAssets;
+        for (uint32_t i = 0; i < assets->flowDefinition->globalVariables.count; i++) {
+            if (getGlobalVariablePtr(assets, i) == value.pValueValue) {
+                writeUint8(VALUE_TYPE_VALUE_PTR);
+                writeUint8(SNAPSHOT_VALUE_PTR_GLOBAL_VARIABLE);
+                writeUint32(i);
+                return true;
+            }
+        }
+
+        for (uint32_t i = 0; i < numFlowStates; i++) {
+            auto flowState = flowStates[i];
+            if (value.pValueValue >= flowState->values && value.pValueValue < flowState->values + getNumFlowStateValues(flowState)) {
+                writeUint8(VALUE_TYPE_VALUE_PTR);
+                writeUint8(SNAPSHOT_VALUE_PTR_FLOW_STATE_VALUE);
+                writeUint32(i);
+                writeUint32((uint32_t)(value.pValueValue - flowState->values));
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    if (value.type == VALUE_TYPE_PROPERTY_REF) {
+        auto propertyRef = (PropertyRef *)value.refValue;
+        auto flowStateIndex = findFlowState(flowStates, numFlowStates, propertyRef->flowState);
+        if (flowStateIndex == NO_PARENT_FLOW_STATE) {
+            return false;
+        }
+        writeUint8(VALUE_TYPE_PROPERTY_REF);
+        writeUint32(flowStateIndex);
+        writeInt32(propertyRef->componentIndex);
+        writeInt32(propertyRef->propertyIndex);
+        return true;
+    }
+
+    // references native object
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool SnapshotReader::read(void *dst, uint32_t len) {
+    if (failed || len > size - position) {
+        failed = true;
+        return false;
+    }
+    memcpy(dst, data + position, len);
+    position += len;
+    return true;
+}
+
+static bool addReadRef(SnapshotReader &reader, const Value &value) {
+    if (reader.numRefs == reader.refsCapacity) {
+        auto refsCapacity = reader.refsCapacity ? 2 * reader.refsCapacity : 16;
+        auto refs = (Value *)alloc(refsCapacity * sizeof(Value), 0x2ad8f57c);
+        if (!refs) {
+            return false;
+        }
+        for (uint32_t i = 0; i < reader.numRefs; i++) {
+            new (refs + i) Value(reader.refs[i]);
+            reader.refs[i].~Value();
+        }
+        if (reader.refs) {
+            free(reader.refs);
+        }
+        reader.refs = refs;
+        reader.refsCapacity = refsCapacity;
+    }
+    new (reader.refs + reader.numRefs++) Value(value);
+    return true;
+}
+
+bool SnapshotReader::readValue(Value &value) {
+    auto type = readUint8();
+    if (failed) {
+        return false;
+    }
+
+    if (type == SNAPSHOT_VALUE_BACK_REFERENCE) {
+        auto refIndex = readUint32();
+        if (failed || refIndex >= numRefs) {
+            return false;
+        }
+        value = refs[refIndex];
+        return true;
+    }
+
+    if (isPlainValueType(type)) {
+        Value plainValue;
+        plainValue.type = type;
+        plainValue.unit = readUint8();
+        plainValue.options = readUint16();
+        plainValue.dstValueType = readUint32();
+        read(&plainValue.uint64Value, sizeof(plainValue.uint64Value));
+        if (failed) {
+            return false;
+        }
+        value = plainValue;
+        return true;
+    }
+
+    if (type == VALUE_TYPE_STRING_REF) {
+        auto len = readUint32();
+        if (failed || len > size - position) {
+            return false;
+        }
+        value = Value::makeStringRef((const char *)data + position, len, 0x7f2b9c48);
+        position += len;
+        return value.type == VALUE_TYPE_STRING_REF && addReadRef(*this, value);
+    }
+
+    if (type == VALUE_TYPE_ARRAY_REF) {
+        auto arraySize = readUint32();
+        auto arrayType = readUint32();
+        // every element takes at least one byte
+        if (failed || arraySize > size - position) {
+            return false;
+        }
+        value = Value::makeArrayRef(arraySize, arrayType, 0xd46a1e3b);
+        if (value.type != VALUE_TYPE_ARRAY_REF || !addReadRef(*this, value)) {
+            return false;
+        }
+        auto array = value.getArray();
+        for (uint32_t i = 0; i < arraySize; i++) {
+            if (!readValue(array->values[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    if (type == VALUE_TYPE_BLOB_REF) {
+        auto len = readUint32();
+        if (failed || len > size - position) {
+            return false;
+        }
+        value = Value::makeBlobRef(data + position, len, 0x58e3c0a9);
+        position += len;
+        return value.type == VALUE_TYPE_BLOB_REF && addReadRef(*this, value);
+    }
+
+    if (type == VALUE_TYPE_TYPED_ARRAY_REF) {
+        auto elementType = readUint8();
+        auto typedArraySize = readUint32();
+        if (failed || elementType > TYPED_ARRAY_ELEMENT_TYPE_UINT8 || typedArraySize > (size - position) / getTypedArrayElementSize(elementType)) {
+            return false;
+        }
+        value = Value::makeTypedArrayRef((TypedArrayElementType)elementType, typedArraySize, data + position, 0xb1f7463e);
+        position += typedArraySize * getTypedArrayElementSize(elementType);
+        return value.type == VALUE_TYPE_TYPED_ARRAY_REF && addReadRef(*this, value);
+    }
+
+    if (type == VALUE_TYPE_VALUE_PTR) {
+        auto kind = readUint8();
+        auto index = readUint32();
+        if (failed) {
+            return false;
+        }
+
+        if (kind == SNAPSHOT_VALUE_PTR_GLOBAL_VARIABLE) {
+            auto assets = g_flowContext->mainAssets;
+            if (index >= assets->flowDefinition->globalVariables.count) {
+                return false;
+            }
+            value = Value(getGlobalVariablePtr(assets, index));
+            return true;
+        }
+
+        auto valueIndex = readUint32();
+        if (failed || kind != SNAPSHOT_VALUE_PTR_FLOW_STATE_VALUE || index >= numFlowStates || valueIndex >= getNumFlowStateValues(flowStates[index])) {
+            return false;
+        }
+        value = Value(flowStates[index]->values + valueIndex);
+        return true;
+    }
+
+    if (type == VALUE_TYPE_PROPERTY_REF) {
+        auto flowStateIndex = readUint32();
+        auto componentIndex = readInt32();
+        auto propertyIndex = readInt32();
+        if (failed || flowStateIndex >= numFlowStates) {
+            return false;
+        }
+        value = Value::makePropertyRef(flowStates[flowStateIndex], componentIndex, propertyIndex, 0x6e0d2f85);
+        return value.type == VALUE_TYPE_PROPERTY_REF;
+    }
+
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+static bool snapshotComponentExecutionState(SnapshotWriter &writer, FlowState *flowState, unsigned componentIndex) {
+    auto component = flowState->flow->components[componentIndex];
+    switch (component->type) {
+    case defs_v3::COMPONENT_TYPE_WATCH_VARIABLE_ACTION:
+        return snapshotWatchVariableComponentExecutionState(writer, flowState, componentIndex);
+    case defs_v3::COMPONENT_TYPE_COUNTER_ACTION:
+        return snapshotCounterComponentExecutionState(writer, flowState, componentIndex);
+    case defs_v3::COMPONENT_TYPE_DELAY_ACTION:
+        return snapshotDelayComponentExecutionState(writer, flowState, componentIndex);
+    case defs_v3::COMPONENT_TYPE_ANIMATE_ACTION:
+        return snapshotAnimateComponentExecutionState(writer, flowState, componentIndex);
+    case defs_v3::COMPONENT_TYPE_LOOP_ACTION:
+        return snapshotLoopComponentExecutionState(writer, flowState, componentIndex);
+    case defs_v3::COMPONENT_TYPE_INPUT_ACTION:
+        return snapshotInputComponentExecutionState(writer, flowState, componentIndex);
+    case defs_v3::COMPONENT_TYPE_CATCH_ERROR_ACTION:
+        return snapshotCatchErrorComponentExecutionState(writer, flowState, componentIndex);
+#if EEZ_OPTION_GUI
+    case defs_v3::COMPONENT_TYPE_USER_WIDGET_WIDGET:
+        return snapshotUserWidgetWidgetComponentExecutionState(writer, flowState, componentIndex);
+#endif
+#if defined(EEZ_FOR_LVGL)
+    case defs_v3::COMPONENT_TYPE_LVGL_USER_WIDGET_WIDGET:
+        return snapshotLVGLUserWidgetComponentExecutionState(writer, flowState, componentIndex);
+#endif
+    default:
+        return false;
+    }
+}
+
+static bool restoreComponentExecutionState(SnapshotReader &reader, FlowState *flowState, unsigned componentIndex) {
+    auto component = flowState->flow->components[componentIndex];
+    switch (component->type) {
+    case defs_v3::COMPONENT_TYPE_WATCH_VARIABLE_ACTION:
+        return restoreWatchVariableComponentExecutionState(reader, flowState, componentIndex);
+    case defs_v3::COMPONENT_TYPE_COUNTER_ACTION:
+        return restoreCounterComponentExecutionState(reader, flowState, componentIndex);
+    case defs_v3::COMPONENT_TYPE_DELAY_ACTION:
+        return restoreDelayComponentExecutionState(reader, flowState, componentIndex);
+    case defs_v3::COMPONENT_TYPE_ANIMATE_ACTION:
+        return restoreAnimateComponentExecutionState(reader, flowState, componentIndex);
+    case defs_v3::COMPONENT_TYPE_LOOP_ACTION:
+        return restoreLoopComponentExecutionState(reader, flowState, componentIndex);
+    case defs_v3::COMPONENT_TYPE_INPUT_ACTION:
+        return restoreInputComponentExecutionState(reader, flowState, componentIndex);
+    case defs_v3::COMPONENT_TYPE_CATCH_ERROR_ACTION:
+        return restoreCatchErrorComponentExecutionState(reader, flowState, componentIndex);
+#if EEZ_OPTION_GUI
+    case defs_v3::COMPONENT_TYPE_USER_WIDGET_WIDGET:
+        return restoreUserWidgetWidgetComponentExecutionState(reader, flowState, componentIndex);
+#endif
+#if defined(EEZ_FOR_LVGL)
+    case defs_v3::COMPONENT_TYPE_LVGL_USER_WIDGET_WIDGET:
+        return restoreLVGLUserWidgetComponentExecutionState(reader, flowState, componentIndex);
+#endif
+    default:
+        return false;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+static uint32_t countFlowStates(FlowState *firstFlowState) {
+    uint32_t count = 0;
+    for (auto flowState = firstFlowState; flowState; flowState = flowState->nextSibling) {
+        count += 1 + countFlowStates(flowState->firstChild);
+    }
+    return count;
+}
+
+// parent is always before its children
+static void addFlowStates(SnapshotWriter &writer, FlowState *firstFlowState) {
+    for (auto flowState = firstFlowState; flowState; flowState = flowState->nextSibling) {
+        writer.flowStates[writer.numFlowStates++] = flowState;
+        addFlowStates(writer, flowState->firstChild);
+    }
+}
+
+static bool writeSnapshot(SnapshotWriter &writer, Assets *assets) {
+    auto flowDefinition = static_cast<FlowDefinition *>(assets->flowDefinition);
+
+    writer.writeUint32(SNAPSHOT_MAGIC);
+    writer.writeUint32(SNAPSHOT_VERSION);
+    writer.writeUint32(flowDefinition->flows.count);
+    writer.writeUint32(flowDefinition->globalVariables.count);
+    writer.writeInt32(g_selectedLanguage);
+
+    // flow states
+    writer.writeUint32(writer.numFlowStates);
+    for (uint32_t i = 0; i < writer.numFlowStates; i++) {
+        auto flowState = writer.flowStates[i];
+
+        if (flowState->assets != assets) {
+            return false;
+        }
+
+        for (uint32_t componentIndex = 0; componentIndex < flowState->flow->components.count; componentIndex++) {
+            if (flowState->componenentAsyncStates[componentIndex]) {
+                return false;
+            }
+        }
+
+        writer.writeUint32(findFlowState(writer.flowStates, i, flowState->parentFlowState));
+        writer.writeInt32(flowState->parentComponentIndex);
+        writer.writeUint16(flowState->flowIndex);
+        writer.writeUint8(flowState->isAction);
+        writer.writeUint8(flowState->error);
+        writer.writeUint8(flowState->deleteOnNextTick);
+        writer.writeFloat(flowState->timelinePosition);
+#if defined(EEZ_FOR_LVGL)
+        writer.writeInt32(flowState->lvglWidgetStartIndex);
+#else
+        writer.writeInt32(0);
+#endif
+    }
+
+    // global variables
+    for (uint32_t i = 0; i < flowDefinition->globalVariables.count; i++) {
+        if (!writer.writeValue(*getGlobalVariablePtr(assets, i))) {
+            return false;
+        }
+    }
+
+    // inputs and local variables
+    for (uint32_t i = 0; i < writer.numFlowStates; i++) {
+        auto flowState = writer.flowStates[i];
+        if (!writer.writeValue(flowState->inputValue)) {
+            return false;
+        }
+        for (uint32_t valueIndex = 0; valueIndex < getNumFlowStateValues(flowState); valueIndex++) {
+            if (!writer.writeValue(flowState->values[valueIndex])) {
+                return false;
+            }
+        }
+    }
+
+    // component execution states, after all the values so they can be evaluated while restored
+    for (uint32_t i = 0; i < writer.numFlowStates; i++) {
+        auto flowState = writer.flowStates[i];
+
+        uint32_t numExecutionStates = 0;
+        for (uint32_t componentIndex = 0; componentIndex < flowState->flow->components.count; componentIndex++) {
+            if (flowState->componenentExecutionStates[componentIndex]) {
+                numExecutionStates++;
+            }
+        }
+
+        writer.writeUint32(numExecutionStates);
+
+        for (uint32_t componentIndex = 0; componentIndex < flowState->flow->components.count; componentIndex++) {
+            if (flowState->componenentExecutionStates[componentIndex]) {
+                writer.writeUint32(componentIndex);
+                if (!snapshotComponentExecutionState(writer, flowState, componentIndex)) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    // timers, stored as the time remaining until the deadline
+    auto now = millis();
+    for (uint32_t i = 0; i < writer.numFlowStates; i++) {
+        auto flowState = writer.flowStates[i];
+
+        uint32_t numTimers = 0;
+        for (auto timer = getNextFlowStateTimer(flowState, nullptr); timer; timer = getNextFlowStateTimer(flowState, timer)) {
+            numTimers++;
+        }
+
+        writer.writeUint32(numTimers);
+
+        for (auto timer = getNextFlowStateTimer(flowState, nullptr); timer; timer = getNextFlowStateTimer(flowState, timer)) {
+            int32_t remaining = (int32_t)(getTimerDeadline(timer) - now);
+            writer.writeUint32(getTimerComponentIndex(timer));
+            writer.writeInt32(remaining > 0 ? remaining : 0);
+        }
+    }
+
+    // queue, tasks of the already freed flow states are skipped
+    auto &queue = g_flowContext->queue;
+    auto queueSize = getQueueSize();
+
+    uint32_t numTasks = 0;
+    for (uint32_t i = 0; i < queueSize; i++) {
+        auto &task = queue.tasks[(queue.head + i) % EEZ_FLOW_QUEUE_SIZE];
+        if (getFlowStateFromHandle(task.flowStateHandle)) {
+            numTasks++;
+        }
+    }
+
+    writer.writeUint32(numTasks);
+
+    for (uint32_t i = 0; i < queueSize; i++) {
+        auto &task = queue.tasks[(queue.head + i) % EEZ_FLOW_QUEUE_SIZE];
+        auto flowState = getFlowStateFromHandle(task.flowStateHandle);
+        if (flowState) {
+            writer.writeUint32(findFlowState(writer.flowStates, writer.numFlowStates, flowState));
+            writer.writeUint32(task.componentIndex);
+            writer.writeUint8(task.continuousTask);
+        }
+    }
+
+    writer.writeUint32(writer.checksum);
+
+    return true;
+}
+
+bool takeSnapshot(uint8_t *buffer, uint32_t bufferSize, uint32_t &snapshotSize) {
+    snapshotSize = 0;
+
+    auto assets = g_flowContext->mainAssets;
+    if (isFlowStopped() || g_flowContext->isStopping || !assets) {
+        return false;
+    }
+
+    SnapshotWriter writer;
+    writer.buffer = buffer;
+    writer.bufferSize = bufferSize;
+    writer.size = 0;
+    writer.checksum = CHECKSUM_INIT;
+    writer.numFlowStates = 0;
+    writer.refs = nullptr;
+    writer.numRefs = 0;
+    writer.refsCapacity = 0;
+
+    auto numFlowStates = countFlowStates(g_flowContext->firstFlowState);
+    writer.flowStates = (FlowState **)alloc((numFlowStates > 0 ? numFlowStates : 1) * sizeof(FlowState *), 0x0c7e5ad2);
+    if (!writer.flowStates) {
+        return false;
+    }
+    addFlowStates(writer, g_flowContext->firstFlowState);
+
+    bool result = writeSnapshot(writer, assets);
+
+    free(writer.flowStates);
+    if (writer.refs) {
+        free(writer.refs);
+    }
+
+    if (!result) {
+        return false;
+    }
+
+    snapshotSize = writer.size;
+    return buffer && writer.size <= bufferSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+static bool readSnapshot(SnapshotReader &reader, Assets *assets) {
+    auto flowDefinition = static_cast<FlowDefinition *>(assets->flowDefinition);
+
+    // flow states
+    auto numFlowStates = reader.readUint32();
+    // flow state takes 21 bytes
+    if (reader.failed || numFlowStates > (reader.size - reader.position) / 21) {
+        return false;
+    }
+
+    reader.flowStates = (FlowState **)alloc((numFlowStates > 0 ? numFlowStates : 1) * sizeof(FlowState *), 0xe59b3740);
+    if (!reader.flowStates) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < numFlowStates; i++) {
+        auto parentFlowStateIndex = reader.readUint32();
+        auto parentComponentIndex = reader.readInt32();
+        auto flowIndex = reader.readUint16();
+        bool isAction = reader.readUint8() != 0;
+        bool error = reader.readUint8() != 0;
+        bool deleteOnNextTick = reader.readUint8() != 0;
+        auto timelinePosition = reader.readFloat();
+        auto lvglWidgetStartIndex = reader.readInt32();
+        if (reader.failed || flowIndex >= flowDefinition->flows.count) {
+            return false;
+        }
+
+        FlowState *parentFlowState = nullptr;
+        if (parentFlowStateIndex != NO_PARENT_FLOW_STATE) {
+            if (parentFlowStateIndex >= i) {
+                return false;
+            }
+            parentFlowState = reader.flowStates[parentFlowStateIndex];
+            if (parentComponentIndex < -1 || parentComponentIndex >= (int)parentFlowState->flow->components.count) {
+                return false;
+            }
+        }
+
+        auto flowState = initRestoredFlowState(assets, flowIndex, isAction, parentFlowState, parentComponentIndex);
+        reader.flowStates[reader.numFlowStates++] = flowState;
+
+        flowState->error = error;
+        flowState->deleteOnNextTick = deleteOnNextTick;
+        flowState->timelinePosition = timelinePosition;
+#if defined(EEZ_FOR_LVGL)
+        flowState->lvglWidgetStartIndex = lvglWidgetStartIndex;
+#else
+        (void)lvglWidgetStartIndex;
+#endif
+    }
+
+    // global variables
+    for (uint32_t i = 0; i < flowDefinition->globalVariables.count; i++) {
+        auto pValue = getGlobalVariablePtr(assets, i);
+        if (!reader.readValue(*pValue)) {
+            return false;
+        }
+        onValueChanged(pValue);
+    }
+
+    // inputs and local variables
+    for (uint32_t i = 0; i < reader.numFlowStates; i++) {
+        auto flowState = reader.flowStates[i];
+        if (!reader.readValue(flowState->inputValue)) {
+            return false;
+        }
+        for (uint32_t valueIndex = 0; valueIndex < getNumFlowStateValues(flowState); valueIndex++) {
+            if (!reader.readValue(flowState->values[valueIndex])) {
+                return false;
+            }
+        }
+    }
+
+    // component execution states
+    for (uint32_t i = 0; i < reader.numFlowStates; i++) {
+        auto flowState = reader.flowStates[i];
+        auto numExecutionStates = reader.readUint32();
+        for (uint32_t j = 0; j < numExecutionStates; j++) {
+            auto componentIndex = reader.readUint32();
+            if (reader.failed || componentIndex >= flowState->flow->components.count) {
+                return false;
+            }
+            if (!restoreComponentExecutionState(reader, flowState, componentIndex)) {
+                return false;
+            }
+        }
+    }
+
+    // timers, re-armed relative to the restore time
+    auto now = millis();
+    for (uint32_t i = 0; i < reader.numFlowStates; i++) {
+        auto flowState = reader.flowStates[i];
+        auto numTimers = reader.readUint32();
+        for (uint32_t j = 0; j < numTimers; j++) {
+            auto componentIndex = reader.readUint32();
+            auto remaining = reader.readInt32();
+            if (reader.failed || componentIndex >= flowState->flow->components.count || remaining < 0) {
+                return false;
+            }
+            if (!addTimer(flowState, componentIndex, now + remaining)) {
+                return false;
+            }
+        }
+    }
+
+    // queue
+    auto numTasks = reader.readUint32();
+    for (uint32_t i = 0; i < numTasks; i++) {
+        auto flowStateIndex = reader.readUint32();
+        auto componentIndex = reader.readUint32();
+        bool continuousTask = reader.readUint8() != 0;
+        if (reader.failed || flowStateIndex >= reader.numFlowStates || componentIndex >= reader.flowStates[flowStateIndex]->flow->components.count) {
+            return false;
+        }
+        if (!addToQueue(reader.flowStates[flowStateIndex], componentIndex, -1, -1, -1, continuousTask)) {
+            return false;
+        }
+    }
+
+    if (reader.failed || reader.position != reader.size) {
+        return false;
+    }
+
+    // watched values are compared with the restored ones, so watches propagate only if something is changed
+    markAllWatchesDirty();
+
+    return true;
+}
+
+bool restoreSnapshot(Assets *assets, const uint8_t *snapshot, uint32_t snapshotSize) {
+    if (!isFlowStopped() || assets->external || snapshotSize < 6 * sizeof(uint32_t)) {
+        return false;
+    }
+
+    uint32_t checksum;
+    memcpy(&checksum, snapshot + snapshotSize - sizeof(uint32_t), sizeof(uint32_t));
+    if (updateChecksum(CHECKSUM_INIT, snapshot, snapshotSize - sizeof(uint32_t)) != checksum) {
+        return false;
+    }
+
+    SnapshotReader reader;
+    reader.data = snapshot;
+    reader.size = snapshotSize - sizeof(uint32_t);
+    reader.position = 0;
+    reader.failed = false;
+    reader.flowStates = nullptr;
+    reader.numFlowStates = 0;
+    reader.refs = nullptr;
+    reader.numRefs = 0;
+    reader.refsCapacity = 0;
+
+    auto flowDefinition = static_cast<FlowDefinition *>(assets->flowDefinition);
+    if (
+        reader.readUint32() != SNAPSHOT_MAGIC ||
+        reader.readUint32() != SNAPSHOT_VERSION ||
+        reader.readUint32() != flowDefinition->flows.count ||
+        reader.readUint32() != flowDefinition->globalVariables.count
+    ) {
+        return false;
+    }
+    auto selectedLanguage = reader.readInt32();
+
+    if (!start(assets)) {
+        return false;
+    }
+
+    bool result = readSnapshot(reader, assets);
+
+    if (reader.flowStates) {
+        free(reader.flowStates);
+    }
+    for (uint32_t i = 0; i < reader.numRefs; i++) {
+        reader.refs[i].~Value();
+    }
+    if (reader.refs) {
+        free(reader.refs);
+    }
+
+    if (!result) {
+        // free everything restored so far
+        stop(assets);
+        tick();
+        return false;
+    }
+
+    g_selectedLanguage = selectedLanguage;
+
+    return true;
+}
+
+} // flow
+} // eez
@@ -0,0 +1,100 @@
+/*
+ * eez-framework
+ *
+ * MIT License
+ * Copyright 2024 Envox d.o.o.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <eez/flow/private.h>
+
+namespace eez {
+namespace flow {
+
+// Snapshot of the complete runtime state of the running flow (current flow context) written into
+// the compact binary image, so the flow can be restored later without executing the init flows,
+// for example for the fast startup or after the crash.
+//
+// Image contains:
+//   - global variables
+//   - all flow states (page, user widget and action flow states) with their input and local variable values
+//   - execution states of the components that keep the state between ticks:
+//     WatchVariable, Counter, Delay, Animate, Loop, Input, CatchError and UserWidget (GUI and LVGL)
+//   - pending timers, stored as the time remaining until the deadline and re-armed on restore
+//   - queue
+//
+// Snapshot can't be taken (takeSnapshot returns false) if:
+//   - flow is not running
+//   - there is a flow state of the external assets
+//   - there is async component or component with execution state not listed above
+//   - some value can't be serialized, i.e. it references native objects (stream, widget, JSON, ...)
+//
+// Strings, arrays, blobs and typed arrays are copied into the image, references to the same
+// object are restored as references to the same object. Event value of the flow state and
+// commands posted to the inbox are not part of the image, sample buffers must be created
+// again after restore. Image uses host byte order, i.e. it is meant to be restored on the same device
+// and with the same assets.
+
+// Pass nullptr buffer to get the required size. If buffer is too small false is
+// returned and snapshotSize is set to the required size.
+bool takeSnapshot(uint8_t *buffer, uint32_t bufferSize, uint32_t &snapshotSize);
+
+// Use instead of start(assets). Flow must be stopped. Returns false if image is not valid or
+// it doesn't match the assets, in that case flow is not started.
+bool restoreSnapshot(Assets *assets, const uint8_t *snapshot, uint32_t snapshotSize);
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct SnapshotWriter {
+    uint8_t *buffer;
+    uint32_t bufferSize;
+    uint32_t size;
+    uint32_t checksum;
+
+    // flow states in the order they are written, used for the values that point into flow state
+    FlowState **flowStates;
+    uint32_t numFlowStates;
+
+    // already written reference values
+    Ref **refs;
+    uint32_t numRefs;
+    uint32_t refsCapacity;
+
+    void write(const void *data, uint32_t len);
+    void writeUint8(uint8_t value) { write(&value, sizeof(value)); }
+    void writeUint16(uint16_t value) { write(&value, sizeof(value)); }
+    void writeUint32(uint32_t value) { write(&value, sizeof(value)); }
+    void writeInt32(int32_t value) { write(&value, sizeof(value)); }
+    void writeFloat(float value) { write(&value, sizeof(value)); }
+    bool writeValue(const Value &value);
+};
+
+struct SnapshotReader {
+    const uint8_t *data;
+    uint32_t size;
+    uint32_t position;
+    bool failed;
+
+    FlowState **flowStates;
+    uint32_t numFlowStates;
+
+    // already read reference values
+    Value *refs;
+    uint32_t numRefs;
+    uint32_t refsCapacity;
+
+    bool read(void *data, uint32_t len);
+    uint8_t readUint8() { uint8_t value = 0; read(&value, sizeof(value)); return value; }
+    uint16_t readUint16() { uint16_t value = 0; read(&value, sizeof(value)); return value; }
+    uint32_t readUint32() { uint32_t value = 0; read(&value, sizeof(value)); return value; }
+    int32_t readInt32() { int32_t value = 0; read(&value, sizeof(value)); return value; }
+    float readFloat() { float value = 0; read(&value, sizeof(value)); return value; }
+    bool readValue(Value &value);
+};
+
+} // flow
+} // eez
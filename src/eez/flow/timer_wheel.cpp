@@ -0,0 +1,319 @@
+/*
+ * eez-framework
+ *
+ * MIT License
+ * Copyright 2024 Envox d.o.o.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <eez/conf-internal.h>
+
+#include <eez/core/os.h>
+
+#include <eez/flow/timer_wheel.h>
+#include <eez/flow/context.h>
+#include <eez/flow/queue.h>
+
+namespace eez {
+namespace flow {
+
+// Level 0 has 1 ms resolution, and the whole wheel covers 2^24 ms (~4.6 hours).
+// Timers with the longer delay are placed at the end of the wheel and re-inserted when they get there.
+static const unsigned TIMER_WHEEL_SLOT_MASK = TIMER_WHEEL_SLOTS - 1;
+static const uint32_t TIMER_WHEEL_MAX_DELAY = (1 << (TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOT_BITS)) - 1;
+
+struct TimerNode {
+    FlowStateHandle flowStateHandle;
+    unsigned componentIndex;
+    uint32_t deadline;
+
+    uint16_t slotIndex;
+    TimerNode *prev;
+    TimerNode *next;
+
+    // list of the timers of the same flow state
+    TimerNode *flowStatePrev;
+    TimerNode *flowStateNext;
+};
+
+// minDelay is 0 only while cascading, then the current level 0 slot is processed right after
+static void linkTimer(TimerNode *node, uint32_t minDelay) {
+    auto &timerWheel = g_flowContext->timerWheel;
+    uint32_t delay = node->deadline - timerWheel.time;
+    if ((int32_t)delay < (int32_t)minDelay) {
+        // already expired, fire at the next processed millisecond
+        delay = minDelay;
+    } else if (delay > TIMER_WHEEL_MAX_DELAY) {
+        delay = TIMER_WHEEL_MAX_DELAY;
+    }
+
+    uint32_t expires = timerWheel.time + delay;
+
+    unsigned level = 0;
+    while (level < TIMER_WHEEL_LEVELS - 1 && delay >= (1u << ((level + 1) * TIMER_WHEEL_SLOT_BITS))) {
+        level++;
+    }
+
+    unsigned slotIndex = level * TIMER_WHEEL_SLOTS + ((expires >> (level * TIMER_WHEEL_SLOT_BITS)) & TIMER_WHEEL_SLOT_MASK);
+
+    node->slotIndex = slotIndex;
+    node->prev = nullptr;
+    node->next = timerWheel.slots[slotIndex];
+    if (node->next) {
+        node->next->prev = node;
+    }
+    timerWheel.slots[slotIndex] = node;
+}
+
+static void unlinkTimer(TimerNode *node) {
+    auto &timerWheel = g_flowContext->timerWheel;
+    if (node->prev) {
+        node->prev->next = node->next;
+    } else {
+        timerWheel.slots[node->slotIndex] = node->next;
+    }
+
+    if (node->next) {
+        node->next->prev = node->prev;
+    }
+}
+
+static void unlinkFlowStateTimer(FlowState *flowState, TimerNode *node) {
+    if (node->flowStatePrev) {
+        node->flowStatePrev->flowStateNext = node->flowStateNext;
+    } else {
+        flowState->firstTimer = node->flowStateNext;
+    }
+
+    if (node->flowStateNext) {
+        node->flowStateNext->flowStatePrev = node->flowStatePrev;
+    }
+}
+
+static void freeTimer(TimerNode *node) {
+    auto &timerWheel = g_flowContext->timerWheel;
+    unlinkTimer(node);
+    free(node);
+    timerWheel.count > 0 ? timerWheel.count-- : 0;
+}
+
+void timerWheelReset() {
+    auto &timerWheel = g_flowContext->timerWheel;
+    for (unsigned slotIndex = 0; slotIndex < TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS; slotIndex++) {
+        for (auto node = timerWheel.slots[slotIndex]; node; ) {
+            auto nextNode = node->next;
+            free(node);
+            node = nextNode;
+        }
+        timerWheel.slots[slotIndex] = nullptr;
+    }
+
+    timerWheel.count = 0;
+    timerWheel.time = millis();
+}
+
+TimerNode *addTimer(FlowState *flowState, unsigned componentIndex, uint32_t deadline) {
+    auto &timerWheel = g_flowContext->timerWheel;
+    auto node = (TimerNode *)alloc(sizeof(TimerNode), 0x5a8f31c2);
+    if (!node) {
+        throwError(flowState, componentIndex, "Out of memory for timer\n");
+        return nullptr;
+    }
+
+    if (timerWheel.count == 0) {
+        // nothing to process, just catch up with the current time
+        timerWheel.time = millis();
+    }
+
+    node->flowStateHandle = flowState->handle;
+    node->componentIndex = componentIndex;
+    node->deadline = deadline;
+
+    linkTimer(node, 1);
+
+    node->flowStatePrev = nullptr;
+    node->flowStateNext = flowState->firstTimer;
+    if (node->flowStateNext) {
+        node->flowStateNext->flowStatePrev = node;
+    }
+    flowState->firstTimer = node;
+
+    incRefCounterForFlowState(flowState);
+    timerWheel.count++;
+
+    return node;
+}
+
+void removeTimer(TimerNode *node) {
+    auto flowState = getFlowStateFromHandle(node->flowStateHandle);
+    if (flowState) {
+        unlinkFlowStateTimer(flowState, node);
+        decRefCounterForFlowState(flowState);
+    }
+    freeTimer(node);
+}
+
+TimerNode *getNextFlowStateTimer(FlowState *flowState, TimerNode *node) {
+    return node ? node->flowStateNext : flowState->firstTimer;
+}
+
+unsigned getTimerComponentIndex(TimerNode *node) {
+    return node->componentIndex;
+}
+
+uint32_t getTimerDeadline(TimerNode *node) {
+    return node->deadline;
+}
+
+void freeFlowStateTimers(FlowState *flowState) {
+    for (auto node = flowState->firstTimer; node; ) {
+        auto nextNode = node->flowStateNext;
+        freeTimer(node);
+        node = nextNode;
+    }
+    flowState->firstTimer = nullptr;
+}
+
+static void cascade(unsigned level) {
+    auto &timerWheel = g_flowContext->timerWheel;
+    unsigned slotIndex = level * TIMER_WHEEL_SLOTS + ((timerWheel.time >> (level * TIMER_WHEEL_SLOT_BITS)) & TIMER_WHEEL_SLOT_MASK);
+
+    auto node = timerWheel.slots[slotIndex];
+    timerWheel.slots[slotIndex] = nullptr;
+
+    while (node) {
+        auto nextNode = node->next;
+        linkTimer(node, 0);
+        node = nextNode;
+    }
+}
+
+// Number of milliseconds until the first slot that must be visited: the first non empty slot
+// of level 0 or the cascade of the first non empty slot of the higher levels.
+static uint32_t getNextSlotDelay() {
+    auto &timerWheel = g_flowContext->timerWheel;
+    uint32_t nextDelay = TIMER_WHEEL_MAX_DELAY + 1;
+
+    for (unsigned level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        unsigned shift = level * TIMER_WHEEL_SLOT_BITS;
+        uint32_t position = timerWheel.time >> shift;
+
+        for (unsigned i = 1; i <= TIMER_WHEEL_SLOTS; i++) {
+            if (timerWheel.slots[level * TIMER_WHEEL_SLOTS + ((position + i) & TIMER_WHEEL_SLOT_MASK)]) {
+                uint32_t delay = ((position + i) << shift) - timerWheel.time;
+                if (delay < nextDelay) {
+                    nextDelay = delay;
+                }
+                break;
+            }
+        }
+    }
+
+    return nextDelay;
+}
+
+void processTimers() {
+    auto &timerWheel = g_flowContext->timerWheel;
+    uint32_t now = millis();
+
+    if (timerWheel.count == 0) {
+        timerWheel.time = now;
+        return;
+    }
+
+    while ((int32_t)(now - timerWheel.time) > 0) {
+        // jump over the empty slots, so long stall doesn't cost one iteration per millisecond
+        uint32_t delay = getNextSlotDelay();
+        if (delay > now - timerWheel.time) {
+            timerWheel.time = now;
+            break;
+        }
+        timerWheel.time += delay;
+
+        // move timers from the higher levels when lower level wraps around
+        for (unsigned level = 1; level < TIMER_WHEEL_LEVELS; level++) {
+            if (timerWheel.time & ((1u << (level * TIMER_WHEEL_SLOT_BITS)) - 1)) {
+                break;
+            }
+            cascade(level);
+        }
+
+        unsigned slotIndex = timerWheel.time & TIMER_WHEEL_SLOT_MASK;
+
+        auto node = timerWheel.slots[slotIndex];
+        timerWheel.slots[slotIndex] = nullptr;
+
+        while (node) {
+            auto nextNode = node->next;
+
+            if ((int32_t)(timerWheel.time - node->deadline) >= 0) {
+                // timers of the freed flow state are already removed, but handle is checked anyway
+                auto flowState = getFlowStateFromHandle(node->flowStateHandle);
+                auto componentIndex = node->componentIndex;
+
+                if (flowState) {
+                    unlinkFlowStateTimer(flowState, node);
+                }
+
+                free(node);
+                timerWheel.count--;
+
+                if (flowState) {
+                    decRefCounterForFlowState(flowState);
+                    addToQueue(flowState, componentIndex, -1, -1, -1, true);
+                }
+            } else {
+                // delay was longer than the wheel can hold
+                linkTimer(node, 1);
+            }
+
+            node = nextNode;
+        }
+
+        if (timerWheel.count == 0) {
+            timerWheel.time = now;
+            break;
+        }
+    }
+}
+
+unsigned getTimersCount() {
+    auto &timerWheel = g_flowContext->timerWheel;
+    return timerWheel.count;
+}
+
+bool getNextTimerDeadline(uint32_t &deadline) {
+    auto &timerWheel = g_flowContext->timerWheel;
+    if (timerWheel.count == 0) {
+        return false;
+    }
+
+    bool found = false;
+
+    // in each level only the first non empty slot after the current position must be checked
+    for (unsigned level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        unsigned shift = level * TIMER_WHEEL_SLOT_BITS;
+        unsigned currentSlot = (timerWheel.time >> shift) & TIMER_WHEEL_SLOT_MASK;
+
+        // slot at the current position was already processed, so it holds the latest deadlines
+        for (unsigned i = 1; i <= TIMER_WHEEL_SLOTS; i++) {
+            auto node = timerWheel.slots[level * TIMER_WHEEL_SLOTS + ((currentSlot + i) & TIMER_WHEEL_SLOT_MASK)];
+            if (node) {
+                for (; node; node = node->next) {
+                    if (!found || (int32_t)(node->deadline - deadline) < 0) {
+                        deadline = node->deadline;
+                        found = true;
+                    }
+                }
+                break;
+            }
+        }
+    }
+
+    return found;
+}
+
+} // namespace flow
+} // namespace eez
@@ -0,0 +1,53 @@
+/*
+ * eez-framework
+ *
+ * MIT License
+ * Copyright 2024 Envox d.o.o.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <eez/flow/private.h>
+
+namespace eez {
+namespace flow {
+
+// Hierarchical timer wheel used by the components that have to wait for some point in time
+// (Delay, Animate, ...). Instead of polling, component registers a deadline and it is added
+// to the queue, as continuous task, only when the deadline expires.
+
+struct TimerNode;
+
+// 4 levels of 64 slots
+static const unsigned TIMER_WHEEL_SLOT_BITS = 6;
+static const unsigned TIMER_WHEEL_SLOTS = 1 << TIMER_WHEEL_SLOT_BITS;
+static const unsigned TIMER_WHEEL_LEVELS = 4;
+
+struct TimerWheel {
+    TimerNode *slots[TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS];
+    uint32_t time;
+    unsigned count;
+};
+
+void timerWheelReset();
+TimerNode *addTimer(FlowState *flowState, unsigned componentIndex, uint32_t deadline);
+void removeTimer(TimerNode *node);
+// called from freeFlowState, doesn't touch the flow state ref counter
+void freeFlowStateTimers(FlowState *flowState);
+
+// Iterates timers of the flow state (pass nullptr to get the first one), used by the snapshot.
+TimerNode *getNextFlowStateTimer(FlowState *flowState, TimerNode *node);
+unsigned getTimerComponentIndex(TimerNode *node);
+uint32_t getTimerDeadline(TimerNode *node);
+void processTimers();
+
+unsigned getTimersCount();
+
+// returns false if there are no timers
+bool getNextTimerDeadline(uint32_t &deadline);
+
+} // flow
+} // eez
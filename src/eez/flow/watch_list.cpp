@@ -11,86 +11,225 @@
 #include <eez/conf-internal.h>
 
 #include <eez/flow/watch_list.h>
+#include <eez/flow/context.h>
 #include <eez/flow/components.h>
 #include <eez/flow/debugger.h>
+#include <eez/flow/expression.h>
+#include <eez/flow/flow_defs_v3.h>
 
 namespace eez {
 namespace flow {
 
 void executeWatchVariableComponent(FlowState *flowState, unsigned componentIndex);
 
+#if !defined(EEZ_FLOW_WATCH_MAX_DEPENDENCIES)
+#define EEZ_FLOW_WATCH_MAX_DEPENDENCIES 8
+#endif
+static const unsigned WATCH_MAX_DEPENDENCIES = EEZ_FLOW_WATCH_MAX_DEPENDENCIES;
+
+// Watch is subscribed to every variable its expression reads,
+// subscriptions are kept in the hash table keyed by the variable address.
+struct WatchSubscription {
+    const Value *pValue;
+    WatchListNode *node;
+    WatchSubscription *next;
+};
+
 struct WatchListNode {
-    FlowState *flowState;
+    FlowStateHandle flowStateHandle;
     unsigned componentIndex;
 
     WatchListNode *prev;
     WatchListNode *next;
-};
 
-struct WatchList {
-    WatchListNode *first;
-    WatchListNode *last;
-    unsigned       size;
+    // list of the watches of the same flow state
+    WatchListNode *flowStatePrev;
+    WatchListNode *flowStateNext;
+
+    // must be evaluated in the next tick
+    bool dirty;
+
+    // expression can't be tracked through the variable writes, so it is evaluated in every tick
+    bool alwaysDirty;
+
+    unsigned numSubscriptions;
+    WatchSubscription subscriptions[WATCH_MAX_DEPENDENCIES];
 };
 
-static WatchList g_watchList;
+static inline unsigned getSubscriptionBucket(const Value *pValue) {
+    return (unsigned)(((uintptr_t)pValue / sizeof(Value)) % WATCH_SUBSCRIPTION_BUCKETS);
+}
+
+static void subscribe(WatchListNode *node, FlowState *flowState) {
+    auto &watchList = g_flowContext->watchList;
+    auto component = flowState->flow->components[node->componentIndex];
+    auto instructions = component->properties[defs_v3::WATCH_VARIABLE_ACTION_COMPONENT_PROPERTY_VARIABLE]->evalInstructions;
+
+    const Value *dependencies[WATCH_MAX_DEPENDENCIES];
+    unsigned numDependencies;
+    if (!getExpressionDependencies(flowState, instructions, dependencies, numDependencies, WATCH_MAX_DEPENDENCIES)) {
+        node->alwaysDirty = true;
+        watchList.numAlwaysDirty++;
+        return;
+    }
+
+    for (unsigned i = 0; i < numDependencies; i++) {
+        auto subscription = &node->subscriptions[i];
+        subscription->pValue = dependencies[i];
+        subscription->node = node;
+
+        auto bucket = getSubscriptionBucket(dependencies[i]);
+        subscription->next = watchList.buckets[bucket];
+        watchList.buckets[bucket] = subscription;
+    }
+    node->numSubscriptions = numDependencies;
+}
+
+static void unsubscribe(WatchListNode *node) {
+    auto &watchList = g_flowContext->watchList;
+    for (unsigned i = 0; i < node->numSubscriptions; i++) {
+        auto subscription = &node->subscriptions[i];
+        for (auto pNext = &watchList.buckets[getSubscriptionBucket(subscription->pValue)]; *pNext; pNext = &(*pNext)->next) {
+            if (*pNext == subscription) {
+                *pNext = subscription->next;
+                break;
+            }
+        }
+    }
+    node->numSubscriptions = 0;
+
+    if (node->alwaysDirty) {
+        node->alwaysDirty = false;
+        watchList.numAlwaysDirty--;
+    }
+
+    if (node->dirty) {
+        node->dirty = false;
+        watchList.numDirty--;
+    }
+}
 
 WatchListNode *watchListAdd(FlowState *flowState, unsigned componentIndex) {
+    auto &watchList = g_flowContext->watchList;
     auto node = (WatchListNode *)alloc(sizeof(WatchListNode), 0x00864d67);
 
-    node->prev = g_watchList.last;
-    if (g_watchList.last != 0) {
-        g_watchList.last->next = node;
+    node->prev = watchList.last;
+    if (watchList.last != 0) {
+        watchList.last->next = node;
     }
-    g_watchList.last = node;
+    watchList.last = node;
 
-    if (g_watchList.first == 0) {
-        g_watchList.first = node;
+    if (watchList.first == 0) {
+        watchList.first = node;
     }
 
     node->next = 0;
 
-    node->flowState = flowState;
+    node->flowStateHandle = flowState->handle;
     node->componentIndex = componentIndex;
 
+    node->flowStatePrev = nullptr;
+    node->flowStateNext = flowState->firstWatch;
+    if (node->flowStateNext) {
+        node->flowStateNext->flowStatePrev = node;
+    }
+    flowState->firstWatch = node;
+
+    node->dirty = false;
+    node->alwaysDirty = false;
+    node->numSubscriptions = 0;
+    subscribe(node, flowState);
+
     incRefCounterForFlowState(flowState);
-    (g_watchList.size)++;
+    (watchList.size)++;
 
     return node;
 }
 
-void watchListRemove(WatchListNode *node) {
+static void freeWatch(WatchListNode *node) {
+    auto &watchList = g_flowContext->watchList;
+    unsubscribe(node);
+
     if (node->prev) {
         node->prev->next = node->next;
     } else {
-        g_watchList.first = node->next;
+        watchList.first = node->next;
     }
 
     if (node->next) {
         node->next->prev = node->prev;
     } else {
-        g_watchList.last = node->prev;
+        watchList.last = node->prev;
     }
 
     free(node);
-    g_watchList.size > 0 ? (g_watchList.size)-- : 0;
+    watchList.size > 0 ? (watchList.size)-- : 0;
+}
+
+void watchListRemove(WatchListNode *node) {
+    auto flowState = getFlowStateFromHandle(node->flowStateHandle);
+    if (flowState) {
+        if (node->flowStatePrev) {
+            node->flowStatePrev->flowStateNext = node->flowStateNext;
+        } else {
+            flowState->firstWatch = node->flowStateNext;
+        }
+
+        if (node->flowStateNext) {
+            node->flowStateNext->flowStatePrev = node->flowStatePrev;
+        }
+    }
+
+    freeWatch(node);
+}
+
+void freeFlowStateWatches(FlowState *flowState) {
+    for (auto node = flowState->firstWatch; node; ) {
+        auto nextNode = node->flowStateNext;
+        freeWatch(node);
+        node = nextNode;
+    }
+    flowState->firstWatch = nullptr;
 }
 
 void visitWatchList() {
-    for (auto node = g_watchList.first; node; ) {
+    auto &watchList = g_flowContext->watchList;
+    bool allDirty = watchList.allDirty;
+    watchList.allDirty = false;
+
+    for (auto node = watchList.first; node; ) {
         auto nextNode = node->next;
 
-        if (canExecuteStep(node->flowState, node->componentIndex)) {
-            executeWatchVariableComponent(node->flowState, node->componentIndex);
+        auto flowState = getFlowStateFromHandle(node->flowStateHandle);
+        if (!flowState) {
+            // flow state was freed
+            watchListRemove(node);
+            node = nextNode;
+            continue;
+        }
+
+        if (node->dirty || node->alwaysDirty || allDirty) {
+            if (canExecuteStep(flowState, node->componentIndex)) {
+                if (node->dirty) {
+                    node->dirty = false;
+                    watchList.numDirty--;
+                }
+                executeWatchVariableComponent(flowState, node->componentIndex);
+            } else if (!node->dirty) {
+                // try again in the next tick
+                node->dirty = true;
+                watchList.numDirty++;
+            }
         }
 
         // If the only reason why flow state is still active is because of this watch then we can remove it.
-        decRefCounterForFlowState(node->flowState);
-        if (canFreeFlowState(node->flowState)) {
-            // remove this watch
-            freeFlowState(node->flowState);
+        decRefCounterForFlowState(flowState);
+        if (canFreeFlowState(flowState)) {
+            // this watch is freed together with the flow state, nextNode is still valid because
+            // any other watch of this flow state (or its children) would keep it referenced
+            freeFlowState(flowState);
         } else {
-            incRefCounterForFlowState(node->flowState);
+            incRefCounterForFlowState(flowState);
         }
 
         node = nextNode;
@@ -98,25 +237,40 @@ void visitWatchList() {
 }
 
 void watchListReset() {
-    for (auto node = g_watchList.first; node;) {
+    auto &watchList = g_flowContext->watchList;
+    for (auto node = watchList.first; node;) {
         auto nextNode = node->next;
         watchListRemove(node);
         node = nextNode;
     }
+    watchList.allDirty = false;
 }
 
-void removeWatchesForFlowState(FlowState *flowState) {
-    for (auto node = g_watchList.first; node;) {
-        auto nextNode = node->next;
-        if (node->flowState == flowState) {
-            watchListRemove(node);
+unsigned getWatchListSize() {
+    auto &watchList = g_flowContext->watchList;
+    return watchList.size;
+}
+
+void markWatchesDirty(const Value *pValue) {
+    auto &watchList = g_flowContext->watchList;
+    for (auto subscription = watchList.buckets[getSubscriptionBucket(pValue)]; subscription; subscription = subscription->next) {
+        if (subscription->pValue == pValue && !subscription->node->dirty) {
+            subscription->node->dirty = true;
+            watchList.numDirty++;
         }
-        node = nextNode;
     }
 }
 
-unsigned getWatchListSize() {
-    return g_watchList.size;
+void markAllWatchesDirty() {
+    auto &watchList = g_flowContext->watchList;
+    if (watchList.size > 0) {
+        watchList.allDirty = true;
+    }
+}
+
+bool hasDirtyWatches() {
+    auto &watchList = g_flowContext->watchList;
+    return watchList.allDirty || watchList.numDirty > 0 || watchList.numAlwaysDirty > 0;
 }
 
 } // namespace flow
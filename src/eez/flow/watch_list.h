@@ -16,14 +16,36 @@ namespace eez {
 namespace flow {
 
 struct WatchListNode;
+struct WatchSubscription;
+
+static const unsigned WATCH_SUBSCRIPTION_BUCKETS = 64;
+
+struct WatchList {
+    WatchListNode *first;
+    WatchListNode *last;
+    unsigned       size;
+
+    unsigned numDirty;
+    unsigned numAlwaysDirty;
+    bool     allDirty;
+
+    WatchSubscription *buckets[WATCH_SUBSCRIPTION_BUCKETS];
+};
 
 WatchListNode *watchListAdd(FlowState *flowState, unsigned componentIndex);
 void watchListRemove(WatchListNode *node);
+// called from freeFlowState, doesn't touch the flow state ref counter
+void freeFlowStateWatches(FlowState *flowState);
 void visitWatchList();
 void watchListReset();
 
-void removeWatchesForFlowState(FlowState *flowState);
 unsigned getWatchListSize();
 
+// Watches are evaluated only when some variable read by the watched expression is changed.
+void markWatchesDirty(const Value *pValue);
+// Use when it is not known which variable is changed, for example when array element is changed.
+void markAllWatchesDirty();
+bool hasDirtyWatches();
+
 } // flow
 } // eez
@@ -125,6 +125,8 @@ void AppContext::doShowPage(int pageId, Page *page, int previousPageId, bool act
         page->pageWillAppear();
     }
 
+    display::setMaxFrameRate(page ? page->getMaxFrameRate() : 0);
+
     m_showPageTime = millis();
 
     onPageChanged(previousPageId, pageId, activePageIsFromStack, previousPageIsStillOnStack);
@@ -23,6 +23,7 @@
 #include <sstream>
 
 #include <eez/core/util.h>
+#include <eez/core/data_source.h>
 
 #include <eez/gui/gui.h>
 
@@ -74,6 +75,40 @@ void deselect(WidgetCursor &widgetCursor, int16_t id, Value &oldValue) {
     DATA_OPERATION_FUNCTION(id, DATA_OPERATION_DESELECT, widgetCursor, oldValue);
 }
 
+void setViewport(const WidgetCursor &widgetCursor, int16_t id, int first, int count) {
+    if (first < 0) {
+        count += first;
+        first = 0;
+    }
+    if (count <= 0) {
+        return;
+    }
+
+    SetViewportParams params = {
+        first,
+        count
+    };
+    Value value(&params, VALUE_TYPE_POINTER);
+    DATA_OPERATION_FUNCTION(id, DATA_OPERATION_SET_VIEWPORT, widgetCursor, value);
+}
+
+void dataSourceOperation(const Value &dataSourceValue, DataOperationEnum operation, const WidgetCursor &widgetCursor, Value &value) {
+    if (!dataSourceValue.isDataSource()) {
+        return;
+    }
+
+    auto dataSourceRef = dataSourceValue.getDataSource();
+
+    if (operation == DATA_OPERATION_GET) {
+        value = dataSourceValue;
+    } else if (operation == DATA_OPERATION_COUNT) {
+        value = (int)dataSourceRef->getNumRows();
+    } else if (operation == DATA_OPERATION_SET_VIEWPORT) {
+        auto params = (SetViewportParams *)value.getVoidPointer();
+        dataSourceRef->setViewport(params->first, params->count);
+    }
+}
+
 void setContext(WidgetCursor &widgetCursor, int16_t id, Value &oldContext, Value &newContext) {
     DATA_OPERATION_FUNCTION(id, DATA_OPERATION_SET_CONTEXT, widgetCursor, oldContext);
     DATA_OPERATION_FUNCTION(id, DATA_OPERATION_GET_CONTEXT, widgetCursor, newContext);
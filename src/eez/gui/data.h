@@ -124,13 +124,26 @@ enum DataOperationEnum {
     DATA_OPERATION_GET_X_SCROLL,
 	DATA_OPERATION_GET_SLOT_AND_SUBCHANNEL_INDEX,
 	DATA_OPERATION_IS_MICRO_AMPER_ALLOWED,
-	DATA_OPERATION_IS_AMPER_ALLOWED
+	DATA_OPERATION_IS_AMPER_ALLOWED,
+    DATA_OPERATION_SET_VIEWPORT
 };
 
 int count(const WidgetCursor &widgetCursor, int16_t id);
 void select(WidgetCursor &widgetCursor, int16_t id, int index, Value &oldValue);
 void deselect(WidgetCursor &widgetCursor, int16_t id, Value &oldValue);
 
+// List and Grid report which items are visible before they are enumerated,
+// so the virtualised data source (see DataSourceRef) can fetch them in advance
+struct SetViewportParams {
+    int first;
+    int count;
+};
+void setViewport(const WidgetCursor &widgetCursor, int16_t id, int first, int count);
+
+// handles COUNT and SET_VIEWPORT operations for the native data bound to the DataSourceRef value,
+// items should use dataSourceValue.getDataSource()->getRow(widgetCursor.cursor)
+void dataSourceOperation(const Value &dataSourceValue, DataOperationEnum operation, const WidgetCursor &widgetCursor, Value &value);
+
 void setContext(WidgetCursor &widgetCursor, int16_t id, Value &oldContext, Value &newContext);
 void restoreContext(WidgetCursor &widgetCursor, int16_t id, Value &oldContext);
 
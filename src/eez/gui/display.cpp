@@ -15,6 +15,10 @@
 #include <stdio.h>
 #include <string.h>
 
+#ifdef GUI_CALC_FPS
+#include <algorithm>
+#endif
+
 #include <eez/core/utf8.h>
 
 #include <eez/core/util.h>
@@ -31,9 +35,37 @@
 #include <eez/gui/thread.h>
 
 #include <eez/gui/display-private.h>
+#include <eez/gui/mask_cache.h>
+
+#include <agg_conv_stroke.h>
+#include <agg_pixfmt_gray.h>
+#include <agg_rasterizer_scanline_aa.h>
+#include <agg_renderer_base.h>
+#include <agg_renderer_scanline.h>
+#include <agg_rounded_rect.h>
+#include <agg_scanline_u.h>
 
 #define CONF_BACKDROP_OPACITY 128
 
+// default frame rate cap, pages can lower it (see Page::getMaxFrameRate)
+#if !defined(EEZ_GUI_MAX_FRAME_RATE)
+#define EEZ_GUI_MAX_FRAME_RATE 60
+#endif
+
+// if nothing changed on the screen for this long, the screen is checked
+// for changes only every EEZ_GUI_IDLE_FRAME_PERIOD_MS
+#if !defined(EEZ_GUI_IDLE_TIMEOUT_MS)
+#define EEZ_GUI_IDLE_TIMEOUT_MS 500
+#endif
+
+#if !defined(EEZ_GUI_IDLE_FRAME_PERIOD_MS)
+#define EEZ_GUI_IDLE_FRAME_PERIOD_MS 50
+#endif
+
+#if !defined(EEZ_GUI_DISPLAY_OFF_FRAME_PERIOD_MS)
+#define EEZ_GUI_DISPLAY_OFF_FRAME_PERIOD_MS 16
+#endif
+
 using namespace eez::gui;
 
 namespace eez {
@@ -140,12 +172,18 @@ uint32_t g_fpsAvg;
 static uint32_t g_fpsTotal;
 static uint32_t g_lastTimeFPS;
 
+FrameStats g_frameStats;
+static uint32_t g_frameTimeValues[NUM_FPS_VALUES];
+static uint32_t g_frameTimeTotal;
+
 void calcFPS() {
     // calculate last FPS value
 	g_fpsTotal -= g_fpsValues[0];
+	g_frameTimeTotal -= g_frameTimeValues[0];
 
 	for (size_t i = 1; i < NUM_FPS_VALUES; i++) {
 		g_fpsValues[i - 1] = g_fpsValues[i];
+		g_frameTimeValues[i - 1] = g_frameTimeValues[i];
 	}
 
 	uint32_t time = millis();
@@ -159,6 +197,60 @@ void calcFPS() {
 
 	g_fpsTotal += g_fpsValues[NUM_FPS_VALUES - 1];
 	g_fpsAvg = g_fpsTotal / NUM_FPS_VALUES;
+
+    // frame time statistics
+    g_frameTimeValues[NUM_FPS_VALUES - 1] = diff;
+    g_frameTimeTotal += diff;
+
+    g_frameStats.lastFrameTime = diff;
+    g_frameStats.avgFrameTime = g_frameTimeTotal / NUM_FPS_VALUES;
+    g_frameStats.maxFrameTime = 0;
+	for (size_t i = 0; i < NUM_FPS_VALUES; i++) {
+        if (g_frameTimeValues[i] > g_frameStats.maxFrameTime) {
+            g_frameStats.maxFrameTime = g_frameTimeValues[i];
+        }
+    }
+}
+
+#define NUM_INPUT_LATENCY_SAMPLES 128
+
+static uint32_t g_inputLatencySamples[NUM_INPUT_LATENCY_SAMPLES];
+static uint32_t g_numInputLatencySamples;
+static uint32_t g_oldestInputTime;
+static bool g_inputPending;
+
+void noteInputEvent(uint32_t time) {
+    // remember the oldest input event not yet reflected on the display
+    if (!g_inputPending || int32_t(time - g_oldestInputTime) < 0) {
+        g_oldestInputTime = time;
+        g_inputPending = true;
+    }
+}
+
+static void reflectInputEvents(uint32_t time) {
+    if (g_inputPending) {
+        g_inputLatencySamples[g_numInputLatencySamples % NUM_INPUT_LATENCY_SAMPLES] = time - g_oldestInputTime;
+        g_numInputLatencySamples++;
+        g_inputPending = false;
+    }
+}
+
+void getInputLatencyStats(InputLatencyStats &stats) {
+    uint32_t samples[NUM_INPUT_LATENCY_SAMPLES];
+
+    auto n = std::min(g_numInputLatencySamples, (uint32_t)NUM_INPUT_LATENCY_SAMPLES);
+    memcpy(samples, g_inputLatencySamples, n * sizeof(uint32_t));
+    std::sort(samples, samples + n);
+
+    stats.numSamples = g_numInputLatencySamples;
+    if (n > 0) {
+        stats.p50 = samples[n * 50 / 100];
+        stats.p90 = samples[n * 90 / 100];
+        stats.p99 = samples[n * 99 / 100];
+        stats.max = samples[n - 1];
+    } else {
+        stats.p50 = stats.p90 = stats.p99 = stats.max = 0;
+    }
 }
 
 void drawFpsGraph(int x, int y, int w, int h, const Style *style) {
@@ -197,11 +289,84 @@ void drawFpsGraph(int x, int y, int w, int h, const Style *style) {
 
 		display::drawVLine(x, y, y2 - y);
 	}
+
+    // mark the frame rate cap of the active page
+    auto maxFrameRate = getMaxFrameRate();
+    if (maxFrameRate < 60) {
+        display::setColor(style->color);
+        y = y2 - maxFrameRate * (y2 - y1) / 60;
+        for (x = x1; x <= x2; x += 2) {
+            display::drawPixel(x, y);
+        }
+    }
 }
 #endif
 
 ////////////////////////////////////////////////////////////////////////////////
 
+static uint32_t g_maxFrameRate;
+static uint32_t g_nextFrameTime;
+static uint32_t g_lastChangeTime;
+static bool g_frameRequested;
+static bool g_frameDeferred;
+
+void setMaxFrameRate(uint32_t maxFrameRate) {
+    g_maxFrameRate = maxFrameRate;
+}
+
+uint32_t getMaxFrameRate() {
+    return g_maxFrameRate > 0 && g_maxFrameRate < EEZ_GUI_MAX_FRAME_RATE ? g_maxFrameRate : EEZ_GUI_MAX_FRAME_RATE;
+}
+
+void requestFrame() {
+    g_frameRequested = true;
+    g_lastChangeTime = millis();
+}
+
+static uint32_t getFramePeriod(uint32_t time) {
+    uint32_t framePeriod = 1000 / getMaxFrameRate();
+    if (time - g_lastChangeTime > EEZ_GUI_IDLE_TIMEOUT_MS && framePeriod < EEZ_GUI_IDLE_FRAME_PERIOD_MS) {
+        framePeriod = EEZ_GUI_IDLE_FRAME_PERIOD_MS;
+    }
+    return framePeriod;
+}
+
+static bool isFrameDue(uint32_t time) {
+    if (g_frameRequested || g_takeScreenshot) {
+        return true;
+    }
+
+#if EEZ_OPTION_GUI_ANIMATIONS
+    if (g_animationState.enabled) {
+        return true;
+    }
+#endif
+
+    // allow 1 ms of slack because of the millis() granularity
+    return int32_t(time + 1 - g_nextFrameTime) >= 0;
+}
+
+uint32_t getFrameTimeout(uint32_t timeout) {
+    if (g_frameDeferred) {
+        int32_t diff = int32_t(g_nextFrameTime - millis());
+        if (diff <= 0 || g_frameRequested) {
+            return 0;
+        }
+        if ((uint32_t)diff < timeout) {
+            return (uint32_t)diff;
+        }
+    }
+    return timeout;
+}
+
+void updateDeferredFrame() {
+    if (g_frameDeferred && isFrameDue(millis())) {
+        update();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 #if EEZ_OPTION_GUI_ANIMATIONS
 static void finishAnimation() {
     g_animationState.enabled = false;
@@ -265,6 +430,22 @@ static void animateStep() {
 #endif
 
 void update() {
+    uint32_t time = millis();
+
+    if (!isFrameDue(time)) {
+        // nothing to do until the next frame, GUI thread will call
+        // updateDeferredFrame when it is due
+        g_frameDeferred = true;
+#ifdef GUI_CALC_FPS
+        g_frameStats.numSkippedFrames++;
+#endif
+        return;
+    }
+
+    g_frameDeferred = false;
+    g_frameRequested = false;
+    g_nextFrameTime = time + getFramePeriod(time);
+
     if (g_displayState == TURNING_ON) {
 		g_hooks.turnOnDisplayTick();
     } else if (g_displayState == TURNING_OFF) {
@@ -277,24 +458,36 @@ void update() {
 		#endif
 
 #if !defined(EEZ_PLATFORM_SIMULATOR)
-		#if EEZ_OPTION_THREADS
-        	osDelay(16);
-        	sendMessageToGuiThread(GUI_QUEUE_MESSAGE_TYPE_DISPLAY_VSYNC, 0, 0);
-		#endif
-
+        // there is no vsync while display is off, wait for the next frame
+        // without blocking GUI thread
+        g_nextFrameTime = time + EEZ_GUI_DISPLAY_OFF_FRAME_PERIOD_MS;
+        g_frameDeferred = true;
         return;
 #endif
     }
 
 #ifdef GUI_CALC_FPS
-	g_lastTimeFPS = millis();
+	g_lastTimeFPS = time;
 #endif
 
     display::beginRendering();
     updateScreen();
     display::endRendering();
 
+    evictMappedAssetsSections();
+
+    if (isDirty()) {
+        g_lastChangeTime = time;
+    }
+
 #ifdef GUI_CALC_FPS
+    if (isDirty()) {
+        g_frameStats.numRenderedFrames++;
+    } else {
+        g_frameStats.numUnchangedFrames++;
+    }
+    g_frameStats.framePeriod = g_nextFrameTime - time;
+
     if (g_calcFpsEnabled) {
         calcFPS();
     }
@@ -317,6 +510,11 @@ void update() {
 #if EEZ_OPTION_GUI_ANIMATIONS
     }
 #endif
+
+#ifdef GUI_CALC_FPS
+    // this frame is now on the display
+    reflectInputEvents(millis());
+#endif
 }
 
 const uint8_t *takeScreenshot() {
@@ -454,12 +652,17 @@ void endRendering() {
 #if OPTION_MOUSE
         mouse::updateDisplay();
 #endif
-    } else {
-        if (g_syncedBuffer == g_renderBuffer1) {
-            bitBlt(g_renderBuffer1, 0, 0, getDisplayWidth() - 1, getDisplayHeight() - 1);
-        } else if (g_syncedBuffer == g_renderBuffer2) {
-            bitBlt(g_renderBuffer2, 0, 0, getDisplayWidth() - 1, getDisplayHeight() - 1);
+    } else if (g_syncedBuffer == g_renderBuffer1 || g_syncedBuffer == g_renderBuffer2) {
+#if EEZ_OPTION_GUI_ANIMATIONS
+        if (g_animationState.enabled) {
+            // animation needs both render buffers
+            bitBlt(g_syncedBuffer, 0, 0, getDisplayWidth() - 1, getDisplayHeight() - 1);
+            return;
         }
+#endif
+        // nothing changed, keep presenting the synced buffer instead of
+        // copying it to the other render buffer
+        g_renderBuffer = g_syncedBuffer;
     }
 }
 
@@ -783,6 +986,99 @@ void fillRect(
     fillRect(x1, y1, x2, y2);
 }
 
+static void rasteriseRoundedRectMask(const MaskKey &key, uint8_t *mask) {
+    agg::rendering_buffer rbuf(mask, key.width, key.height, key.width);
+    agg::pixfmt_gray8 pixf(rbuf);
+    agg::renderer_base<agg::pixfmt_gray8> rb(pixf);
+
+    agg::rasterizer_scanline_aa<> ras;
+    ras.gamma(agg::gamma_none());
+    agg::scanline_u8 sl;
+
+    // same geometry as Agg2D::roundedRect in fillRoundedRect
+    double lineWidth = key.params[0];
+
+    agg::rounded_rect rc;
+    rc.rect(lineWidth / 2.0, lineWidth / 2.0, key.width - lineWidth, key.height - lineWidth);
+    rc.radius(
+        key.params[1], key.params[2], key.params[3], key.params[4],
+        key.params[7], key.params[8], key.params[5], key.params[6]
+    );
+    rc.normalize_radius();
+    rc.approximation_scale(2.0);
+
+    if (key.type == MASK_TYPE_ROUNDED_RECT_FILL) {
+        ras.add_path(rc);
+    } else {
+        agg::conv_stroke<agg::rounded_rect> stroke(rc);
+        stroke.width(lineWidth);
+        stroke.line_cap(agg::round_cap);
+        stroke.line_join(agg::round_join);
+        stroke.approximation_scale(2.0);
+        ras.add_path(stroke);
+    }
+
+    agg::render_scanlines_aa_solid(ras, sl, rb, agg::gray8(255));
+}
+
+static bool fillRoundedRectFromMaskCache(
+    int x1, int y1, int x2, int y2,
+    int lineWidth,
+    int rtlx, int rtly, int rtrx, int rtry,
+    int rbrx, int rbry, int rblx, int rbly,
+    bool drawLine, bool fill,
+    int clip_x1, int clip_y1, int clip_x2, int clip_y2
+) {
+    // mask blit doesn't support opacity on all platforms
+    if (g_opacity != 255) {
+        return false;
+    }
+
+    MaskKey key;
+    key.width = x2 - x1 + 1;
+    key.height = y2 - y1 + 1;
+    key.params[0] = lineWidth;
+    key.params[1] = rtlx;
+    key.params[2] = rtly;
+    key.params[3] = rtrx;
+    key.params[4] = rtry;
+    key.params[5] = rbrx;
+    key.params[6] = rbry;
+    key.params[7] = rblx;
+    key.params[8] = rbly;
+
+    const uint8_t *fillMask = nullptr;
+    if (fill) {
+        key.type = MASK_TYPE_ROUNDED_RECT_FILL;
+        fillMask = getMask(key, rasteriseRoundedRectMask);
+        if (!fillMask) {
+            return false;
+        }
+    }
+
+    const uint8_t *lineMask = nullptr;
+    if (lineWidth > 0 && drawLine) {
+        key.type = MASK_TYPE_ROUNDED_RECT_LINE;
+        lineMask = getMask(key, rasteriseRoundedRectMask);
+        if (!lineMask) {
+            return false;
+        }
+    }
+
+    if (fillMask) {
+        auto fc_save = g_fc;
+        g_fc = g_bc;
+        drawMask(fillMask, key.width, key.height, x1, y1, clip_x1, clip_y1, clip_x2, clip_y2);
+        g_fc = fc_save;
+    }
+
+    if (lineMask) {
+        drawMask(lineMask, key.width, key.height, x1, y1, clip_x1, clip_y1, clip_x2, clip_y2);
+    }
+
+    return true;
+}
+
 void fillRoundedRect(
     AggDrawing& aggDrawing,
     int x1, int y1, int x2, int y2,
@@ -792,6 +1088,21 @@ void fillRoundedRect(
     bool drawLine, bool fill,
     int clip_x1, int clip_y1, int clip_x2, int clip_y2
 ) {
+    if (x2 < x1 || y2 < y1) {
+        return;
+    }
+
+    if (fillRoundedRectFromMaskCache(
+        x1, y1, x2, y2,
+        lineWidth,
+        rtlx, rtly, rtrx, rtry,
+        rbrx, rbry, rblx, rbly,
+        drawLine, fill,
+        clip_x1, clip_y1, clip_x2, clip_y2
+    )) {
+        return;
+    }
+
 #ifdef CONF_FAST_ROUND_RECT
 	if (
 		rtlx == rtly && rtly == rtrx && rtrx == rtry && rtry == rbrx && rbrx == rbry && rbry == rblx && rblx == rbly // all radiuses are the same
@@ -1019,6 +1330,43 @@ int measureStr(const char *text, int textLength, gui::font::Font &font, int max_
     return width;
 }
 
+void drawMask(const uint8_t *mask, int width, int height, int x, int y, int clip_x1, int clip_y1, int clip_x2, int clip_y2) {
+    int x1 = x;
+    int y1 = y;
+    int x2 = x + width - 1;
+    int y2 = y + height - 1;
+
+    if (clip_x1 != -1) {
+        x1 = MAX(x1, clip_x1);
+        x2 = MIN(x2, clip_x2);
+        y1 = MAX(y1, clip_y1);
+        y2 = MIN(y2, clip_y2);
+    }
+
+    if (x1 < 0) {
+        x1 = 0;
+    }
+    if (y1 < 0) {
+        y1 = 0;
+    }
+    if (x2 > getDisplayWidth() - 1) {
+        x2 = getDisplayWidth() - 1;
+    }
+    if (y2 > getDisplayHeight() - 1) {
+        y2 = getDisplayHeight() - 1;
+    }
+
+    if (x1 > x2 || y1 > y2) {
+        return;
+    }
+
+    drawStrInit();
+
+    drawGlyph(mask + (y1 - y) * width + (x1 - x), width - (x2 - x1 + 1), x1, y1, x2 - x1 + 1, y2 - y1 + 1);
+
+    setDirty();
+}
+
 void drawStr(const char *text, int textLength, int x, int y, int clip_x1, int clip_y1, int clip_x2, int clip_y2, gui::font::Font &font, int cursorPosition) {
     g_font = font;
 
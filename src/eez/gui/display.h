@@ -65,6 +65,15 @@ void updateBrightness();
 
 void update();
 
+// Frame pacing: update() skips the frame if it is called before the next
+// frame is due, i.e. when frame rate cap is reached or when nothing changed
+// on the screen for a while (idle mode).
+void requestFrame(); // render next frame as soon as possible, leaves idle mode
+void setMaxFrameRate(uint32_t maxFrameRate); // 0 for the default frame rate
+uint32_t getMaxFrameRate();
+uint32_t getFrameTimeout(uint32_t timeout); // how long GUI thread can wait for the next message
+void updateDeferredFrame(); // call update() if skipped frame is now due
+
 #if EEZ_OPTION_GUI_ANIMATIONS
 void animate(Buffer startBuffer, void (*callback)(float t, VideoBuffer bufferOld, VideoBuffer bufferNew, VideoBuffer bufferDst), float duration = -1);
 #endif
@@ -83,7 +92,30 @@ void releaseScreenshot();
 extern bool g_calcFpsEnabled;
 extern bool g_drawFpsGraphEnabled;
 extern uint32_t g_fpsAvg;
+
+struct FrameStats {
+    uint32_t lastFrameTime; // ms
+    uint32_t avgFrameTime; // ms, over the last NUM_FPS_VALUES frames
+    uint32_t maxFrameTime; // ms, over the last NUM_FPS_VALUES frames
+    uint32_t numRenderedFrames;
+    uint32_t numUnchangedFrames; // screen was checked, but nothing was changed
+    uint32_t numSkippedFrames; // skipped because of the frame pacing
+    uint32_t framePeriod; // ms, current target
+};
+extern FrameStats g_frameStats;
 void drawFpsGraph(int x, int y, int w, int h, const Style *style);
+
+// Input-to-display latency, i.e. time from the input event (Event::time) until
+// the first frame rendered after that event is synced to the display.
+struct InputLatencyStats {
+    uint32_t numSamples; // total number of measured events
+    uint32_t p50; // ms, over the last 128 samples
+    uint32_t p90; // ms
+    uint32_t p99; // ms
+    uint32_t max; // ms
+};
+void noteInputEvent(uint32_t time);
+void getInputLatencyStats(InputLatencyStats &stats);
 #endif
 
 
@@ -118,6 +150,8 @@ void endPixelsDraw();
 void fillRect(int x1, int y1, int x2, int y2);
 void bitBlt(int x1, int y1, int x2, int y2, int x, int y);
 void drawBitmap(Image *image, int x, int y);
+// draws 8-bit coverage mask (width x height bytes) with the current color
+void drawMask(const uint8_t *mask, int width, int height, int x, int y, int clip_x1 = -1, int clip_y1 = -1, int clip_x2 = -1, int clip_y2 = -1);
 
 // used by animation
 void fillRect(void *dst, int x1, int y1, int x2, int y2);
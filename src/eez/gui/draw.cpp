@@ -19,6 +19,7 @@
 #include <eez/core/util.h>
 
 #include <eez/gui/gui.h>
+#include <eez/gui/mask_cache.h>
 
 namespace eez {
 namespace gui {
@@ -66,7 +67,7 @@ void drawBorderAndBackground(int &x1, int &y1, int &x2, int &y2, const Style *st
 			isTransparent = false;
 		} else if (style->backgroundImage) {
 			auto bitmap = getBitmap(style->backgroundImage);
-			if (bitmap->bpp != 32) {
+			if (bitmap && bitmap->bpp != 32) {
 				// non-transparent bitmap
 				isTransparent = false;
 			}
@@ -451,11 +452,80 @@ int getCursorXPosition(int cursorPosition, const char *text, int textLength, int
 
 static const unsigned int CONF_MULTILINE_TEXT_MAX_LINE_LENGTH = 1000;
 
-enum MultilineTextRenderStep {
-    MEASURE,
-    RENDER
+#if !defined(EEZ_GUI_MULTILINE_TEXT_LAYOUT_CACHE_SIZE)
+#define EEZ_GUI_MULTILINE_TEXT_LAYOUT_CACHE_SIZE 8
+#endif
+
+struct MultilineTextLayoutLine {
+    uint32_t start; // offset of the first word inside text
+    uint32_t end; // offset after the last word inside text
+    int y; // relative to the top of the text area
+    int indent;
+    int width;
 };
 
+// Line breaks of the multiline text, calculated once and reused
+// by both measureMultilineText and drawMultilineText until
+// text, font or geometry changes.
+struct MultilineTextLayout {
+    // key
+    const char *text;
+    uint32_t textLength;
+    uint32_t textHash;
+    const FontData *fontData;
+    int width;
+    int height;
+    int firstLineIndent;
+    int hangingIndent;
+
+    int lineHeight;
+    int spaceWidth;
+    int textHeight;
+
+    MultilineTextLayoutLine *lines;
+    uint32_t numLines;
+    uint32_t maxLines;
+
+    uint32_t lastUsed;
+};
+
+static MultilineTextLayout g_multilineTextLayoutCache[EEZ_GUI_MULTILINE_TEXT_LAYOUT_CACHE_SIZE];
+static uint32_t g_multilineTextLayoutCounter;
+
+static uint32_t hashMultilineText(const char *text, uint32_t &textLength) {
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    const char *p = text;
+    for (; *p; p++) {
+        hash = (hash ^ (uint8_t)*p) * 16777619u;
+    }
+    textLength = (uint32_t)(p - text);
+    return hash;
+}
+
+static void addMultilineTextLayoutLine(MultilineTextLayout &layout, uint32_t start, uint32_t end, int y, int indent, int width) {
+    if (layout.numLines == layout.maxLines) {
+        uint32_t maxLines = layout.maxLines ? 2 * layout.maxLines : 16;
+        auto lines = (MultilineTextLayoutLine *)alloc(maxLines * sizeof(MultilineTextLayoutLine), 0x8d3b72e4);
+        if (!lines) {
+            return;
+        }
+        if (layout.lines) {
+            memcpy(lines, layout.lines, layout.numLines * sizeof(MultilineTextLayoutLine));
+            free(layout.lines);
+        }
+        layout.lines = lines;
+        layout.maxLines = maxLines;
+    }
+
+    auto &line = layout.lines[layout.numLines++];
+    line.start = start;
+    line.end = end;
+    line.y = y;
+    line.indent = indent;
+    line.width = width;
+}
+
 struct MultilineTextRender {
     const char *text;
     int x1;
@@ -473,47 +543,39 @@ struct MultilineTextRender {
     int lineHeight;
     int textHeight;
 
-    char line[CONF_MULTILINE_TEXT_MAX_LINE_LENGTH + 1];
+    MultilineTextLayout *layout;
+
+    uint32_t lineStart;
+    uint32_t lineEnd;
+    uint32_t lineLength;
     int lineIndent;
     int lineWidth;
 
-    void appendToLine(const char *str, size_t n) {
-        size_t j = strlen(line);
-        for (size_t i = 0; i < n && j < CONF_MULTILINE_TEXT_MAX_LINE_LENGTH; i++, j++) {
-            line[j] = str[i];
+    void appendToLine(uint32_t start, uint32_t end) {
+        if (lineLength == 0) {
+            lineStart = start;
         }
-        line[j] = 0;
+        lineEnd = end;
+        lineLength += end - start;
     }
 
-    void flushLine(int y, MultilineTextRenderStep step) {
-        if (line[0] && lineWidth) {
-            if (step == RENDER) {
-                int x;
-
-                if (styleIsHorzAlignLeft(style)) {
-                    x = x1;
-                } else if (styleIsHorzAlignRight(style)) {
-                    x = x2 + 1 - lineWidth;
-                } else {
-                    x = x1 + int((x2 - x1 + 1 - lineWidth) / 2);
-                }
+    void flushLine(int y) {
+        if (lineLength && lineWidth) {
+            addMultilineTextLayoutLine(*layout, lineStart, lineEnd, y - y1, lineIndent, lineWidth);
 
-                display::drawStr(line, -1, x + lineIndent, y, x, y, x + lineWidth - 1, y + font.getHeight() - 1, font, -1);
-            } else {
-                textHeight = MAX(textHeight, y + lineHeight - y1);
-            }
+            textHeight = MAX(textHeight, y + lineHeight - y1);
 
-            line[0] = 0;
+            lineLength = 0;
             lineWidth = lineIndent = hangingIndent;
         }
     }
 
-    int executeStep(MultilineTextRenderStep step) {
+    void calcLayout() {
         textHeight = 0;
 
         int y = y1;
 
-        line[0] = 0;
+        lineLength = 0;
         lineWidth = lineIndent = firstLineIndent;
 
         int i = 0;
@@ -524,14 +586,14 @@ struct MultilineTextRender {
 
             int width = display::measureStr(text + j, i - j, font);
 
-            while (lineWidth + (line[0] ? spaceWidth : 0) + width > x2 - x1 + 1) {
-				if (!line[0]) {
+            while (lineWidth + (lineLength ? spaceWidth : 0) + width > x2 - x1 + 1) {
+				if (!lineLength) {
 					i--;
 					width = display::measureStr(text + j, i - j, font);
 					continue;
 				}
 
-                flushLine(y, step);
+                flushLine(y);
 
                 y += lineHeight;
                 if (y + lineHeight - 1 > y2) {
@@ -543,11 +605,11 @@ struct MultilineTextRender {
                 break;
             }
 
-            if (line[0]) {
-                appendToLine(" ", 1);
+            if (lineLength) {
+                lineLength++;
                 lineWidth += spaceWidth;
             }
-            appendToLine(text + j, i - j);
+            appendToLine(j, i);
             lineWidth += width;
 
             while (text[i] == ' ') {
@@ -555,7 +617,7 @@ struct MultilineTextRender {
             }
 
             if (text[i] == 0 || text[i] == '\n') {
-                flushLine(y, step);
+                flushLine(y);
 
                 y += lineHeight;
 
@@ -574,9 +636,90 @@ struct MultilineTextRender {
             }
         }
 
-        flushLine(y, step);
+        flushLine(y);
+
+        layout->textHeight = textHeight + font.getHeight() - lineHeight;
+    }
+
+    void findLayout() {
+        uint32_t textLength;
+        uint32_t textHash = hashMultilineText(text, textLength);
+
+        int width = x2 - x1 + 1;
+        int height = y2 - y1 + 1;
+
+        MultilineTextLayout *lruLayout = &g_multilineTextLayoutCache[0];
+
+        for (int i = 0; i < EEZ_GUI_MULTILINE_TEXT_LAYOUT_CACHE_SIZE; i++) {
+            auto &cachedLayout = g_multilineTextLayoutCache[i];
+            if (
+                cachedLayout.text == text &&
+                cachedLayout.textLength == textLength &&
+                cachedLayout.textHash == textHash &&
+                cachedLayout.fontData == font.fontData &&
+                cachedLayout.width == width &&
+                cachedLayout.height == height &&
+                cachedLayout.firstLineIndent == firstLineIndent &&
+                cachedLayout.hangingIndent == hangingIndent &&
+                cachedLayout.lineHeight == lineHeight &&
+                cachedLayout.spaceWidth == spaceWidth
+            ) {
+                cachedLayout.lastUsed = ++g_multilineTextLayoutCounter;
+                layout = &cachedLayout;
+                return;
+            }
+
+            if (cachedLayout.lastUsed < lruLayout->lastUsed) {
+                lruLayout = &cachedLayout;
+            }
+        }
 
-        return textHeight + font.getHeight() - lineHeight;
+        layout = lruLayout;
+
+        layout->text = text;
+        layout->textLength = textLength;
+        layout->textHash = textHash;
+        layout->fontData = font.fontData;
+        layout->width = width;
+        layout->height = height;
+        layout->firstLineIndent = firstLineIndent;
+        layout->hangingIndent = hangingIndent;
+        layout->lineHeight = lineHeight;
+        layout->spaceWidth = spaceWidth;
+        layout->numLines = 0;
+        layout->lastUsed = ++g_multilineTextLayoutCounter;
+
+        calcLayout();
+    }
+
+    void drawLines() {
+        char line[CONF_MULTILINE_TEXT_MAX_LINE_LENGTH + 1];
+
+        for (uint32_t lineIndex = 0; lineIndex < layout->numLines; lineIndex++) {
+            auto &layoutLine = layout->lines[lineIndex];
+
+            // words inside the line are separated by the single space
+            size_t n = 0;
+            for (uint32_t i = layoutLine.start; i < layoutLine.end && n < CONF_MULTILINE_TEXT_MAX_LINE_LENGTH; i++) {
+                if (text[i] != ' ' || text[i - 1] != ' ') {
+                    line[n++] = text[i];
+                }
+            }
+            line[n] = 0;
+
+            int x;
+            if (styleIsHorzAlignLeft(style)) {
+                x = x1;
+            } else if (styleIsHorzAlignRight(style)) {
+                x = x2 + 1 - layoutLine.width;
+            } else {
+                x = x1 + int((x2 - x1 + 1 - layoutLine.width) / 2);
+            }
+
+            int y = y1 + layoutLine.y;
+
+            display::drawStr(line, n, x + layoutLine.indent, y, x, y, x + layoutLine.width - 1, y + font.getHeight() - 1, font, -1);
+        }
     }
 
     int measure() {
@@ -600,7 +743,9 @@ struct MultilineTextRender {
         y1 += style->paddingTop;
         y2 -= style->paddingBottom;
 
-        return executeStep(MEASURE);
+        findLayout();
+
+        return layout->textHeight;
     }
 
     void render() {
@@ -626,7 +771,9 @@ struct MultilineTextRender {
         y1 += style->paddingTop;
         y2 -= style->paddingBottom;
 
-        int textHeight = executeStep(MEASURE);
+        findLayout();
+
+        int textHeight = layout->textHeight;
 
         if (styleIsVertAlignTop(style)) {
         } else if (styleIsVertAlignBottom(style)) {
@@ -637,7 +784,7 @@ struct MultilineTextRender {
         y2 = y1 + textHeight - 1;
 
         if (color != TRANSPARENT_COLOR_INDEX) {
-            executeStep(RENDER);
+            drawLines();
         }
     }
 };
@@ -674,6 +821,17 @@ int measureMultilineText(const char *text, int x, int y, int w, int h, const Sty
     return multilineTextRender.measure();
 }
 
+void resetMultilineTextLayoutCache() {
+    for (int i = 0; i < EEZ_GUI_MULTILINE_TEXT_LAYOUT_CACHE_SIZE; i++) {
+        auto &cachedLayout = g_multilineTextLayoutCache[i];
+        // lines buffer is kept for reuse
+        cachedLayout.text = nullptr;
+        cachedLayout.fontData = nullptr;
+        cachedLayout.numLines = 0;
+        cachedLayout.lastUsed = 0;
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 void drawBitmap(Image *image, int x, int y, int w, int h, const Style *style, bool active) {
@@ -773,8 +931,35 @@ static const int L = 7;
 static const int W = 20;
 static const int H = 20;
 
-void drawShadowGlyph(ShadowGlpyh shadowGlyph, int x, int y, int xClip = -1, int yClip = -1) {
+static void rasteriseShadowGlyph(uint8_t *mask, int maskWidth, int maskHeight, font::Font &font, ShadowGlpyh shadowGlyph, int x, int y, int xClip, int yClip) {
+	auto glyph = font.getGlyph(32 + shadowGlyph);
+	if (!glyph) {
+		return;
+	}
+
+	int x_glyph = x + glyph->x;
+	int y_glyph = y + font.getAscent() - (glyph->y + glyph->height);
+
+	int clip_x1 = MAX(x, 0);
+	int clip_y1 = MAX(y, 0);
+	int clip_x2 = MIN(xClip, maskWidth - 1);
+	int clip_y2 = MIN(yClip, maskHeight - 1);
+
+	for (int yy = MAX(y_glyph, clip_y1); yy <= MIN(y_glyph + glyph->height - 1, clip_y2); yy++) {
+		for (int xx = MAX(x_glyph, clip_x1); xx <= MIN(x_glyph + glyph->width - 1, clip_x2); xx++) {
+			auto a = glyph->pixels[(yy - y_glyph) * glyph->width + xx - x_glyph];
+			auto &dst = mask[yy * maskWidth + xx];
+			dst = MAX(dst, a);
+		}
+	}
+}
+
+// if mask is nullptr then shadow glyphs are drawn directly to the display
+static void drawShadowGlyph(uint8_t *mask, int maskWidth, int maskHeight, ShadowGlpyh shadowGlyph, int x, int y, int xClip = -1, int yClip = -1) {
 	font::Font font(getFontData(FONT_ID_SHADOW));
+	if (!font) {
+		return;
+	}
 
 	if (xClip == -1) {
 		xClip = x + W - 1;
@@ -782,35 +967,61 @@ void drawShadowGlyph(ShadowGlpyh shadowGlyph, int x, int y, int xClip = -1, int
 	if (yClip == -1) {
 		yClip = y + H - 1;
 	}
+
+	if (mask) {
+		rasteriseShadowGlyph(mask, maskWidth, maskHeight, font, shadowGlyph, x, y, xClip, yClip);
+		return;
+	}
+
 	char glyph = 32 + shadowGlyph;
 	display::drawStr(&glyph, 1, x, y, x, y, xClip, yClip, font, -1);
 }
 
-void drawShadow(int x1, int y1, int x2, int y2) {
-	display::setColor(64, 64, 64);
-
+static void drawShadowGlyphs(uint8_t *mask, int maskWidth, int maskHeight, int x1, int y1, int x2, int y2) {
 	int left = x1 - L;
 	int top = y1 - T;
 
 	int right = x2 + R - (W - 1);
 	int bottom = y2 + B - (H - 1);
 
-	drawShadowGlyph(SHADOW_GLYPH_TOP_LEFT, left, top);
+	drawShadowGlyph(mask, maskWidth, maskHeight, SHADOW_GLYPH_TOP_LEFT, left, top);
 	for (int x = left + W; x < right; x += W) {
-		drawShadowGlyph(SHADOW_GLYPH_TOP, x, top, right - 1);
+		drawShadowGlyph(mask, maskWidth, maskHeight, SHADOW_GLYPH_TOP, x, top, right - 1);
 	}
-	drawShadowGlyph(SHADOW_GLYPH_TOP_RIGHT, right, top);
+	drawShadowGlyph(mask, maskWidth, maskHeight, SHADOW_GLYPH_TOP_RIGHT, right, top);
 	for (int y = top + H; y < bottom; y += H) {
-		drawShadowGlyph(SHADOW_GLYPH_LEFT, left, y, -1, bottom - 1);
+		drawShadowGlyph(mask, maskWidth, maskHeight, SHADOW_GLYPH_LEFT, left, y, -1, bottom - 1);
 	}
 	for (int y = top + H; y < bottom; y += H) {
-		drawShadowGlyph(SHADOW_GLYPH_RIGHT, right, y, -1, bottom - 1);
+		drawShadowGlyph(mask, maskWidth, maskHeight, SHADOW_GLYPH_RIGHT, right, y, -1, bottom - 1);
 	}
-	drawShadowGlyph(SHADOW_GLYPH_BOTTOM_LEFT, left, bottom);
+	drawShadowGlyph(mask, maskWidth, maskHeight, SHADOW_GLYPH_BOTTOM_LEFT, left, bottom);
 	for (int x = left + W; x < right; x += W) {
-		drawShadowGlyph(SHADOW_GLYPH_BOTTOM, x, bottom, right - 1);
+		drawShadowGlyph(mask, maskWidth, maskHeight, SHADOW_GLYPH_BOTTOM, x, bottom, right - 1);
+	}
+	drawShadowGlyph(mask, maskWidth, maskHeight, SHADOW_GLYPH_BOTTOM_RIGHT, right, bottom);
+}
+
+static void rasteriseShadowMask(const display::MaskKey &key, uint8_t *mask) {
+	// mask origin is at the top-left corner of the shadow
+	drawShadowGlyphs(mask, key.width, key.height, L, T, key.width - R - 1, key.height - B - 1);
+}
+
+void drawShadow(int x1, int y1, int x2, int y2) {
+	display::setColor(64, 64, 64);
+
+	display::MaskKey key;
+	key.type = display::MASK_TYPE_SHADOW;
+	key.width = x2 - x1 + 1 + L + R;
+	key.height = y2 - y1 + 1 + T + B;
+
+	auto mask = display::getMask(key, rasteriseShadowMask);
+	if (mask) {
+		display::drawMask(mask, key.width, key.height, x1 - L, y1 - T);
+		return;
 	}
-	drawShadowGlyph(SHADOW_GLYPH_BOTTOM_RIGHT, right, bottom);
+
+	drawShadowGlyphs(nullptr, 0, 0, x1, y1, x2, y2);
 }
 
 void expandRectWithShadow(int &x1, int &y1, int &x2, int &y2) {
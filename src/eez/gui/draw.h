@@ -38,6 +38,7 @@ int getCursorXPosition(int cursorPosition, const char *text, int textLength, int
 
 void drawMultilineText(const char *text, int x, int y, int w, int h, const Style *style, bool active, bool blinking, int firstLineIndent, int hangingIndent);
 int measureMultilineText(const char *text, int x, int y, int w, int h, const Style *style, int firstLineIndent, int hangingIndent);
+void resetMultilineTextLayoutCache();
 
 void drawBitmap(Image *image, int x, int y, int w, int h, const Style *style, bool active);
 void drawRectangle(int x, int y, int w, int h, const Style *style, bool active = false, bool ignoreLuminocity = false, bool invertColors = true);
@@ -106,6 +106,10 @@ void processTouchEvent(Event &touchEvent) {
         uint32_t tickCountMs = millis();
 
         eez::hmi::noteActivity();
+        display::requestFrame();
+#ifdef GUI_CALC_FPS
+        display::noteInputEvent(touchEvent.time);
+#endif
 
         if (touchEvent.type == EVENT_TYPE_TOUCH_DOWN) {
             m_touchDownTimeMs = tickCountMs;
@@ -28,19 +28,25 @@ Font::Font(const FontData *fontData_)
 {
 }
 
+// fontData is nullptr if font from the mapped assets couldn't be loaded
+
 uint8_t Font::getAscent() {
-    return fontData->ascent;
+    return fontData ? fontData->ascent : 0;
 }
 
 uint8_t Font::getDescent() {
-    return fontData->descent;
+    return fontData ? fontData->descent : 0;
 }
 
 uint8_t Font::getHeight() {
-    return fontData->ascent + fontData->descent;
+    return fontData ? fontData->ascent + fontData->descent : 0;
 }
 
 const GlyphData *Font::getGlyph(int32_t encoding) {
+    if (!fontData) {
+        return nullptr;
+    }
+
 	auto start = fontData->encodingStart;
 	auto end = fontData->encodingEnd;
 
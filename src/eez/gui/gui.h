@@ -105,4 +105,5 @@ extern bool g_updateDisplay;
 #include <eez/gui/page.h>
 #include <eez/gui/hooks.h>
 
-#define DATA_OPERATION_FUNCTION(id, operation, widgetCursor, value) (id >= 0 ? g_dataOperationsFunctions[id](operation, widgetCursor, value) : g_hooks.externalData(id, operation, widgetCursor, value))
+// widget which reads some data (id 0 is DATA_ID_NONE) can't be in the valid cached layer
+#define DATA_OPERATION_FUNCTION(id, operation, widgetCursor, value) ((id != 0 ? (void)(eez::gui::g_cachedLayerDirty = true) : (void)0), id >= 0 ? g_dataOperationsFunctions[id](operation, widgetCursor, value) : g_hooks.externalData(id, operation, widgetCursor, value))
@@ -0,0 +1,131 @@
+/*
+ * eez-framework
+ *
+ * MIT License
+ * Copyright 2024 Envox d.o.o.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <eez/conf-internal.h>
+
+#if EEZ_OPTION_GUI
+
+#include <string.h>
+
+#include <eez/core/alloc.h>
+
+#include <eez/gui/mask_cache.h>
+
+#if !defined(EEZ_GUI_MASK_CACHE_SIZE)
+#define EEZ_GUI_MASK_CACHE_SIZE (128 * 1024)
+#endif
+
+#if !defined(EEZ_GUI_MASK_CACHE_MAX_ENTRIES)
+#define EEZ_GUI_MASK_CACHE_MAX_ENTRIES 32
+#endif
+
+namespace eez {
+namespace gui {
+namespace display {
+
+struct MaskCacheEntry {
+    MaskKey key;
+    uint8_t *mask;
+    uint32_t size;
+    uint32_t lastUsed;
+};
+
+static MaskCacheEntry g_maskCache[EEZ_GUI_MASK_CACHE_MAX_ENTRIES];
+static uint32_t g_maskCacheSize;
+static uint32_t g_maskCacheCounter;
+
+static uint32_t g_maskCacheHits;
+static uint32_t g_maskCacheMisses;
+
+static void freeMaskCacheEntry(MaskCacheEntry &entry) {
+    if (entry.mask) {
+        free(entry.mask);
+        entry.mask = nullptr;
+        g_maskCacheSize -= entry.size;
+        entry.size = 0;
+    }
+}
+
+const uint8_t *getMask(const MaskKey &key, RasteriseMaskFunc rasterise) {
+    for (int i = 0; i < EEZ_GUI_MASK_CACHE_MAX_ENTRIES; i++) {
+        auto &entry = g_maskCache[i];
+        if (entry.mask && memcmp(&entry.key, &key, sizeof(MaskKey)) == 0) {
+            entry.lastUsed = ++g_maskCacheCounter;
+            g_maskCacheHits++;
+            return entry.mask;
+        }
+    }
+
+    g_maskCacheMisses++;
+
+    uint32_t size = (uint32_t)key.width * key.height;
+    if (size == 0 || size > EEZ_GUI_MASK_CACHE_SIZE / 2) {
+        // too big to be cached
+        return nullptr;
+    }
+
+    // evict least recently used masks until there is enough room
+    MaskCacheEntry *freeEntry;
+    while (true) {
+        freeEntry = nullptr;
+        MaskCacheEntry *lruEntry = nullptr;
+        for (int i = 0; i < EEZ_GUI_MASK_CACHE_MAX_ENTRIES; i++) {
+            auto &entry = g_maskCache[i];
+            if (!entry.mask) {
+                if (!freeEntry) {
+                    freeEntry = &entry;
+                }
+            } else if (!lruEntry || entry.lastUsed < lruEntry->lastUsed) {
+                lruEntry = &entry;
+            }
+        }
+
+        if (freeEntry && g_maskCacheSize + size <= EEZ_GUI_MASK_CACHE_SIZE) {
+            break;
+        }
+
+        freeMaskCacheEntry(*lruEntry);
+    }
+
+    auto mask = (uint8_t *)alloc(size, 0x6f2c94b1);
+    if (!mask) {
+        return nullptr;
+    }
+
+    memset(mask, 0, size);
+    rasterise(key, mask);
+
+    freeEntry->key = key;
+    freeEntry->mask = mask;
+    freeEntry->size = size;
+    freeEntry->lastUsed = ++g_maskCacheCounter;
+
+    g_maskCacheSize += size;
+
+    return mask;
+}
+
+void clearMaskCache() {
+    for (int i = 0; i < EEZ_GUI_MASK_CACHE_MAX_ENTRIES; i++) {
+        freeMaskCacheEntry(g_maskCache[i]);
+    }
+}
+
+void getMaskCacheStats(uint32_t &hits, uint32_t &misses, uint32_t &size) {
+    hits = g_maskCacheHits;
+    misses = g_maskCacheMisses;
+    size = g_maskCacheSize;
+}
+
+} // namespace display
+} // namespace gui
+} // namespace eez
+
+#endif // EEZ_OPTION_GUI
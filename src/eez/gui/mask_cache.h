@@ -0,0 +1,50 @@
+/*
+ * eez-framework
+ *
+ * MIT License
+ * Copyright 2024 Envox d.o.o.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+namespace eez {
+namespace gui {
+namespace display {
+
+enum MaskType {
+    MASK_TYPE_ROUNDED_RECT_FILL,
+    MASK_TYPE_ROUNDED_RECT_LINE,
+    MASK_TYPE_SHADOW
+};
+
+// Identifies 8-bit coverage mask of width x height bytes, params depends on the mask type.
+struct MaskKey {
+    MaskKey() {
+        memset(this, 0, sizeof(MaskKey));
+    }
+
+    uint16_t type;
+    uint16_t width;
+    uint16_t height;
+    int16_t params[9];
+};
+
+typedef void (*RasteriseMaskFunc)(const MaskKey &key, uint8_t *mask);
+
+// Returns mask from the LRU cache, rasterised with the given function on the first use.
+// Returns nullptr if mask can't be cached, caller should then draw shape directly.
+const uint8_t *getMask(const MaskKey &key, RasteriseMaskFunc rasterise);
+
+void clearMaskCache();
+
+void getMaskCacheStats(uint32_t &hits, uint32_t &misses, uint32_t &size);
+
+} // namespace display
+} // namespace gui
+} // namespace eez
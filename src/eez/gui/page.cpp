@@ -96,6 +96,10 @@ bool Page::showAreYouSureOnDiscard() {
     return true;
 }
 
+uint32_t Page::getMaxFrameRate() {
+    return 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 void SetPage::edit() {
@@ -40,6 +40,9 @@ public:
     virtual void discard();
 
     virtual bool showAreYouSureOnDiscard();
+
+    // 0 for the default frame rate
+    virtual uint32_t getMaxFrameRate();
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -29,6 +29,10 @@ void mainLoop(void *);
 #define GUI_THREAD_STACK_SIZE 12 * 1024
 #endif
 
+#if !defined(EEZ_GUI_QUEUE_SIZE)
+#define EEZ_GUI_QUEUE_SIZE 20
+#endif
+
 EEZ_THREAD_DECLARE(gui, Normal, GUI_THREAD_STACK_SIZE);
 
 EEZ_MESSAGE_QUEUE_DECLARE(gui, {
@@ -47,7 +51,7 @@ EEZ_MESSAGE_QUEUE_DECLARE(gui, {
 });
 
 void startThread() {
-	EEZ_MESSAGE_QUEUE_CREATE(gui, 20);
+	EEZ_MESSAGE_QUEUE_CREATE(gui, EEZ_GUI_QUEUE_SIZE);
 	EEZ_THREAD_CREATE(gui, mainLoop);
 
 #ifdef __EMSCRIPTEN__
@@ -77,15 +81,7 @@ void mainLoop(void *) {
 #endif
 }
 
-void processGuiQueue(uint32_t timeout) {
-#ifdef __EMSCRIPTEN__
-    while (true) {
-#endif
-    guiMessageQueueObject obj;
-    if (!EEZ_MESSAGE_QUEUE_GET(gui, obj, timeout)) {
-        return;
-    }
-
+static void processGuiQueueMessage(guiMessageQueueObject &obj) {
     uint8_t type = obj.type;
 
     if (type == GUI_QUEUE_MESSAGE_TYPE_DISPLAY_VSYNC) {
@@ -107,13 +103,56 @@ void processGuiQueue(uint32_t timeout) {
     } else {
         g_hooks.onGuiQueueMessage(type, obj.param);
     }
+}
+
+void processGuiQueue(uint32_t timeout) {
+#ifdef __EMSCRIPTEN__
+    while (true) {
+#endif
+    guiMessageQueueObject obj;
+    if (!EEZ_MESSAGE_QUEUE_GET(gui, obj, timeout)) {
+        return;
+    }
+
+    // Drain the messages that are already queued. Consecutive touch move
+    // events are coalesced, only the latest position is processed, but with
+    // the time of the oldest one so input latency is measured correctly.
+    // Any other message (touch down/up, vsync, ...) flushes the pending
+    // move first, so the ordering is preserved.
+    guiMessageQueueObject pendingMove;
+    bool hasPendingMove = false;
+
+    for (int i = 0; ; i++) {
+        if (obj.type == GUI_QUEUE_MESSAGE_TYPE_TOUCH_EVENT && obj.touchEvent.type == EVENT_TYPE_TOUCH_MOVE) {
+            if (hasPendingMove) {
+                obj.touchEvent.time = pendingMove.touchEvent.time;
+            }
+            pendingMove = obj;
+            hasPendingMove = true;
+        } else {
+            if (hasPendingMove) {
+                processGuiQueueMessage(pendingMove);
+                hasPendingMove = false;
+            }
+            processGuiQueueMessage(obj);
+        }
+
+        if (i == EEZ_GUI_QUEUE_SIZE || !EEZ_MESSAGE_QUEUE_GET(gui, obj, 0)) {
+            break;
+        }
+    }
+
+    if (hasPendingMove) {
+        processGuiQueueMessage(pendingMove);
+    }
 #ifdef __EMSCRIPTEN__
     }
 #endif
 }
 
 void oneIter() {
-	processGuiQueue(100);
+	processGuiQueue(display::getFrameTimeout(100));
+    display::updateDeferredFrame();
     guiTick();
 }
 
@@ -23,6 +23,10 @@
 namespace eez {
 namespace gui {
 
+#if !defined(EEZ_GUI_MAX_CACHED_LAYERS)
+#define EEZ_GUI_MAX_CACHED_LAYERS 8
+#endif
+
 static bool g_refreshScreen;
 static Widget *g_rootWidget;
 
@@ -33,8 +37,52 @@ bool g_widgetStateStructureChanged;
 
 WidgetCursor g_widgetCursor;
 
+uint32_t g_cachedLayersEpoch;
+bool g_cachedLayerDirty;
+
 void refreshScreen() {
 	g_refreshScreen = true;
+	display::requestFrame();
+}
+
+void invalidateCachedLayers() {
+	g_cachedLayersEpoch++;
+}
+
+static const Widget *g_cachedLayerWidgets[EEZ_GUI_MAX_CACHED_LAYERS];
+static unsigned g_numCachedLayerWidgets;
+
+bool setCachedLayer(const Widget *containerWidget, bool enabled) {
+	for (unsigned i = 0; i < g_numCachedLayerWidgets; i++) {
+		if (g_cachedLayerWidgets[i] == containerWidget) {
+			if (!enabled) {
+				g_cachedLayerWidgets[i] = g_cachedLayerWidgets[--g_numCachedLayerWidgets];
+				invalidateCachedLayers();
+			}
+			return true;
+		}
+	}
+
+	if (!enabled) {
+		return true;
+	}
+
+	if (g_numCachedLayerWidgets == EEZ_GUI_MAX_CACHED_LAYERS) {
+		return false;
+	}
+
+	g_cachedLayerWidgets[g_numCachedLayerWidgets++] = containerWidget;
+	invalidateCachedLayers();
+	return true;
+}
+
+bool isCachedLayer(const Widget *widget) {
+	for (unsigned i = 0; i < g_numCachedLayerWidgets; i++) {
+		if (g_cachedLayerWidgets[i] == widget) {
+			return true;
+		}
+	}
+	return false;
 }
 
 void updateScreen() {
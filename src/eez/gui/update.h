@@ -20,6 +20,22 @@ extern WidgetCursor g_widgetCursor;
 
 void updateScreen();
 
+// Cached layer containers stop updating their children after a pass in which
+// no child changed its state or read any data, children pixels are kept in the page buffer.
+// Layer is updated again after invalidateCachedLayers(), refreshScreen() or when
+// the container itself is repainted.
+extern uint32_t g_cachedLayersEpoch;
+void invalidateCachedLayers();
+
+// Cached layer is enabled at runtime, it is not part of the assets format. Container widget
+// is found in the page asset (getPageAsset(pageId)->widgets), registrations must be removed
+// before the assets are reloaded. Returns false if EEZ_GUI_MAX_CACHED_LAYERS are already enabled.
+bool setCachedLayer(const Widget *containerWidget, bool enabled);
+bool isCachedLayer(const Widget *widget);
+
+// Set when widget state is changed, created or depends on data, see setCachedLayer.
+extern bool g_cachedLayerDirty;
+
 void enumRootWidget();
 
 } // namespace gui
@@ -15,7 +15,9 @@
 #include <assert.h>
 #include <cstddef>
 #include <limits.h>
+#include <algorithm>
 
+#include <eez/core/alloc.h>
 #include <eez/core/debug.h>
 #include <eez/core/os.h>
 #include <eez/core/util.h>
@@ -188,6 +190,9 @@ void enumWidget() {
 		if (widgetCursor.hasPreviousState && widget->type == widgetState->type) {
             // reuse existing widget state
             bool refresh = widgetState->updateState();
+            if (refresh) {
+                g_cachedLayerDirty = true;
+            }
             if (refresh || widgetCursor.refreshed) {
                 RENDER_WIDGET();
             }
@@ -203,6 +208,7 @@ void enumWidget() {
 			widgetState->type = widget->type;
 
 			widgetState->updateState();
+			g_cachedLayerDirty = true;
 
             RENDER_WIDGET();
 
@@ -262,6 +268,39 @@ void freeWidgetStates(WidgetState *widgetStateStart) {
 	}
 }
 
+void rotateWidgetStates(WidgetState *itemsStateStart, uint32_t itemStateSize, int numItems, int delta) {
+    delta %= numItems;
+    if (delta < 0) {
+        delta += numItems;
+    }
+    if (delta == 0) {
+        return;
+    }
+
+    // widget states don't point into the state buffer, so they can be moved around
+    auto start = (uint8_t *)itemsStateStart;
+    auto end = start + numItems * itemStateSize;
+    auto shift = delta * itemStateSize;
+    std::rotate(start, start + shift, end);
+
+    // g_foundWidgetAtDown should still point to the same state
+    auto &widgetCursor = getFoundWidgetAtDown();
+    auto state = (uint8_t *)widgetCursor.currentState;
+    if (state >= start && state < end) {
+        auto offset = state - start;
+        offset = offset >= (ptrdiff_t)shift ? offset - shift : offset + (end - start) - shift;
+        widgetCursor.currentState = (WidgetState *)(start + offset);
+    }
+}
+
+void moveWidgetStates(WidgetState *start, WidgetState *end, int dx, int dy) {
+    for (auto widgetState = start; widgetState < end; ) {
+        widgetState->x += dx;
+        widgetState->y += dy;
+        widgetState = (WidgetState *)((uint8_t *)widgetState + g_widgetStateSizes[widgetState->type]);
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 void forEachWidget(EnumWidgetsCallback callback) {
@@ -515,134 +554,312 @@ void resizeWidget(
     widgetRect.h = bottom - top;
 }
 
-void applyTimeline(WidgetCursor& widgetCursor, Rect &widgetRect) {
-    if (widgetCursor.widget->timeline.count > 0) {
-        auto x = widgetCursor.widget->x;
-        auto y = widgetCursor.widget->y;
-        auto w = widgetCursor.widget->width;
-        auto h = widgetCursor.widget->height;
-        float opacity = 1.0f;
+////////////////////////////////////////////////////////////////////////////////
 
-        auto timelinePosition = widgetCursor.flowState->timelinePosition;
-        for (uint32_t i = 0; i < widgetCursor.widget->timeline.count; i++) {
-            auto keyframe = widgetCursor.widget->timeline[i];
+#if !defined(EEZ_GUI_TIMELINE_CACHE_SIZE)
+#define EEZ_GUI_TIMELINE_CACHE_SIZE 256
+#endif
 
-            if (timelinePosition < keyframe->start) {
-                continue;
-            }
+struct TimelineState {
+    int16_t x;
+    int16_t y;
+    int16_t w;
+    int16_t h;
+    float opacity;
+};
 
-            if (
-                timelinePosition >= keyframe->start &&
-                timelinePosition <= keyframe->end
-            ) {
-                auto t =
-                    keyframe->start == keyframe->end
-                        ? 1
-                        : (timelinePosition - keyframe->start) /
-                        (keyframe->end - keyframe->start);
-
-                if (keyframe->enabledProperties & WIDGET_TIMELINE_PROPERTY_X) {
-                    auto t2 = g_easingFuncs[keyframe->xEasingFunc](t);
-
-                    if (keyframe->enabledProperties & WIDGET_TIMELINE_PROPERTY_CP2) {
-                        auto p1 = x;
-                        auto p2 = keyframe->cp1x;
-                        auto p3 = keyframe->cp2x;
-                        auto p4 = keyframe->x;
-                        x =
-                            (1 - t2) * (1 - t2) * (1 - t2) * p1 +
-                            3 * (1 - t2) * (1 - t2) * t2 * p2 +
-                            3 * (1 - t2) * t2 * t2 * p3 +
-                            t2 * t2 * t2 * p4;
-                    } else if (keyframe->enabledProperties & WIDGET_TIMELINE_PROPERTY_CP1) {
-                        auto p1 = x;
-                        auto p2 = keyframe->cp1x;
-                        auto p3 = keyframe->x;
-                        x =
-                            (1 - t2) * (1 - t2) * p1 +
-                            2 * (1 - t2) * t2 * p2 +
-                            t2 * t2 * p3;
-                    } else {
-                        auto p1 = x;
-                        auto p2 = keyframe->x;
-                        x = (1 - t2) * p1 + t2 * p2;
-                    }
-                }
+// Widget keyframes sorted by start, together with the widget state reached
+// after all the preceding keyframes are finished. With this the active keyframe
+// is found by binary search instead of replaying the whole timeline.
+struct TimelineIndex {
+    // widget of the newly loaded external assets can be at the address of a widget from the freed ones
+    const Assets *assets;
+    const Widget *widget;
+    uint32_t count;
+    const TimelineKeyframe **keyframes;
+    TimelineState *states; // states[i] is the state before keyframes[i], states[count] is the final state
+    bool sequential; // sorted keyframes do not overlap
+
+    bool lastStateValid;
+    float lastTimelinePosition;
+    TimelineState lastState;
+};
 
-                if (keyframe->enabledProperties & WIDGET_TIMELINE_PROPERTY_WIDTH) {
-                    w += g_easingFuncs[keyframe->widthEasingFunc](t) * (keyframe->width - w);
-                }
+static TimelineIndex *g_timelineCache[EEZ_GUI_TIMELINE_CACHE_SIZE];
+
+static void applyKeyframe(const TimelineKeyframe *keyframe, float timelinePosition, TimelineState &state) {
+    auto t =
+        keyframe->start == keyframe->end
+            ? 1
+            : (timelinePosition - keyframe->start) /
+            (keyframe->end - keyframe->start);
+
+    if (keyframe->enabledProperties & WIDGET_TIMELINE_PROPERTY_X) {
+        auto t2 = g_easingFuncs[keyframe->xEasingFunc](t);
+
+        if (keyframe->enabledProperties & WIDGET_TIMELINE_PROPERTY_CP2) {
+            auto p1 = state.x;
+            auto p2 = keyframe->cp1x;
+            auto p3 = keyframe->cp2x;
+            auto p4 = keyframe->x;
+            state.x =
+                (1 - t2) * (1 - t2) * (1 - t2) * p1 +
+                3 * (1 - t2) * (1 - t2) * t2 * p2 +
+                3 * (1 - t2) * t2 * t2 * p3 +
+                t2 * t2 * t2 * p4;
+        } else if (keyframe->enabledProperties & WIDGET_TIMELINE_PROPERTY_CP1) {
+            auto p1 = state.x;
+            auto p2 = keyframe->cp1x;
+            auto p3 = keyframe->x;
+            state.x =
+                (1 - t2) * (1 - t2) * p1 +
+                2 * (1 - t2) * t2 * p2 +
+                t2 * t2 * p3;
+        } else {
+            auto p1 = state.x;
+            auto p2 = keyframe->x;
+            state.x = (1 - t2) * p1 + t2 * p2;
+        }
+    }
 
-                if (keyframe->enabledProperties & WIDGET_TIMELINE_PROPERTY_Y) {
-                    auto t2 = g_easingFuncs[keyframe->yEasingFunc](t);
-
-                    if (keyframe->enabledProperties & WIDGET_TIMELINE_PROPERTY_CP2) {
-                        auto p1 = y;
-                        auto p2 = keyframe->cp1y;
-                        auto p3 = keyframe->cp2y;
-                        auto p4 = keyframe->y;
-                        y =
-                            (1 - t2) * (1 - t2) * (1 - t2) * p1 +
-                            3 * (1 - t2) * (1 - t2) * t2 * p2 +
-                            3 * (1 - t2) * t2 * t2 * p3 +
-                            t2 * t2 * t2 * p4;
-                    } else if (keyframe->enabledProperties & WIDGET_TIMELINE_PROPERTY_CP1) {
-                        auto p1 = y;
-                        auto p2 = keyframe->cp1y;
-                        auto p3 = keyframe->y;
-                        y =
-                            (1 - t2) * (1 - t2) * p1 +
-                            2 * (1 - t2) * t2 * p2 +
-                            t2 * t2 * p3;
-                    } else {
-                        auto p1 = y;
-                        auto p2 = keyframe->y;
-                        y = (1 - t2) * p1 + t2 * p2;
-                    }
-                }
+    if (keyframe->enabledProperties & WIDGET_TIMELINE_PROPERTY_WIDTH) {
+        state.w += g_easingFuncs[keyframe->widthEasingFunc](t) * (keyframe->width - state.w);
+    }
 
-                if (keyframe->enabledProperties & WIDGET_TIMELINE_PROPERTY_HEIGHT) {
-                    h += g_easingFuncs[keyframe->heightEasingFunc](t) * (keyframe->height - h);
-                }
+    if (keyframe->enabledProperties & WIDGET_TIMELINE_PROPERTY_Y) {
+        auto t2 = g_easingFuncs[keyframe->yEasingFunc](t);
+
+        if (keyframe->enabledProperties & WIDGET_TIMELINE_PROPERTY_CP2) {
+            auto p1 = state.y;
+            auto p2 = keyframe->cp1y;
+            auto p3 = keyframe->cp2y;
+            auto p4 = keyframe->y;
+            state.y =
+                (1 - t2) * (1 - t2) * (1 - t2) * p1 +
+                3 * (1 - t2) * (1 - t2) * t2 * p2 +
+                3 * (1 - t2) * t2 * t2 * p3 +
+                t2 * t2 * t2 * p4;
+        } else if (keyframe->enabledProperties & WIDGET_TIMELINE_PROPERTY_CP1) {
+            auto p1 = state.y;
+            auto p2 = keyframe->cp1y;
+            auto p3 = keyframe->y;
+            state.y =
+                (1 - t2) * (1 - t2) * p1 +
+                2 * (1 - t2) * t2 * p2 +
+                t2 * t2 * p3;
+        } else {
+            auto p1 = state.y;
+            auto p2 = keyframe->y;
+            state.y = (1 - t2) * p1 + t2 * p2;
+        }
+    }
 
-                if (keyframe->enabledProperties & WIDGET_TIMELINE_PROPERTY_OPACITY) {
-                    opacity += g_easingFuncs[keyframe->opacityEasingFunc](t) * (keyframe->opacity - opacity);
-                }
+    if (keyframe->enabledProperties & WIDGET_TIMELINE_PROPERTY_HEIGHT) {
+        state.h += g_easingFuncs[keyframe->heightEasingFunc](t) * (keyframe->height - state.h);
+    }
 
-                break;
-            }
+    if (keyframe->enabledProperties & WIDGET_TIMELINE_PROPERTY_OPACITY) {
+        state.opacity += g_easingFuncs[keyframe->opacityEasingFunc](t) * (keyframe->opacity - state.opacity);
+    }
+}
 
-            if (keyframe->enabledProperties & WIDGET_TIMELINE_PROPERTY_X) {
-                x = keyframe->x;
-            }
-            if (keyframe->enabledProperties & WIDGET_TIMELINE_PROPERTY_Y) {
-                y = keyframe->y;
-            }
-            if (keyframe->enabledProperties & WIDGET_TIMELINE_PROPERTY_WIDTH) {
-                w = keyframe->width;
-            }
-            if (keyframe->enabledProperties & WIDGET_TIMELINE_PROPERTY_HEIGHT) {
-                h = keyframe->height;
+static void finishKeyframe(const TimelineKeyframe *keyframe, TimelineState &state) {
+    if (keyframe->enabledProperties & WIDGET_TIMELINE_PROPERTY_X) {
+        state.x = keyframe->x;
+    }
+    if (keyframe->enabledProperties & WIDGET_TIMELINE_PROPERTY_Y) {
+        state.y = keyframe->y;
+    }
+    if (keyframe->enabledProperties & WIDGET_TIMELINE_PROPERTY_WIDTH) {
+        state.w = keyframe->width;
+    }
+    if (keyframe->enabledProperties & WIDGET_TIMELINE_PROPERTY_HEIGHT) {
+        state.h = keyframe->height;
+    }
+
+    if (keyframe->enabledProperties & WIDGET_TIMELINE_PROPERTY_OPACITY) {
+        state.opacity = keyframe->opacity;
+    }
+}
+
+static void getInitialTimelineState(const Widget *widget, TimelineState &state) {
+    state.x = widget->x;
+    state.y = widget->y;
+    state.w = widget->width;
+    state.h = widget->height;
+    state.opacity = 1.0f;
+}
+
+static TimelineIndex *buildTimelineIndex(const Assets *assets, const Widget *widget) {
+    uint32_t count = widget->timeline.count;
+
+    auto index = (TimelineIndex *)alloc(
+        sizeof(TimelineIndex) +
+        count * sizeof(const TimelineKeyframe *) +
+        (count + 1) * sizeof(TimelineState),
+        0x2c8e1f7a
+    );
+    if (!index) {
+        return nullptr;
+    }
+
+    index->assets = assets;
+    index->widget = widget;
+    index->count = count;
+    index->keyframes = (const TimelineKeyframe **)(index + 1);
+    index->states = (TimelineState *)(index->keyframes + count);
+    index->lastStateValid = false;
+
+    for (uint32_t i = 0; i < count; i++) {
+        index->keyframes[i] = widget->timeline[i];
+    }
+
+    std::stable_sort(index->keyframes, index->keyframes + count, [](const TimelineKeyframe *a, const TimelineKeyframe *b) {
+        return a->start < b->start;
+    });
+
+    index->sequential = true;
+    for (uint32_t i = 0; i < count; i++) {
+        auto keyframe = index->keyframes[i];
+        if (
+            keyframe->start > keyframe->end ||
+            (i > 0 && index->keyframes[i - 1]->end > keyframe->start)
+        ) {
+            index->sequential = false;
+            break;
+        }
+    }
+
+    if (index->sequential) {
+        getInitialTimelineState(widget, index->states[0]);
+        for (uint32_t i = 0; i < count; i++) {
+            index->states[i + 1] = index->states[i];
+            finishKeyframe(index->keyframes[i], index->states[i + 1]);
+        }
+    }
+
+    return index;
+}
+
+static TimelineIndex *getTimelineIndex(const Assets *assets, const Widget *widget) {
+    auto slot = (uint32_t)(((uintptr_t)widget >> 2) * 2654435761u) % EEZ_GUI_TIMELINE_CACHE_SIZE;
+
+    auto index = g_timelineCache[slot];
+    if (index && index->widget == widget && index->assets == assets) {
+        return index;
+    }
+
+    if (index) {
+        free(index);
+    }
+
+    index = buildTimelineIndex(assets, widget);
+    g_timelineCache[slot] = index;
+    return index;
+}
+
+void resetTimelineCache() {
+    for (uint32_t i = 0; i < EEZ_GUI_TIMELINE_CACHE_SIZE; i++) {
+        if (g_timelineCache[i]) {
+            free(g_timelineCache[i]);
+            g_timelineCache[i] = nullptr;
+        }
+    }
+}
+
+static void evaluateTimeline(const Widget *widget, const TimelineIndex *index, float timelinePosition, TimelineState &state) {
+    if (index && index->sequential) {
+        auto keyframes = index->keyframes;
+        auto count = index->count;
+
+        if (timelinePosition < keyframes[0]->start) {
+            state = index->states[0];
+            return;
+        }
+
+        if (timelinePosition > keyframes[count - 1]->end) {
+            // timeline is finished
+            state = index->states[count];
+            return;
+        }
+
+        // find the first keyframe which is not finished
+        uint32_t lo = 0;
+        uint32_t hi = count - 1;
+        while (lo < hi) {
+            auto mid = (lo + hi) / 2;
+            if (keyframes[mid]->end < timelinePosition) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
             }
+        }
+
+        state = index->states[lo];
+        if (timelinePosition >= keyframes[lo]->start) {
+            applyKeyframe(keyframes[lo], timelinePosition, state);
+        }
+        return;
+    }
+
+    // keyframes are overlapping, replay the whole timeline
+    getInitialTimelineState(widget, state);
+
+    for (uint32_t i = 0; i < widget->timeline.count; i++) {
+        auto keyframe = widget->timeline[i];
+
+        if (timelinePosition < keyframe->start) {
+            continue;
+        }
 
-            if (keyframe->enabledProperties & WIDGET_TIMELINE_PROPERTY_OPACITY) {
-                opacity = keyframe->opacity;
+        if (
+            timelinePosition >= keyframe->start &&
+            timelinePosition <= keyframe->end
+        ) {
+            applyKeyframe(keyframe, timelinePosition, state);
+            break;
+        }
+
+        finishKeyframe(keyframe, state);
+    }
+}
+
+void applyTimeline(WidgetCursor& widgetCursor, Rect &widgetRect) {
+    auto widget = widgetCursor.widget;
+
+    if (widget->timeline.count > 0) {
+        // position depends on the flow timeline, so it can't be in the valid cached layer
+        g_cachedLayerDirty = true;
+
+        auto timelinePosition = widgetCursor.flowState->timelinePosition;
+
+        TimelineState state;
+
+        auto index = getTimelineIndex(widgetCursor.assets, widget);
+        if (index && index->lastStateValid && index->lastTimelinePosition == timelinePosition) {
+            state = index->lastState;
+        } else {
+            evaluateTimeline(widget, index, timelinePosition, state);
+            if (index) {
+                index->lastStateValid = true;
+                index->lastTimelinePosition = timelinePosition;
+                index->lastState = state;
             }
         }
 
-        widgetRect.x = x;
-        widgetRect.y = y;
+        widgetRect.x = state.x;
+        widgetRect.y = state.y;
 
-        widgetRect.w = w;
-        widgetRect.h = h;
+        widgetRect.w = state.w;
+        widgetRect.h = state.h;
 
-        widgetCursor.opacity = (uint8_t)roundf(255.0f * opacity);
+        widgetCursor.opacity = (uint8_t)roundf(255.0f * state.opacity);
     } else {
-        widgetRect.x = widgetCursor.widget->x;
-        widgetRect.y = widgetCursor.widget->y;
+        widgetRect.x = widget->x;
+        widgetRect.y = widget->y;
 
-        widgetRect.w = widgetCursor.widget->width;
-        widgetRect.h = widgetCursor.widget->height;
+        widgetRect.w = widget->width;
+        widgetRect.h = widget->height;
     }
 }
 
@@ -265,6 +265,14 @@ void enumNoneWidget();
 extern bool g_foundWidgetAtDownInvalid;
 void freeWidgetStates(WidgetState *topWidgetState);
 
+// Used by List and Grid on scroll: items are numItems consecutive state trees
+// of itemStateSize bytes each. After rotation, i-th item has the state of the
+// (i + delta)-th item (modulo numItems).
+void rotateWidgetStates(WidgetState *itemsStateStart, uint32_t itemStateSize, int numItems, int delta);
+// Moves coordinates of all the states in [start, end), use it after their
+// rendered content was moved with display::bitBlt so they are not rendered again.
+void moveWidgetStates(WidgetState *start, WidgetState *end, int dx, int dy);
+
 typedef void (*EnumWidgetsCallback)();
 extern EnumWidgetsCallback g_findCallback;
 void forEachWidget(EnumWidgetsCallback callback);
@@ -288,6 +296,10 @@ void applyTimeline(
     Rect &widgetRect
 );
 
+// Cache is keyed by assets and widget, but it must still be reset when the assets
+// returned by resolveExternalPage hook are freed or reloaded at the same address.
+void resetTimelineCache();
+
 void doStaticLayout(
     WidgetCursor& widgetCursor,
     const ListOfAssetsPtr<Widget> &widgets,
@@ -70,14 +70,48 @@ void ContainerWidgetState::render() {
 	repainted = true;
 }
 
+bool ContainerWidgetState::skipCachedLayerChildren() {
+    WidgetCursor &widgetCursor = g_widgetCursor;
+	auto widget = (const ContainerWidget *)widgetCursor.widget;
+
+    if (overlay || !isCachedLayer(widget)) {
+        return false;
+    }
+
+    if (
+        cachedLayerValid &&
+        g_findCallback == nullptr &&
+        widgetCursor.hasPreviousState &&
+        !widgetCursor.refreshed &&
+        !repainted &&
+        !g_activeWidget &&
+        cachedLayerEpoch == g_cachedLayersEpoch
+    ) {
+        // children states are kept, their pixels are already in the page buffer
+        widgetCursor.currentState = (WidgetState *)((uint8_t *)widgetCursor.currentState + cachedLayerStateSize);
+        return true;
+    }
+
+    return false;
+}
+
 void ContainerWidgetState::enumChildren() {
     if (overlay && overlayState == 0) {
         return;
     }
 
+    if (skipCachedLayerChildren()) {
+        return;
+    }
+
     WidgetCursor &widgetCursor = g_widgetCursor;
 	auto widget = (const ContainerWidget *)widgetCursor.widget;
 
+    auto childrenStateStart = (uint8_t *)widgetCursor.currentState;
+
+    bool savedCachedLayerDirty = g_cachedLayerDirty;
+    g_cachedLayerDirty = false;
+
 	bool savedRefreshed = false;
 
 	if (g_findCallback == nullptr) {
@@ -275,7 +309,17 @@ void ContainerWidgetState::enumChildren() {
 		}
 
 		widgetCursor.refreshed = savedRefreshed;
+
+        if (!overlay && isCachedLayer(widget)) {
+            // children can be skipped only if none of them changed or read some data in this pass
+            cachedLayerValid = !g_cachedLayerDirty;
+            cachedLayerEpoch = g_cachedLayersEpoch;
+            cachedLayerStateSize = (uint8_t *)widgetCursor.currentState - childrenStateStart;
+        }
 	}
+
+    // propagate to the parent cached layer
+    g_cachedLayerDirty = savedCachedLayerDirty || g_cachedLayerDirty;
 }
 
 } // namespace gui
@@ -43,10 +43,18 @@ struct ContainerWidgetState : public WidgetState {
 	bool repainted;
     int offsetPrevious;
 
+    // see setCachedLayer
+    bool cachedLayerValid = false;
+    uint32_t cachedLayerEpoch = 0;
+    uint32_t cachedLayerStateSize = 0;
+
     bool updateState() override;
 	void render() override;
 	void enumChildren() override;
 	void renderOverlayChildren();
+
+private:
+    bool skipCachedLayerChildren();
 };
 
 } // namespace gui
@@ -29,11 +29,60 @@ namespace gui {
 #define GRID_FLOW_ROW 1
 #define GRID_FLOW_COLUMN 2
 
+// number of items in a row (GRID_FLOW_ROW) or column (GRID_FLOW_COLUMN)
+static int getNumItemsPerLine(const GridWidget *widget, int width, int height) {
+    auto childWidget = static_cast<const Widget *>(widget->itemWidget);
+    int n = widget->gridFlow == GRID_FLOW_ROW ? width / childWidget->width : height / childWidget->height;
+    return n > 1 ? n : 1;
+}
+
+static int getNumLines(const GridWidget *widget, int width, int height) {
+    auto childWidget = static_cast<const Widget *>(widget->itemWidget);
+    int n = widget->gridFlow == GRID_FLOW_ROW ? height / childWidget->height : width / childWidget->width;
+    return n > 1 ? n : 1;
+}
+
+static bool canScroll(const GridWidgetState *state, const GridWidget *widget, int newStartPosition, int newCount) {
+    if (g_widgetCursor.refreshed || state->itemStateSize == 0 || newCount != state->count) {
+        return false;
+    }
+
+    if (widget->visible && !state->isVisible.toBool()) {
+        return false;
+    }
+
+    // items must not be drawn outside of the grid
+    auto childWidget = static_cast<const Widget *>(widget->itemWidget);
+    if (childWidget->width > state->w || childWidget->height > state->h) {
+        return false;
+    }
+
+    // scroll by whole lines and all the items, before and after scroll, must have widget states
+    int numItemsPerLine = getNumItemsPerLine(widget, state->w, state->h);
+    int numVisibleItems = numItemsPerLine * getNumLines(widget, state->w, state->h);
+    int delta = newStartPosition - state->startPosition;
+    return
+        delta % numItemsPerLine == 0 && delta > -numVisibleItems && delta < numVisibleItems &&
+        state->startPosition >= 0 && state->startPosition + numVisibleItems <= state->count &&
+        newStartPosition >= 0 && newStartPosition + numVisibleItems <= state->count;
+}
+
 bool GridWidgetState::updateState() {
     WIDGET_STATE_START(GridWidget);
 
-    startPosition = ytDataGetPosition(widgetCursor, widget->data);
-    count = eez::gui::count(widgetCursor, widget->data);
+    scrollDelta = 0;
+
+    int newStartPosition = ytDataGetPosition(widgetCursor, widget->data);
+    int newCount = eez::gui::count(widgetCursor, widget->data);
+    if (hasPreviousState && newStartPosition != startPosition && canScroll(this, widget, newStartPosition, newCount)) {
+        // see enumChildren
+        scrollDelta = newStartPosition - startPosition;
+    }
+
+    startPosition = newStartPosition;
+    count = newCount;
+
+    setViewport(widgetCursor, widget->data, startPosition, getNumItemsPerLine(widget, w, h) * getNumLines(widget, w, h));
 
     WIDGET_STATE_END()
 }
@@ -60,6 +109,55 @@ void GridWidgetState::enumChildren() {
         auto width = widgetCursor.w;
         auto height = widgetCursor.h;
 
+        if (scrollDelta != 0 && g_findCallback == nullptr) {
+            // Scroll by moving the already rendered lines with bitBlt. Their widget
+            // states are rotated to the new position, so only the items in the
+            // newly exposed lines are rendered again.
+            int numItemsPerLine = getNumItemsPerLine(widget, width, height);
+            int numLines = getNumLines(widget, width, height);
+            int numVisibleItems = numItemsPerLine * numLines;
+            int move = -scrollDelta / numItemsPerLine;
+
+            if (widget->gridFlow == GRID_FLOW_ROW) {
+                int x2 = savedX + numItemsPerLine * childWidget->width - 1;
+                int shift = (move > 0 ? move : -move) * childWidget->height;
+                int y2 = savedY + numLines * childWidget->height - 1;
+                if (move < 0) {
+                    display::bitBlt(savedX, savedY + shift, x2, y2, savedX, savedY);
+                } else {
+                    display::bitBlt(savedX, savedY, x2, y2 - shift, savedX, savedY + shift);
+                }
+            } else {
+                int x2 = savedX + numLines * childWidget->width - 1;
+                int shift = (move > 0 ? move : -move) * childWidget->width;
+                int y2 = savedY + numItemsPerLine * childWidget->height - 1;
+                if (move < 0) {
+                    display::bitBlt(savedX + shift, savedY, x2, y2, savedX, savedY);
+                } else {
+                    display::bitBlt(savedX, savedY, x2 - shift, y2, savedX + shift, savedY);
+                }
+            }
+
+            rotateWidgetStates(widgetCursor.currentState, itemStateSize, numVisibleItems, scrollDelta);
+
+            for (int i = 0; i < numVisibleItems; i++) {
+                int oldIndex = i + scrollDelta;
+                if (oldIndex >= 0 && oldIndex < numVisibleItems) {
+                    auto itemStateStart = (uint8_t *)widgetCursor.currentState + i * itemStateSize;
+                    if (widget->gridFlow == GRID_FLOW_ROW) {
+                        moveWidgetStates((WidgetState *)itemStateStart, (WidgetState *)(itemStateStart + itemStateSize), 0, move * childWidget->height);
+                    } else {
+                        moveWidgetStates((WidgetState *)itemStateStart, (WidgetState *)(itemStateStart + itemStateSize), move * childWidget->width, 0);
+                    }
+                }
+            }
+
+            scrollDelta = 0;
+        }
+
+        uint32_t firstItemStateSize = 0;
+        bool sameItemStateSize = true;
+
         for (int index = startPosition; index < count; ++index) {
             select(widgetCursor, widget->data, index, oldValue);
 
@@ -68,10 +166,19 @@ void GridWidgetState::enumChildren() {
             widgetCursor.w = childWidget->width;
             widgetCursor.h = childWidget->height;
 
+            auto itemStateStart = (uint8_t *)widgetCursor.currentState;
+
 			widgetCursor.pushIterator(index);
             enumWidget();
 			widgetCursor.popIterator();
 
+            uint32_t stateSize = (uint8_t *)widgetCursor.currentState - itemStateStart;
+            if (firstItemStateSize == 0) {
+                firstItemStateSize = stateSize;
+            } else if (stateSize != firstItemStateSize) {
+                sameItemStateSize = false;
+            }
+
             if (widget->gridFlow == GRID_FLOW_ROW) {
                 xOffset += childWidget->width;
 
@@ -96,6 +203,10 @@ void GridWidgetState::enumChildren() {
 
         deselect(widgetCursor, widget->data, oldValue);
 
+        if (g_findCallback == nullptr) {
+            itemStateSize = sameItemStateSize ? firstItemStateSize : 0;
+        }
+
 		widgetCursor.widget = widget;
 
 		widgetCursor.x = savedX;
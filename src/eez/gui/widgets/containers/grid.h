@@ -29,6 +29,8 @@ struct GridWidget : public Widget {
 struct GridWidgetState : public WidgetState {
     int startPosition;
     int count;
+    int scrollDelta; // set by updateState if items which stay visible can be reused
+    uint32_t itemStateSize; // 0 if item states are not all of the same size
 
     bool updateState() override;
     void enumChildren() override;
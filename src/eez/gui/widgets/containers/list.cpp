@@ -29,20 +29,64 @@ namespace gui {
 #define LIST_TYPE_VERTICAL 1
 #define LIST_TYPE_HORIZONTAL 2
 
+static int getNumVisibleItems(const ListWidget *widget, int width, int height) {
+    auto childWidget = static_cast<const Widget *>(widget->itemWidget);
+    if (widget->listType == LIST_TYPE_VERTICAL) {
+        int stride = childWidget->height + widget->gap;
+        return stride > 0 ? (height + stride - 1) / stride : 0;
+    } else {
+        int stride = childWidget->width + widget->gap;
+        return stride > 0 ? (width + stride - 1) / stride : 0;
+    }
+}
+
+static bool canScroll(const ListWidgetState *state, const ListWidget *widget, int newStartPosition, int newCount) {
+    if (g_widgetCursor.refreshed || state->itemStateSize == 0 || newCount != state->count) {
+        return false;
+    }
+
+    if (widget->visible && !state->isVisible.toBool()) {
+        return false;
+    }
+
+    // items must not be drawn outside of the list
+    auto childWidget = static_cast<const Widget *>(widget->itemWidget);
+    if (widget->listType == LIST_TYPE_VERTICAL ? childWidget->width > state->w : childWidget->height > state->h) {
+        return false;
+    }
+
+    // all the items, before and after scroll, must have widget states
+    int numVisibleItems = getNumVisibleItems(widget, state->w, state->h);
+    int delta = newStartPosition - state->startPosition;
+    return
+        numVisibleItems > 0 && delta > -numVisibleItems && delta < numVisibleItems &&
+        state->startPosition >= 0 && state->startPosition + numVisibleItems <= state->count &&
+        newStartPosition >= 0 && newStartPosition + numVisibleItems <= state->count;
+}
+
 bool ListWidgetState::updateState() {
     WIDGET_STATE_START(ListWidget);
 
+    scrollDelta = 0;
+
     auto newStartPosition = ytDataGetPosition(widgetCursor, widget->data);
+    auto newCount = eez::gui::count(widgetCursor, widget->data);
     if ((int)newStartPosition != startPosition) {
+        if (hasPreviousState && canScroll(this, widget, newStartPosition, newCount)) {
+            // see enumChildren
+            scrollDelta = newStartPosition - startPosition;
+        } else {
+            hasPreviousState = false;
+        }
         startPosition = newStartPosition;
-        hasPreviousState = false;
     }
-    auto newCount = eez::gui::count(widgetCursor, widget->data);
     if (newCount != count) {
         count = newCount;
         hasPreviousState = false;
     }
 
+    setViewport(widgetCursor, widget->data, startPosition, getNumVisibleItems(widget, w, h));
+
     WIDGET_STATE_END()
 }
 
@@ -67,6 +111,48 @@ void ListWidgetState::enumChildren() {
     auto width = widgetCursor.w;
     auto height = widgetCursor.h;
 
+    if (scrollDelta != 0 && g_findCallback == nullptr) {
+        // Scroll by moving the already rendered items with bitBlt. Their widget
+        // states are rotated to the new position, so only the newly exposed
+        // items (and partially visible ones) are rendered again.
+        bool vertical = widget->listType == LIST_TYPE_VERTICAL;
+        int size = vertical ? height : width;
+        int itemSize = vertical ? childWidget->height : childWidget->width;
+        int stride = itemSize + widget->gap;
+        int numVisibleItems = getNumVisibleItems(widget, width, height);
+        int shift = (scrollDelta > 0 ? scrollDelta : -scrollDelta) * stride;
+
+        if (vertical) {
+            if (scrollDelta > 0) {
+                display::bitBlt(savedX, savedY + shift, savedX + width - 1, savedY + height - 1, savedX, savedY);
+            } else {
+                display::bitBlt(savedX, savedY, savedX + width - 1, savedY + height - 1 - shift, savedX, savedY + shift);
+            }
+        } else {
+            if (scrollDelta > 0) {
+                display::bitBlt(savedX + shift, savedY, savedX + width - 1, savedY + height - 1, savedX, savedY);
+            } else {
+                display::bitBlt(savedX, savedY, savedX + width - 1 - shift, savedY + height - 1, savedX + shift, savedY);
+            }
+        }
+
+        rotateWidgetStates(widgetCursor.currentState, itemStateSize, numVisibleItems, scrollDelta);
+
+        for (int i = 0; i < numVisibleItems; i++) {
+            int oldIndex = i + scrollDelta;
+            if (oldIndex >= 0 && oldIndex < numVisibleItems && oldIndex * stride + itemSize <= size && i * stride + itemSize <= size) {
+                auto itemStateStart = (uint8_t *)widgetCursor.currentState + i * itemStateSize;
+                int move = (i - oldIndex) * stride;
+                moveWidgetStates((WidgetState *)itemStateStart, (WidgetState *)(itemStateStart + itemStateSize), vertical ? 0 : move, vertical ? move : 0);
+            }
+        }
+
+        scrollDelta = 0;
+    }
+
+    uint32_t firstItemStateSize = 0;
+    bool sameItemStateSize = true;
+
     for (int index = startPosition; ; ++index) {
         if (index >= 0 && index < count) {
             select(widgetCursor, widget->data, index, oldValue);
@@ -74,6 +160,8 @@ void ListWidgetState::enumChildren() {
             widgetCursor.w = childWidget->width;
             widgetCursor.h = childWidget->height;
 
+            auto itemStateStart = (uint8_t *)widgetCursor.currentState;
+
             if (widget->listType == LIST_TYPE_VERTICAL) {
                 if (offset < height) {
                     widgetCursor.y = savedY + offset;
@@ -95,6 +183,13 @@ void ListWidgetState::enumChildren() {
                     break;
                 }
             }
+
+            uint32_t stateSize = (uint8_t *)widgetCursor.currentState - itemStateStart;
+            if (firstItemStateSize == 0) {
+                firstItemStateSize = stateSize;
+            } else if (stateSize != firstItemStateSize) {
+                sameItemStateSize = false;
+            }
         } else {
             widgetCursor.w = childWidget->width;
             widgetCursor.h = childWidget->height;
@@ -121,6 +216,10 @@ void ListWidgetState::enumChildren() {
 
     deselect(widgetCursor, widget->data, oldValue);
 
+    if (g_findCallback == nullptr) {
+        itemStateSize = sameItemStateSize ? firstItemStateSize : 0;
+    }
+
     widgetCursor.widget = widget;
 
     widgetCursor.x = savedX;
@@ -12,6 +12,9 @@
 
 #if EEZ_OPTION_GUI
 
+#include <math.h>
+#include <string.h>
+
 #include <eez/core/util.h>
 
 #include <eez/gui/gui.h>
@@ -19,6 +22,12 @@
 
 #include <eez/libs/qrcodegen/qrcodegen.h>
 
+#include <agg_pixfmt_gray.h>
+#include <agg_rasterizer_scanline_aa.h>
+#include <agg_renderer_base.h>
+#include <agg_renderer_scanline.h>
+#include <agg_scanline_u.h>
+
 namespace eez {
 namespace gui {
 
@@ -30,14 +39,34 @@ bool QRCodeWidgetState::updateState() {
     WIDGET_STATE_END()
 }
 
-uint8_t qrcode[qrcodegen_BUFFER_LEN_MAX];
-uint8_t tempBuffer[qrcodegen_BUFFER_LEN_MAX];
+static uint8_t qrcode[qrcodegen_BUFFER_LEN_MAX];
+static uint8_t tempBuffer[qrcodegen_BUFFER_LEN_MAX];
 
-void QRCodeWidgetState::render() {
-    const WidgetCursor &widgetCursor = g_widgetCursor;
+QRCodeWidgetState::~QRCodeWidgetState() {
+    freeMask();
+    if (modules) {
+        free(modules);
+    }
+}
 
-    auto widget = (const QRCodeWidget *)widgetCursor.widget;
-    const Style *style = getStyle(widget->style);
+void QRCodeWidgetState::freeMask() {
+    if (mask) {
+        free(mask);
+        mask = nullptr;
+    }
+    maskWidgetWidth = 0;
+    maskWidgetHeight = 0;
+}
+
+void QRCodeWidgetState::encode(const QRCodeWidget *widget) {
+    freeMask();
+    if (modules) {
+        free(modules);
+        modules = nullptr;
+    }
+
+    encodedData = data;
+    encodedErrorCorrection = widget->errorCorrection;
 
     // Make QR code
     qrcodegen_Ecc errCorLvl;
@@ -48,10 +77,74 @@ void QRCodeWidgetState::render() {
 
 	qrcodegen_encodeText(data.getString(), tempBuffer, qrcode, errCorLvl, qrcodegen_VERSION_MIN, qrcodegen_VERSION_MAX, qrcodegen_Mask_AUTO, true);
 
-    display::setColor(style->backgroundColor);
-    display::fillRect(widgetCursor.x, widgetCursor.y, widgetCursor.x + widgetCursor.w - 1, widgetCursor.y + widgetCursor.h - 1);
-
     int size = qrcodegen_getSize(qrcode);
+    size_t modulesLength = (size * size + 7) / 8 + 1;
+
+    modules = (uint8_t *)alloc(modulesLength, 0x3e6c0a9d);
+    if (modules) {
+        memcpy(modules, qrcode, modulesLength);
+    }
+}
+
+void QRCodeWidgetState::rasterise(int widgetWidth, int widgetHeight) {
+    freeMask();
+
+    int size = qrcodegen_getSize(modules);
+    int border = 1;
+
+    double sizePx = 1.0 * MIN(widgetWidth, widgetHeight) / (size + 2 * border);
+
+    double xPadding = (widgetWidth - sizePx * size) / 2;
+    double yPadding = (widgetHeight - sizePx * size) / 2;
+
+    maskX = (int)floor(xPadding);
+    maskY = (int)floor(yPadding);
+    maskWidth = (int)ceil(xPadding + sizePx * size) - maskX;
+    maskHeight = (int)ceil(yPadding + sizePx * size) - maskY;
+
+    if (maskWidth <= 0 || maskHeight <= 0) {
+        return;
+    }
+
+    mask = (uint8_t *)alloc(maskWidth * maskHeight, 0xb1d45f27);
+    if (!mask) {
+        return;
+    }
+
+    maskWidgetWidth = widgetWidth;
+    maskWidgetHeight = widgetHeight;
+
+    agg::rendering_buffer rbuf(mask, maskWidth, maskHeight, maskWidth);
+    agg::pixfmt_gray8 pixf(rbuf);
+    agg::renderer_base<agg::pixfmt_gray8> rb(pixf);
+    rb.clear(agg::gray8(0));
+
+    agg::rasterizer_scanline_aa<> ras;
+    agg::scanline_u8 sl;
+
+    xPadding -= maskX;
+    yPadding -= maskY;
+
+    for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+            if (qrcodegen_getModule(modules, x, y)) {
+                double x1 = xPadding + x * sizePx;
+                double y1 = yPadding + y * sizePx;
+                ras.move_to_d(x1, y1);
+                ras.line_to_d(x1 + sizePx, y1);
+                ras.line_to_d(x1 + sizePx, y1 + sizePx);
+                ras.line_to_d(x1, y1 + sizePx);
+                ras.close_polygon();
+            }
+		}
+	}
+
+    agg::render_scanlines_aa_solid(ras, sl, rb, agg::gray8(255));
+}
+
+void QRCodeWidgetState::drawModules(const WidgetCursor &widgetCursor, const Style *style, const uint8_t *qrcodeModules) {
+    // fallback if there is no memory for the module matrix or mask
+    int size = qrcodegen_getSize(qrcodeModules);
     int border = 1;
 
     double sizePx = 1.0 * MIN(widgetCursor.w, widgetCursor.h) / (size + 2 * border);
@@ -69,7 +162,7 @@ void QRCodeWidgetState::render() {
 
     for (int y = 0; y < size; y++) {
 		for (int x = 0; x < size; x++) {
-            if (qrcodegen_getModule(qrcode, x, y)) {
+            if (qrcodegen_getModule(qrcodeModules, x, y)) {
                 graphics.moveTo(
                     widgetCursor.x + xPadding + x * sizePx,
                     widgetCursor.y + yPadding + y * sizePx
@@ -87,6 +180,37 @@ void QRCodeWidgetState::render() {
     graphics.drawPath();
 }
 
+void QRCodeWidgetState::render() {
+    const WidgetCursor &widgetCursor = g_widgetCursor;
+
+    auto widget = (const QRCodeWidget *)widgetCursor.widget;
+    const Style *style = getStyle(widget->style);
+
+    display::setColor(style->backgroundColor);
+    display::fillRect(widgetCursor.x, widgetCursor.y, widgetCursor.x + widgetCursor.w - 1, widgetCursor.y + widgetCursor.h - 1);
+
+    // re-encode only when data or error correction level changes
+    if (!modules || encodedData != data || encodedErrorCorrection != widget->errorCorrection) {
+        encode(widget);
+        if (!modules) {
+            drawModules(widgetCursor, style, qrcode);
+            return;
+        }
+    }
+
+    // re-rasterise only when size changes
+    if (!mask || maskWidgetWidth != widgetCursor.w || maskWidgetHeight != widgetCursor.h) {
+        rasterise(widgetCursor.w, widgetCursor.h);
+        if (!mask) {
+            drawModules(widgetCursor, style, modules);
+            return;
+        }
+    }
+
+    display::setColor(style->color);
+    display::drawMask(mask, maskWidth, maskHeight, widgetCursor.x + maskX, widgetCursor.y + maskY);
+}
+
 } // namespace gui
 } // namespace eez
 
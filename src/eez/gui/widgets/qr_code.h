@@ -20,8 +20,30 @@ struct QRCodeWidget : public Widget {
 struct QRCodeWidgetState : public WidgetState {
 	Value data;
 
+    ~QRCodeWidgetState();
+
     bool updateState() override;
     void render() override;
+
+private:
+    // encoded module matrix for encodedData and encodedErrorCorrection
+    Value encodedData;
+    uint16_t encodedErrorCorrection = 0;
+    uint8_t *modules = nullptr;
+
+    // modules rasterised at the widget size, drawn with the style color
+    int maskWidgetWidth = 0;
+    int maskWidgetHeight = 0;
+    int maskX = 0;
+    int maskY = 0;
+    int maskWidth = 0;
+    int maskHeight = 0;
+    uint8_t *mask = nullptr;
+
+    void encode(const QRCodeWidget *widget);
+    void rasterise(int widgetWidth, int widgetHeight);
+    void drawModules(const WidgetCursor &widgetCursor, const Style *style, const uint8_t *qrcodeModules);
+    void freeMask();
 };
 
 } // namespace gui
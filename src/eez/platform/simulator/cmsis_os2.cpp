@@ -134,60 +134,121 @@ osStatus osMutexRelease(osMutexId_t mutex) {
 ////////////////////////////////////////////////////////////////////////////////
 
 osMessageQueueId_t osMessageQueueNew(uint32_t msg_count, uint32_t msg_size, const void *) {
+    if (msg_count == 0 || msg_size == 0) {
+        return nullptr;
+    }
+
 	auto queue = new MessageQueue();
+    queue->buffer = new uint8_t[msg_count * msg_size];
 	queue->elementSize = msg_size;
+    queue->capacity = msg_count;
+    queue->head = 0;
+    queue->count = 0;
+#ifndef __EMSCRIPTEN__
+    queue->numGetWaiters = 0;
+    queue->numPutWaiters = 0;
+#endif
     return queue;
 }
 
-osStatus osMessageQueueGet(osMessageQueueId_t queue, void *msg_ptr, uint8_t *, uint32_t timeout) {
+static void popElement(osMessageQueueId_t queue, void *msg_ptr) {
+    memcpy(msg_ptr, queue->buffer + queue->head * queue->elementSize, queue->elementSize);
+    queue->head = (queue->head + 1) % queue->capacity;
+    queue->count--;
+}
+
+static void pushElement(osMessageQueueId_t queue, const void *msg_ptr) {
+    auto tail = (queue->head + queue->count) % queue->capacity;
+    memcpy(queue->buffer + tail * queue->elementSize, msg_ptr, queue->elementSize);
+    queue->count++;
+}
+
 #ifndef __EMSCRIPTEN__
-    if (timeout == 0) timeout = 1;
-    queue->mutex.lock();
+template <typename Predicate>
+static bool waitForQueue(std::unique_lock<std::mutex> &lock, std::condition_variable &cv, uint32_t &numWaiters, uint32_t timeout, Predicate predicate) {
+    if (predicate()) {
+        return true;
+    }
+
+    if (timeout == 0) {
+        return false;
+    }
+
+    bool result = true;
+
+    numWaiters++;
+    if (timeout == osWaitForever) {
+        cv.wait(lock, predicate);
+    } else {
+        result = cv.wait_for(lock, std::chrono::milliseconds(timeout), predicate);
+    }
+    numWaiters--;
+
+    return result;
+}
 #endif
 
-    while (queue->elements.empty()) {
+osStatus osMessageQueueGet(osMessageQueueId_t queue, void *msg_ptr, uint8_t *, uint32_t timeout) {
 #ifdef __EMSCRIPTEN__
+    if (queue->count == 0) {
         return osError;
-#else
-        queue->mutex.unlock();
+    }
 
-        osDelay(1);
+    popElement(queue, msg_ptr);
 
-		timeout -= 1;
-        if (timeout == 0) {
-            return osError;
-        }
+    return osOK;
+#else
+    // polling an empty queue doesn't touch the mutex
+    if (timeout == 0 && queue->count.load(std::memory_order_acquire) == 0) {
+        return osError;
+    }
 
-        queue->mutex.lock();
-#endif
+    std::unique_lock<std::mutex> lock(queue->mutex);
+
+    if (!waitForQueue(lock, queue->notEmpty, queue->numGetWaiters, timeout, [queue] { return queue->count > 0; })) {
+        return osError;
     }
 
-    auto data = queue->elements.front();
-    queue->elements.pop();
-    memcpy(msg_ptr, data, queue->elementSize);
-    delete [] data;
+    popElement(queue, msg_ptr);
 
-#ifndef __EMSCRIPTEN__
-    queue->mutex.unlock();
-#endif
+    // wake up the producer only if somebody is actually waiting for free space
+    bool notify = queue->numPutWaiters > 0;
+    lock.unlock();
+    if (notify) {
+        queue->notFull.notify_one();
+    }
 
     return osOK;
+#endif
 }
 
 osStatus osMessageQueuePut(osMessageQueueId_t queue, const void *msg_ptr, uint8_t, uint32_t timeout) {
-#ifndef __EMSCRIPTEN__
-    queue->mutex.lock();
-#endif
+#ifdef __EMSCRIPTEN__
+    if (queue->count == queue->capacity) {
+        return osError;
+    }
 
-    uint8_t *data = new uint8_t[queue->elementSize];
-	memcpy(data, msg_ptr, queue->elementSize);
-	queue->elements.push(data);
+    pushElement(queue, msg_ptr);
 
-#ifndef __EMSCRIPTEN__
-    queue->mutex.unlock();
-#endif
+    return osOK;
+#else
+    std::unique_lock<std::mutex> lock(queue->mutex);
+
+    if (!waitForQueue(lock, queue->notFull, queue->numPutWaiters, timeout, [queue] { return queue->count < queue->capacity; })) {
+        return osError;
+    }
+
+    pushElement(queue, msg_ptr);
+
+    // wake up the consumer only if it is blocked in osMessageQueueGet
+    bool notify = queue->numGetWaiters > 0;
+    lock.unlock();
+    if (notify) {
+        queue->notEmpty.notify_one();
+    }
 
     return osOK;
+#endif
 }
 
 #endif // EEZ_OPTION_THREADS
@@ -11,9 +11,10 @@
 #pragma once
 
 #include <stdint.h>
-#include <queue>
 
 #ifndef __EMSCRIPTEN__
+#include <atomic>
+#include <condition_variable>
 #include <mutex>
 #include <thread>
 #endif
@@ -107,11 +108,21 @@ osStatus osMutexRelease(osMutexId_t mutex);
 ////////////////////////////////////////////////////////////////////////////////
 // Message Queue
 
+// Bounded ring buffer of msg_count elements, allocated once in osMessageQueueNew.
 struct MessageQueue {
-    std::queue<uint8_t *> elements;
+    uint8_t *buffer;
 	uint32_t elementSize;
-#ifndef __EMSCRIPTEN__
+    uint32_t capacity;
+    uint32_t head; // index of the oldest element
+#ifdef __EMSCRIPTEN__
+    uint32_t count;
+#else
+    std::atomic<uint32_t> count;
 	std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    uint32_t numGetWaiters;
+    uint32_t numPutWaiters;
 #endif
 };
 
@@ -39,12 +39,162 @@
 
 #include <eez/gui/display-private.h>
 
+#if !defined(EEZ_DISPLAY_PARALLEL_RENDERING)
+#if defined(EEZ_PLATFORM_SIMULATOR) && !defined(__EMSCRIPTEN__)
+#define EEZ_DISPLAY_PARALLEL_RENDERING 1
+#else
+#define EEZ_DISPLAY_PARALLEL_RENDERING 0
+#endif
+#endif
+
+#if EEZ_DISPLAY_PARALLEL_RENDERING
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#endif
+
 namespace eez {
 namespace gui {
 namespace display {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// Large fills and blits (page changes, overlay compositing, full repaints) are split into
+// horizontal bands of rows which are processed in parallel. Each pixel is still computed
+// by exactly one thread with the same code, so the result is identical to the serial one.
+
+#if EEZ_DISPLAY_PARALLEL_RENDERING
+
+#if !defined(EEZ_DISPLAY_PARALLEL_RENDERING_MAX_THREADS)
+#define EEZ_DISPLAY_PARALLEL_RENDERING_MAX_THREADS 8
+#endif
+
+#if !defined(EEZ_DISPLAY_PARALLEL_RENDERING_MIN_PIXELS)
+#define EEZ_DISPLAY_PARALLEL_RENDERING_MIN_PIXELS (64 * 1024)
+#endif
+
+static const int ROWS_PER_BAND = 32;
+
+struct RowBandsPool {
+    std::mutex mutex;
+    std::condition_variable startCondition;
+    std::condition_variable doneCondition;
+
+    int numThreads = 0;
+    uint32_t generation = 0;
+    int numPendingThreads = 0;
+
+    const std::function<void(int, int)> *job = nullptr;
+    int y1;
+    int y2;
+    std::atomic<int> nextBand;
+    int numBands;
+
+    void runBands() {
+        while (true) {
+            int band = nextBand++;
+            if (band >= numBands) {
+                break;
+            }
+            int yStart = y1 + band * ROWS_PER_BAND;
+            int yEnd = yStart + ROWS_PER_BAND - 1;
+            if (yEnd > y2) {
+                yEnd = y2;
+            }
+            (*job)(yStart, yEnd);
+        }
+    }
+
+    void workerThread() {
+        uint32_t lastGeneration = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                startCondition.wait(lock, [&] { return generation != lastGeneration; });
+                lastGeneration = generation;
+            }
+
+            runBands();
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (--numPendingThreads == 0) {
+                    doneCondition.notify_one();
+                }
+            }
+        }
+    }
+
+    void run(int y1_, int y2_, const std::function<void(int, int)> &job_) {
+        job = &job_;
+        y1 = y1_;
+        y2 = y2_;
+        numBands = (y2 - y1 + ROWS_PER_BAND) / ROWS_PER_BAND;
+        nextBand = 0;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            numPendingThreads = numThreads;
+            generation++;
+        }
+        startCondition.notify_all();
+
+        // calling thread is also a worker
+        runBands();
+
+        std::unique_lock<std::mutex> lock(mutex);
+        doneCondition.wait(lock, [&] { return numPendingThreads == 0; });
+    }
+};
+
+static RowBandsPool *getRowBandsPool() {
+    // never destroyed, worker threads are running until the process exits
+    static RowBandsPool *pool = [] {
+        int numThreads = (int)std::thread::hardware_concurrency();
+        if (numThreads > EEZ_DISPLAY_PARALLEL_RENDERING_MAX_THREADS) {
+            numThreads = EEZ_DISPLAY_PARALLEL_RENDERING_MAX_THREADS;
+        }
+        if (numThreads < 2) {
+            return (RowBandsPool *)nullptr;
+        }
+
+        auto pool = new RowBandsPool();
+        pool->numThreads = numThreads - 1;
+        for (int i = 0; i < pool->numThreads; i++) {
+            std::thread(&RowBandsPool::workerThread, pool).detach();
+        }
+        return pool;
+    }();
+    return pool;
+}
+
+template<typename RowsFunc>
+static void forEachRowBand(int y1, int y2, int width, RowsFunc rowsFunc) {
+    if ((y2 - y1 + 1) * width >= EEZ_DISPLAY_PARALLEL_RENDERING_MIN_PIXELS && y2 - y1 + 1 > ROWS_PER_BAND) {
+        auto pool = getRowBandsPool();
+        if (pool) {
+            std::function<void(int, int)> job = rowsFunc;
+            pool->run(y1, y2, job);
+            return;
+        }
+    }
+    rowsFunc(y1, y2);
+}
+
+#else
+
+template<typename RowsFunc>
+static void forEachRowBand(int y1, int y2, int width, RowsFunc rowsFunc) {
+    EEZ_UNUSED(width);
+    rowsFunc(y1, y2);
+}
+
+#endif // EEZ_DISPLAY_PARALLEL_RENDERING
+
+////////////////////////////////////////////////////////////////////////////////
+
 #if EEZ_USE_SDL && !defined(__EMSCRIPTEN__)
 static SDL_Window *g_mainWindow;
 static SDL_Renderer *g_renderer;
@@ -206,7 +356,6 @@ void endPixelsDraw() {
 void fillRect(int x1, int y1, int x2, int y2) {
     uint32_t color32 = color16to32(g_fc, g_opacity);
 
-	uint32_t *dst = g_renderBuffer + y1 * DISPLAY_WIDTH + x1;
     int width = x2 - x1 + 1;
     if (width <= 0) {
         return;
@@ -215,49 +364,60 @@ void fillRect(int x1, int y1, int x2, int y2) {
     if (height <= 0) {
         return;
     }
-    int nl = DISPLAY_WIDTH - width;
-    if (g_opacity == 255) {
-        for (uint32_t *dstEnd = dst + height * DISPLAY_WIDTH; dst != dstEnd; dst += nl) {
-            for (uint32_t *lineEnd = dst + width; dst != lineEnd; dst++) {
-                *dst = color32;
+    uint32_t *renderBuffer = g_renderBuffer;
+    uint8_t opacity = g_opacity;
+    forEachRowBand(y1, y2, width, [=](int yStart, int yEnd) {
+	    uint32_t *dst = renderBuffer + yStart * DISPLAY_WIDTH + x1;
+        int nl = DISPLAY_WIDTH - width;
+        if (opacity == 255) {
+            for (uint32_t *dstEnd = dst + (yEnd - yStart + 1) * DISPLAY_WIDTH; dst != dstEnd; dst += nl) {
+                for (uint32_t *lineEnd = dst + width; dst != lineEnd; dst++) {
+                    *dst = color32;
+                }
             }
-        }
-    } else {
-        for (uint32_t *dstEnd = dst + height * DISPLAY_WIDTH; dst != dstEnd; dst += nl) {
-            for (uint32_t *lineEnd = dst + width; dst != lineEnd; dst++) {
-                *dst = blendColor(color32, *dst);
+        } else {
+            for (uint32_t *dstEnd = dst + (yEnd - yStart + 1) * DISPLAY_WIDTH; dst != dstEnd; dst += nl) {
+                for (uint32_t *lineEnd = dst + width; dst != lineEnd; dst++) {
+                    *dst = blendColor(color32, *dst);
+                }
             }
         }
-    }
+    });
 
     setDirty();
 }
 
 void fillRect(void *dstBuffer, int x1, int y1, int x2, int y2) {
     uint32_t color32 = color16to32(g_fc);
-    uint32_t *dst = (uint32_t *)dstBuffer + y1 * DISPLAY_WIDTH + x1;
-    int nl = DISPLAY_WIDTH - (x2 - x1 + 1);
-    for (int y = y1; y <= y2; y++) {
-        for (int x = x1; x <= x2; x++) {
-            *dst++ = color32;
+    forEachRowBand(y1, y2, x2 - x1 + 1, [=](int yStart, int yEnd) {
+        uint32_t *dst = (uint32_t *)dstBuffer + yStart * DISPLAY_WIDTH + x1;
+        int nl = DISPLAY_WIDTH - (x2 - x1 + 1);
+        for (int y = yStart; y <= yEnd; y++) {
+            for (int x = x1; x <= x2; x++) {
+                *dst++ = color32;
+            }
+            dst += nl;
         }
-        dst += nl;
-    }
+    });
 
     setDirty();
 }
 
 void bitBlt(int x1, int y1, int x2, int y2, int dstx, int dsty) {
     int width = x2 - x1 + 1;
+    int height = y2 - y1 + 1;
+    if (width <= 0 || height <= 0) {
+        return;
+    }
 
-    uint32_t *src = g_renderBuffer + y1 * DISPLAY_WIDTH + x1;
-    uint32_t *dst = g_renderBuffer + dsty * DISPLAY_WIDTH + dstx;
-    int nl = DISPLAY_WIDTH - width;
-
-    for (int y = y1; y <= y2; y++, src += nl, dst += nl) {
-        for (uint32_t *lineEnd = dst + width; dst != lineEnd; dst++, src++) {
-            uint8_t *src8 = (uint8_t *)src;
-            *dst = color16to32(RGB_TO_COLOR(src8[0], src8[1], src8[2]));
+    // source and destination can overlap (used for scrolling)
+    if (dsty > y1) {
+        for (int y = height - 1; y >= 0; y--) {
+            memmove(g_renderBuffer + (dsty + y) * DISPLAY_WIDTH + dstx, g_renderBuffer + (y1 + y) * DISPLAY_WIDTH + x1, width * sizeof(uint32_t));
+        }
+    } else {
+        for (int y = 0; y < height; y++) {
+            memmove(g_renderBuffer + (dsty + y) * DISPLAY_WIDTH + dstx, g_renderBuffer + (y1 + y) * DISPLAY_WIDTH + x1, width * sizeof(uint32_t));
         }
     }
 
@@ -270,12 +430,14 @@ void bitBlt(void *src, int x1, int y1, int x2, int y2) {
 }
 
 void bitBlt(void *src, void *dst, int x1, int y1, int x2, int y2) {
-    for (int y = y1; y <= y2; ++y) {
-        for (int x = x1; x <= x2; ++x) {
-            int i = y * DISPLAY_WIDTH + x;
-            ((uint32_t *)dst)[i] = ((uint32_t *)src)[i];
+    forEachRowBand(y1, y2, x2 - x1 + 1, [=](int yStart, int yEnd) {
+        for (int y = yStart; y <= yEnd; ++y) {
+            for (int x = x1; x <= x2; ++x) {
+                int i = y * DISPLAY_WIDTH + x;
+                ((uint32_t *)dst)[i] = ((uint32_t *)src)[i];
+            }
         }
-    }
+    });
 
     setDirty();
 }
@@ -285,24 +447,26 @@ void bitBlt(void *src, void *dst, int sx, int sy, int sw, int sh, int dx, int dy
         dst = g_renderBuffer;
     }
 
-    if (opacity == 255) {
-        for (int y = 0; y < sh; ++y) {
-            for (int x = 0; x < sw; ++x) {
-                ((uint32_t *)dst)[(dy + y) * DISPLAY_WIDTH + dx + x] = ((uint32_t *)src)[(sy + y) * DISPLAY_WIDTH + sx + x];
+    forEachRowBand(0, sh - 1, sw, [=](int yStart, int yEnd) {
+        if (opacity == 255) {
+            for (int y = yStart; y <= yEnd; ++y) {
+                for (int x = 0; x < sw; ++x) {
+                    ((uint32_t *)dst)[(dy + y) * DISPLAY_WIDTH + dx + x] = ((uint32_t *)src)[(sy + y) * DISPLAY_WIDTH + sx + x];
+                }
             }
-        }
-    } else {
-        for (int y = 0; y < sh; ++y) {
-            for (int x = 0; x < sw; ++x) {
-                uint8_t *p = (uint8_t *)&((uint32_t *)src)[(sy + y) * DISPLAY_WIDTH + sx + x];
-                p[3] = opacity;
-                ((uint32_t *)dst)[(dy + y) * DISPLAY_WIDTH + dx + x] = blendColor(
-                    ((uint32_t *)src)[(sy + y) * DISPLAY_WIDTH + sx + x],
-                    ((uint32_t *)dst)[(dy + y) * DISPLAY_WIDTH + dx + x]
-                );
+        } else {
+            for (int y = yStart; y <= yEnd; ++y) {
+                for (int x = 0; x < sw; ++x) {
+                    uint8_t *p = (uint8_t *)&((uint32_t *)src)[(sy + y) * DISPLAY_WIDTH + sx + x];
+                    p[3] = opacity;
+                    ((uint32_t *)dst)[(dy + y) * DISPLAY_WIDTH + dx + x] = blendColor(
+                        ((uint32_t *)src)[(sy + y) * DISPLAY_WIDTH + sx + x],
+                        ((uint32_t *)dst)[(dy + y) * DISPLAY_WIDTH + dx + x]
+                    );
+                }
             }
         }
-    }
+    });
 }
 
 void drawBitmap(Image *image, int x, int y) {
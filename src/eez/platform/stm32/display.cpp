@@ -440,7 +440,30 @@ void fillRect(int x1, int y1, int x2, int y2) {
 }
 
 void bitBlt(int x1, int y1, int x2, int y2, int dstx, int dsty) {
-    bitBlt(g_renderBuffer, g_renderBuffer, x1, y1, x2-x1+1, y2-y1+1, dstx, dsty);
+    int width = x2 - x1 + 1;
+    int height = y2 - y1 + 1;
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+
+    // Source and destination can overlap (used for scrolling). DMA2D copies
+    // top to bottom and left to right, so when moving down or right copy
+    // in the non overlapping bands starting from the end.
+    if (dsty > y1 && dsty - y1 < height) {
+        int bandHeight = dsty - y1;
+        for (int y = height; y > 0; y -= bandHeight) {
+            int h = MIN(bandHeight, y);
+            bitBlt(g_renderBuffer, g_renderBuffer, x1, y1 + y - h, width, h, dstx, dsty + y - h);
+        }
+    } else if (dsty == y1 && dstx > x1 && dstx - x1 < width) {
+        int bandWidth = dstx - x1;
+        for (int x = width; x > 0; x -= bandWidth) {
+            int w = MIN(bandWidth, x);
+            bitBlt(g_renderBuffer, g_renderBuffer, x1 + x - w, y1, w, height, dstx + x - w, dsty);
+        }
+    } else {
+        bitBlt(g_renderBuffer, g_renderBuffer, x1, y1, width, height, dstx, dsty);
+    }
 
     setDirty();
 }
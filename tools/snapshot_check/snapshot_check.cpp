@@ -0,0 +1,165 @@
+/*
+ * eez-framework
+ *
+ * MIT License
+ * Copyright 2024 Envox d.o.o.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Checks that the flow restored from the snapshot behaves the same as the flow that was
+// never stopped and compares restoreSnapshot() time with the cold start() time.
+//
+//   1. cold start: start(assets) and the first tick (init flows), then run for <warmup ms>
+//   2. take the snapshot, run for <run ms> and remember global variables
+//   3. stop, restoreSnapshot() and the first tick, run for <run ms> and compare global variables
+//
+// Both runs are driven by the same fixed time schedule: millis() and Date.now() don't follow
+// the real time, they start from the time at which the snapshot was taken and advance by
+// TICK_PERIOD_MS before each tick, so Delay, Animate, ... behave the same in both runs.
+// Global variables are compared as JSON, so variables that reference native objects are
+// not compared.
+//
+// Built for the simulator platform when EEZ_FRAMEWORK_BUILD_TOOLS is ON, see CMakeLists.txt.
+//
+// Usage: snapshot_check <assets file> [<warmup ms> = 1000] [<run ms> = 1000]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+
+#include <eez/core/os.h>
+#include <eez/core/assets.h>
+
+#include <eez/flow/flow.h>
+#include <eez/flow/snapshot.h>
+#include <eez/flow/json.h>
+#include <eez/flow/hooks.h>
+
+using namespace eez;
+using namespace std::chrono;
+
+static const uint32_t TICK_PERIOD_MS = 10;
+
+// Date.now() at the virtual time 0: 2024-01-01T00:00:00Z
+static const double DATE_NOW_START = 1704067200000.0;
+
+static uint32_t g_time;
+
+static void setTime(uint32_t time) {
+    g_time = time;
+    setManualMillis(true, g_time);
+}
+
+static double getDateNow() {
+    return DATE_NOW_START + g_time;
+}
+
+static void run(uint32_t ms) {
+    for (uint32_t elapsed = 0; elapsed < ms && !flow::isFlowStopped(); elapsed += TICK_PERIOD_MS) {
+        setTime(g_time + TICK_PERIOD_MS);
+        flow::tick();
+    }
+}
+
+static uint32_t getNumGlobalVariables() {
+    return static_cast<FlowDefinition *>(g_mainAssets->flowDefinition)->globalVariables.count;
+}
+
+static Value *getGlobalVariablesJson() {
+    auto numGlobalVariables = getNumGlobalVariables();
+    auto values = new Value[numGlobalVariables > 0 ? numGlobalVariables : 1];
+    for (uint32_t i = 0; i < numGlobalVariables; i++) {
+        values[i] = flow::json::stringify(flow::getGlobalVariable(i), 0x5b1e7c24);
+    }
+    return values;
+}
+
+static void stopFlow() {
+    flow::stop();
+    flow::tick();
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <assets file> [<warmup ms>] [<run ms>]\n", argv[0]);
+        return 2;
+    }
+
+    uint32_t warmupMs = argc > 2 ? (uint32_t)atoi(argv[2]) : 1000;
+    uint32_t runMs = argc > 3 ? (uint32_t)atoi(argv[3]) : 1000;
+
+    if (!loadMainAssetsFromFile(argv[1])) {
+        fprintf(stderr, "Failed to load assets: %s\n", argv[1]);
+        return 2;
+    }
+
+    flow::getDateNowHook = getDateNow;
+    setTime(0);
+
+    // cold start
+    auto t = steady_clock::now();
+    flow::start(g_mainAssets);
+    flow::tick();
+    auto coldStartTime = duration_cast<microseconds>(steady_clock::now() - t).count();
+
+    run(warmupMs);
+
+    uint32_t snapshotSize = 0;
+    flow::takeSnapshot(nullptr, 0, snapshotSize);
+    auto snapshot = snapshotSize > 0 ? (uint8_t *)::malloc(snapshotSize) : nullptr;
+    if (!snapshot || !flow::takeSnapshot(snapshot, snapshotSize, snapshotSize)) {
+        fprintf(stderr, "Snapshot can't be taken\n");
+        ::free(snapshot);
+        stopFlow();
+        return 2;
+    }
+    auto snapshotTime = g_time;
+
+    // same as the first tick after restoreSnapshot()
+    flow::tick();
+
+    run(runMs);
+    auto expected = getGlobalVariablesJson();
+    stopFlow();
+
+    // restore, at the time the snapshot was taken
+    setTime(snapshotTime);
+    t = steady_clock::now();
+    if (!flow::restoreSnapshot(g_mainAssets, snapshot, snapshotSize)) {
+        fprintf(stderr, "Snapshot can't be restored\n");
+        delete [] expected;
+        ::free(snapshot);
+        return 2;
+    }
+    flow::tick();
+    auto restoreTime = duration_cast<microseconds>(steady_clock::now() - t).count();
+
+    run(runMs);
+    auto actual = getGlobalVariablesJson();
+    stopFlow();
+
+    uint32_t numDifferences = 0;
+    for (uint32_t i = 0; i < getNumGlobalVariables(); i++) {
+        auto expectedJson = expected[i].isString() ? expected[i].getString() : "<not comparable>";
+        auto actualJson = actual[i].isString() ? actual[i].getString() : "<not comparable>";
+        if (strcmp(expectedJson, actualJson) != 0) {
+            printf("global variable %u differs:\n  expected: %s\n  actual:   %s\n", (unsigned)i, expectedJson, actualJson);
+            numDifferences++;
+        }
+    }
+
+    printf("snapshot size:            %u bytes\n", (unsigned)snapshotSize);
+    printf("cold start + first tick:  %lld us\n", (long long)coldStartTime);
+    printf("restore + first tick:     %lld us\n", (long long)restoreTime);
+    printf("global variables:         %u compared, %u differ\n", (unsigned)getNumGlobalVariables(), (unsigned)numDifferences);
+
+    delete [] expected;
+    delete [] actual;
+    ::free(snapshot);
+
+    return numDifferences == 0 ? 0 : 1;
+}